@@ -0,0 +1,84 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QSharedPointer>
+#include "DataProcessor.h"
+
+class PlotWidget;
+class QThreadPool;
+
+// One entry of a --batch manifest, plus what happened to it
+struct BatchJob {
+    QString name;
+    QString cropDir;                   // crop folder; relative file names resolve against it
+    QStringList files;
+    QString xVar = "DATE";
+    QStringList yVars;
+    QStringList treatments;            // empty = all
+    QString plotType = "timeseries";   // "timeseries", "boxplot" or "scatter"
+    QString outputPath;                // plot image/PDF, optional
+    QString metricsPath;               // metrics CSV, optional
+    int width = 1200;                  // logical pixels
+    int height = 800;
+    int dpi = 300;
+
+    // Results. Load/plot fields are written on the GUI thread. Image/metrics fields are
+    // written by the worker task that encodes them (or on the GUI thread when no task is
+    // started) and are only read after the pool has been waited on.
+    int fileSet = -1;
+    bool sharedLoad = false;           // file set already loaded for an earlier job
+    bool plotOk = false;
+    bool imageOk = true;
+    bool metricsOk = true;
+    QString error;
+    qint64 loadMs = 0;
+    qint64 plotMs = 0;
+    qint64 imageMs = 0;
+    qint64 metricsMs = 0;
+};
+
+// Runs a JSON manifest of plot/metrics jobs in one process:
+//   { "threads": 4, "summary": "summary.json",
+//     "jobs": [ { "name": "...", "cropDir": "C:/DSSAT48/Maize", "files": ["PlantGro.OUT"],
+//                 "xvar": "DATE", "yvars": ["LAID"], "treatments": ["1", "2"],
+//                 "plotType": "timeseries", "output": "laid.png", "metrics": "laid.csv" } ] }
+// Jobs naming the same files share one parse. Files are parsed on a worker pool; charts
+// are built and laid out on the GUI thread while the pool encodes images and writes
+// metrics for earlier jobs.
+class BatchRunner
+{
+public:
+    BatchRunner();
+    ~BatchRunner();
+
+    // Runs every job and prints the per-job summary. Returns false if the manifest cannot
+    // be read or any job failed.
+    bool run(const QString &manifestPath);
+
+private:
+    bool loadManifest(const QString &manifestPath, QString *error);
+    void loadFileSets();
+    void runJob(BatchJob &job, QThreadPool &pool);
+    void printSummary(qint64 totalMs) const;
+    bool writeSummary(const QString &path, qint64 totalMs) const;
+    PlotWidget *plotWidgetFor(const BatchJob &job);
+
+    struct FileSet {
+        QString folderName;
+        QVector<QPair<QString, QString>> files;  // (file name, absolute path)
+        OutputFileSet data;
+        qint64 loadMs = 0;
+    };
+
+    QVector<BatchJob> m_jobs;
+    QVector<QSharedPointer<FileSet>> m_fileSets;
+    int m_threads = 0;                 // 0 = ideal thread count
+    QString m_summaryPath;
+    PlotWidget *m_timeSeriesPlot = nullptr;
+    PlotWidget *m_scatterPlot = nullptr;
+};
+
+#endif // BATCHRUNNER_H
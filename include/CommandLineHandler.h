@@ -7,6 +7,7 @@
 #include <QTimer>
 
 class MainWindow;
+class PlotWidget;
 
 struct CommandLineArgs {
     QString dssatBase;
@@ -28,6 +29,13 @@ struct CommandLineArgs {
     QStringList scatterMetrics;      // --scatter-metrics "RMSE,R2,d-stat"
 
     bool boxPlotMode = false;        // --boxplot
+
+    // Batch mode: run every job of a JSON manifest in one process (see BatchRunner)
+    QString batchManifest;           // --batch jobs.json
+
+    // Server mode: answer table/metrics/plot requests on a local socket (see RequestServer)
+    bool serveMode = false;          // --serve [name]
+    QString serveName;
 };
 
 class CommandLineHandler : public QObject
@@ -50,7 +58,15 @@ private slots:
 private:
     MainWindow *m_mainWindow;
     CommandLineArgs m_args;
-    
+
+    // Headless pipeline: each stage starts when the previous one reports completion
+    // (files loaded -> plot built -> plot exported / metrics written -> exit)
+    bool m_headlessPlotReady = false;
+    bool m_headlessFailed = false;
+    void watchHeadlessPlot(PlotWidget *plot);
+    void writeHeadlessOutputs(PlotWidget *plot, bool writeMetrics);
+    void finishHeadless();
+
     bool selectCropFolder(const QString &cropName);
     static QString extractCropNameFromPath(const QString &cropDirPath);
 };
@@ -6,10 +6,48 @@
 #include <QVariant>
 #include <QDateTime>
 #include <QMap>
+#include <QHash>
+#include <QSet>
 #include <QVector>
 #include <QObject>
 #include <memory>
 
+// Summary statistics over the numeric, non-missing values of a column (or of one group
+// of rows). Mergeable, so sim + obs or several groups can be combined without rescanning.
+struct ColumnStats {
+    static const int QUANTILE_SKETCH_SIZE = 101; // P0, P1, ... P100
+
+    int count = 0;              // numeric, non-missing values
+    int missingCount = 0;       // missing (-99 ...) or non-numeric cells
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0;            // sum of squared deviations from the mean (Welford)
+    double sumAbsNonZero = 0.0; // sum of |x| over |x| > 1e-10, for magnitude()
+    int nonZeroCount = 0;
+    QVector<double> quantiles;  // optional sketch, empty unless requested
+
+    bool isEmpty() const { return count == 0; }
+    double variance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+    double magnitude() const;            // floor(log10(mean |x|)) over non-zero values, NaN if none
+    double quantile(double p) const;     // interpolated from the sketch, NaN without one
+    void add(double value);
+    void merge(const ColumnStats &other); // drops the quantile sketch (not mergeable)
+};
+
+// Approximate heap held by loaded data: the QVariant cell arrays (buffers), the QString
+// payloads referenced from cells and names (strings) and the lazily built stats (caches).
+// Pass the same `seen` set to every call to count implicitly shared buffers once.
+struct MemoryUsage {
+    qint64 buffers = 0;
+    qint64 strings = 0;
+    qint64 caches = 0;
+
+    qint64 total() const { return buffers + strings + caches; }
+    MemoryUsage &operator+=(const MemoryUsage &other);
+    static QString format(qint64 bytes);   // "512 KB", "3.4 MB", "1.2 GB"
+};
+
 struct DataColumn {
     QString name;
     QVector<QVariant> data;
@@ -17,6 +55,39 @@ struct DataColumn {
     
     DataColumn() = default;
     DataColumn(const QString &columnName) : name(columnName) {}
+
+    // Lazily computed and cached against the data buffer; recomputed after invalidateStats()
+    // or when data is reassigned or resized. Code that writes column.data in place must call
+    // invalidateStats() afterwards. Not synchronised: only call from the owning thread.
+    const ColumnStats &stats(bool withQuantiles = false) const;
+    // Per-group stats keyed by the group column's string value (e.g. TRT, EXPERIMENT);
+    // rows whose group cell is an empty QVariant are left out
+    const QHash<QString, ColumnStats> &groupStats(const DataColumn &groupColumn,
+                                                  bool withQuantiles = false) const;
+    void invalidateStats();
+    // Drops the stats caches only; data is unchanged
+    void releaseCaches();
+    // Cell buffer and string sizes are cached against the buffer, so repeated calls
+    // on unchanged (or implicitly shared) data do not rescan the cells
+    MemoryUsage memoryUsage(QSet<const void *> *seen = nullptr) const;
+
+private:
+    mutable ColumnStats m_stats;
+    mutable const void *m_statsBuffer = nullptr;  // data.constData() when m_stats was computed
+    mutable int m_statsRows = -1;            // data.size() when m_stats was computed; -1 = stale
+    mutable bool m_statsHasQuantiles = false;
+    struct GroupStatsEntry {
+        const void *buffer = nullptr;        // data / groupColumn.data buffers the entry was built from
+        const void *groupBuffer = nullptr;
+        int rows = -1;
+        int groupRows = -1;
+        bool hasQuantiles = false;
+        QHash<QString, ColumnStats> stats;
+    };
+    mutable QHash<QString, GroupStatsEntry> m_groupStats; // keyed by group column name
+    mutable const void *m_usageBuffer = nullptr;  // data.constData() when m_usage was measured
+    mutable int m_usageRows = -1;
+    mutable MemoryUsage m_usage;                  // buffers and strings of data only
 };
 
 struct DataTable {
@@ -35,6 +106,11 @@ struct DataTable {
     void clear();
     int getColumnIndex(const QString &name) const;
     void merge(const DataTable &other);
+    MemoryUsage memoryUsage(QSet<const void *> *seen = nullptr) const;
+    // Drops every column's stats cache (rebuilt on the next stats() call)
+    void releaseCaches();
+    // Trims column buffers left over-allocated by merge()/addRow()
+    void squeeze();
 };
 
 struct CropDetails {
@@ -43,6 +119,34 @@ struct CropDetails {
     QString directory;
 };
 
+// Observed values of one variable paired with the simulated value at the same
+// TRT/EXPERIMENT/CROP/DATE (see DataProcessor::matchObsSim). One group per
+// treatment + experiment + crop, split by RUN when the simulated table has one.
+struct ObsSimGroup {
+    QString treatment;         // simulated TRT (sequences observe TRT 1 for every run)
+    QString experiment;
+    QString crop;
+    QString runId;             // "RUN<n>", empty without a RUN column
+    bool multiRun = false;     // the treatment/experiment/crop has more than one run
+    QVector<double> x;         // observation date (ms since epoch) or DAS/DAP
+    QVector<double> obs;
+    QVector<double> sim;
+};
+
+// A set of selected output files loaded together (see DataProcessor::loadOutputFiles)
+struct OutputFileSet {
+    DataTable simData;         // regular .OUT rows, stamped with __SRCFILE__
+    DataTable obsData;         // observed data for the experiments found in simData
+    DataTable evaluateData;    // EVALUATE.OUT / evaluate.csv rows
+    QSet<QString> experimentCodes;
+    QMap<QString, QMap<QString, QString>> treatmentNames; // experiment -> TRT -> TNAME
+    QMap<QString, QStringList> fileColumns;               // file name -> column names
+    QStringList loadedPaths;   // absolute paths actually read
+    QStringList refusedPaths;  // skipped because they would exceed the memory budget
+    bool hasRegularFile = false;
+    bool hasEvaluateFile = false;
+};
+
 
 
 class DataProcessor : public QObject
@@ -59,6 +163,10 @@ public:
     bool readTFile(const QString &filePath, DataTable &table);
     bool readEvaluateFile(const QString &filePath, DataTable &table);  // Read EVALUATE.OUT file
     bool readCsvFile(const QString &filePath, DataTable &table);      // Read CSV output file
+    // Read and merge the given (file name, absolute path) pairs of one crop folder, then
+    // attach the matching observed data. Used by the file list and by batch mode.
+    void loadOutputFiles(const QString &folderName, const QVector<QPair<QString, QString>> &files,
+                         OutputFileSet &out);
     static QMap<QString, QString> readTreatmentNamesFromXFile(const QString &xFilePath); // Read trt names from .XXX experiment file
 
     QStringList prepareFolders(bool includeExtraFolders);
@@ -76,7 +184,17 @@ public:
     bool handleMissingValues(DataTable &table, const QString &xVariable);
     void convertDates(DataTable &table);
     void setDSSATBasePath(const QString &path);
+    // Files whose estimated in-memory size would take a loadOutputFiles() set past this
+    // many bytes are refused with errorOccurred() instead of read (0 = no limit)
+    void setMemoryBudget(qint64 bytes) { m_memoryBudget = bytes; }
+    qint64 memoryBudget() const { return m_memoryBudget; }
+    // Bytes already held elsewhere (plot snapshots, ...) that count against the budget
+    void setResidentBytes(qint64 bytes) { m_residentBytes = bytes; }
+    static qint64 estimatedLoadBytes(const QString &filePath);
     static DataTable filterData(const DataTable &data, const QString &columnName, const QString &filterValue);
+    // Obs↔sim pairs of one variable, grouped as in the time-series metrics table
+    static QVector<ObsSimGroup> matchObsSim(const DataTable &simData, const DataTable &obsData,
+                                            const QString &variable);
 
 signals:
     void dataProcessed(const QString &message);
@@ -86,6 +204,7 @@ signals:
 public: // Static utility functions
     static QMap<QString, QPair<QString, QString>> m_variableInfoCache;
     static bool m_variableInfoLoaded;
+    // Written under a lock in DataProcessor.cpp; access them through the functions
     static QString m_dssatBasePath;
     static QVector<CropDetails> m_cropDetailsCache;
     static bool m_cropDetailsCached;
@@ -124,6 +243,8 @@ private: // Private helper functions (non-static)
     
 
 private:
+    qint64 m_memoryBudget = 0;
+    qint64 m_residentBytes = 0;
 };
 
 #endif // DATAPROCESSOR_H
\ No newline at end of file
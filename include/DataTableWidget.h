@@ -27,6 +27,8 @@ public:
     void setData(const DataTable& simData = DataTable(), const DataTable& obsData = DataTable());
     void setTabsVisible(bool visible);
     void clear();
+    // Heap held by the shown tables, their filtered copies and the models' sorted copies
+    MemoryUsage memoryUsage(QSet<const void *> *seen = nullptr) const;
 
 private slots:
     void exportData();
@@ -39,12 +41,14 @@ private:
     void setupUI();
     DataTable removeEmptyColumns(const DataTable& data);
     void updateFilterColumns();
+    void updateMemoryLabel();
     
     // UI Components
     QVBoxLayout* m_mainLayout;
     QHBoxLayout* m_controlsLayout;
     
     QPushButton* m_exportButton;
+    QLabel* m_memoryLabel;
     
     // Filter controls
     QGroupBox* m_filterGroup;
@@ -64,7 +64,7 @@ public:
     QListWidget* getYVariableSelector() const { return m_yVariableComboBox; }
     QTabWidget* getTabWidget() const { return m_tabWidget; }
     PlotWidget* getPlotWidget() const { return m_plotWidget; }
-    PlotWidget* getScatterPlotWidget() const { return m_scatterPlotWidget; }
+    PlotWidget* getScatterPlotWidget() { return ensureScatterPlotWidget(); }
     DataTable getEvaluateData() const { return m_evaluateData; }
 
 protected:
@@ -125,6 +125,8 @@ private:
     void resetInterface();
     void centerWindow();
     void populateFolders();
+    void populateFoldersAsync();
+    void fillFolderCombo(const QStringList &folders);
     void populateFiles(const QString &folderName);
     
     // Additional methods from Python version
@@ -136,7 +138,18 @@ private:
     void showSuccess(const QString &message);
     void showWarning(const QString &message);
     void updateStatisticsTab();
+    // Tab contents are built on first use
+    PlotWidget *ensureScatterPlotWidget();
+    DataTableWidget *ensureDataTableWidget();
+    void ensureStatisticsTab();
     void markDataNeedsRefresh();
+    // Memory budget (Plot Settings) in bytes, 0 = no limit
+    qint64 memoryBudgetBytes() const;
+    // Loaded tables, plots, their caches and the Data View, shared buffers counted once
+    MemoryUsage measureMemoryUsage() const;
+    // Accounts loaded tables and caches, evicts what can be rebuilt when over the
+    // budget and updates the status readout
+    void updateMemoryUsage();
     void filterOutFiles(const QString &text);
     void filterYVars(const QString &text);
     void unselectAllOutFiles();
@@ -178,14 +191,17 @@ private:
     
     // Data Panel - matching Python's tab structure
     DataTableWidget *m_dataTableWidget;
+    QVBoxLayout *m_dataTabLayout = nullptr;   // Data View tab; the table is added on first show
     QLabel *m_dataInfoLabel;
     QComboBox *m_dataViewFileTypeComboBox;  // Selector for which file type to show in Data View tab
     
     // Plot Panel (now integrated into tabs like Python)
     PlotWidget *m_plotWidget;               // Main plotting widget for time series (like Python PyQtGraph)
-    PlotWidget *m_scatterPlotWidget;       // Plotting widget for scatter plots
+    PlotWidget *m_scatterPlotWidget;       // Plotting widget for scatter plots (created on first use)
+    QVBoxLayout *m_scatterTabLayout = nullptr;
 
-    // Statistics Tab widgets
+    // Statistics Tab widgets (created on first activation)
+    QWidget *m_statsTab = nullptr;
     MetricsTableWidget *m_statsTSWidget;
     MetricsTableWidget *m_statsScatterWidget;
     QLabel *m_statsTSHeader;
@@ -204,6 +220,7 @@ private:
     QString m_currentFilePath;
     QStringList m_availableFiles;
     QString m_selectedFolder;
+    bool m_discoveringFolders = false;       // background crop folder scan in flight
 
     // Detect when loaded output files are overwritten on disk (e.g. DSSAT re-runs
     // and rewrites PlantGro.OUT). Watch the loaded paths and prompt the user to
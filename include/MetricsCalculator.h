@@ -4,10 +4,16 @@
 #include <QVector>
 #include <QVariant>
 #include <QVariantMap>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
 #include <QString>
 #include <cmath>
 #include <limits>
 
+class QTextStream;
+struct DataTable;
+
 class MetricsCalculator
 {
 public:
@@ -25,10 +31,77 @@ public:
                                  double& mseSystematic,
                                  double& mseUnsystematic);
     
-    // Main metrics calculation function
+    // Main metrics calculation function; bootstrapResamples = 0 leaves out the CIs
     static QVariantMap calculateMetrics(const QVector<double>& simValues, 
                                        const QVector<double>& obsValues, 
-                                       int treatmentNumber);
+                                       int treatmentNumber,
+                                       int bootstrapResamples = DEFAULT_BOOTSTRAP_RESAMPLES);
+
+    // Fused single-kernel RMSE / d-stat / R² over pre-filtered obs/sim arrays.
+    // indices selects the rows to use (with repetition, e.g. a bootstrap resample);
+    // pass nullptr to use rows 0..n-1.
+    struct FusedMetrics {
+        int n = 0;
+        double rmse = 0.0;
+        double dStat = 0.0;
+        double rSquared = 0.0;
+    };
+    static FusedMetrics fusedMetrics(const double* observed, const double* simulated,
+                                     const int* indices, int n);
+
+    // Percentile bootstrap confidence intervals for RMSE, d-stat and R².
+    // Resamples are split into fixed-size blocks, each with its own RNG stream derived
+    // from seed, and blocks are spread over the global thread pool — results do not
+    // depend on the number of cores. Since they are deterministic, results are cached
+    // by (pairs, resamples, confidence, seed) and replots of unchanged data reuse them.
+    // Fewer than 2 resamples returns an invalid CI without resampling.
+    struct BootstrapCI {
+        bool valid = false;
+        int resamples = 0;
+        double confidence = 0.0;
+        double rmseLow = 0.0, rmseHigh = 0.0;
+        double dStatLow = 0.0, dStatHigh = 0.0;
+        double rSquaredLow = 0.0, rSquaredHigh = 0.0;
+    };
+    static constexpr int DEFAULT_BOOTSTRAP_RESAMPLES = 2000;
+    static constexpr double DEFAULT_BOOTSTRAP_CONFIDENCE = 0.95;
+    static constexpr quint64 DEFAULT_BOOTSTRAP_SEED = 0x47423242554F5453ULL;
+    static BootstrapCI bootstrapCI(const QVector<double>& observed,
+                                   const QVector<double>& simulated,
+                                   int resamples = DEFAULT_BOOTSTRAP_RESAMPLES,
+                                   double confidence = DEFAULT_BOOTSTRAP_CONFIDENCE,
+                                   quint64 seed = DEFAULT_BOOTSTRAP_SEED);
+    // Drop the cached intervals (benchmarks that time cold runs)
+    static void clearBootstrapCache();
+    // Store ci into result under the RMSE_CI_* / DStat_CI_* / R2_CI_* keys (prefixed by keyPrefix)
+    static void storeBootstrapCI(QVariantMap& result, const BootstrapCI& ci,
+                                 const QString& keyPrefix = QString());
+
+    // Time-series metric rows: order by Treatment (numerically when possible), Variable,
+    // Experiment and Crop, and attach each variable's pooled d-stat and bootstrap CIs
+    // (pooledObs/pooledSim: variable -> all pairs across treatments)
+    static void sortMetricRows(QVector<QVariantMap>& metrics);
+    static void addPooledMetrics(QVector<QVariantMap>& metrics,
+                                 const QMap<QString, QVector<double>>& pooledObs,
+                                 const QMap<QString, QVector<double>>& pooledSim,
+                                 int bootstrapResamples = DEFAULT_BOOTSTRAP_RESAMPLES);
+
+    // Time-series metric rows for every obs/sim group of the given variables (see
+    // DataProcessor::matchObsSim), with treatment, variable and crop display names.
+    // treatments holds "TRT" or "EXP::TRT" entries; empty = all. Sorted, with pooled
+    // stats. Used where no PlotWidget is involved (gb2-metrics, the request server).
+    static QVector<QVariantMap> obsSimMetrics(const DataTable& simData, const DataTable& obsData,
+                                              const QMap<QString, QMap<QString, QString>>& treatmentNames,
+                                              const QStringList& variables,
+                                              const QSet<QString>& treatments = QSet<QString>(),
+                                              int bootstrapResamples = DEFAULT_BOOTSTRAP_RESAMPLES);
+    // Columns of simData that obsData also has, minus key and date columns
+    static QStringList commonVariables(const DataTable& simData, const DataTable& obsData);
+
+    // Write metric rows (as produced by PlotWidget::calculateMetrics) as the UTF-8 CSV
+    // used by --metrics and batch mode
+    static bool writeMetricsCsv(const QString& filePath, const QVariantList& metrics);
+    static void writeMetricsCsv(QTextStream& out, const QVariantList& metrics);
 
 private:
     // Helper functions
@@ -0,0 +1,29 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <QtGlobal>
+#include <functional>
+#include <limits>
+
+// Data-parallel loops on QThreadPool::globalInstance(). The calling thread takes work
+// too, so a busy pool only means less help, never a wait for a helper to start, and
+// calls from inside a pool task cannot deadlock.
+//
+//   const int threads = Parallel::threadCount(values.size(), PARALLEL_MIN_VALUES);
+//   Parallel::forEach(nGroups, threads, [&](int group) { ... });
+namespace Parallel {
+
+// Threads worth using for `work` items: 1 below parallelMin, otherwise the global
+// pool's thread count, capped at maxThreads
+int threadCount(qint64 work, qint64 parallelMin, int maxThreads = std::numeric_limits<int>::max());
+
+// Calls fn(i) for every i in [0, count) on up to `threads` threads, claiming items one
+// at a time; returns once all have run
+void forEach(int count, int threads, const std::function<void(int index)> &fn);
+
+// Calls fn(begin, end, chunk) for `chunks` contiguous ranges covering [0, n)
+void forChunks(int n, int chunks, const std::function<void(int begin, int end, int chunk)> &fn);
+
+} // namespace Parallel
+
+#endif // PARALLEL_H
@@ -0,0 +1,69 @@
+#ifndef PLOTRENDERER_H
+#define PLOTRENDERER_H
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <QVector>
+#include "PlotWidget.h"
+
+// Axis state captured from the live chart (or set by hand for a headless render)
+struct PlotRenderAxis {
+    bool isDate = false;          // x values are ms since epoch
+    double min = 0.0;
+    double max = 1.0;
+    int tickCount = 0;            // 0 = Qt default
+    int minorTickCount = 0;
+    QString labelFormat;          // printf format (value axis) or date format (date axis)
+    QString title;
+};
+
+// Everything an export needs. Built by PlotWidget::renderModel() on the GUI thread;
+// holds copies only, so it outlives the widget and its series.
+struct PlotRenderModel {
+    QVector<PlotData> plotData;   // draw order; PlotData::series is not used
+    PlotSettings settings;
+    PlotRenderAxis xAxis;
+    PlotRenderAxis yAxis;
+    QString title;
+    bool showLegend = true;
+};
+
+// Offscreen renderer: lays the model out in a private QGraphicsScene at the target
+// size and paints it straight into a QImage or QPdfWriter. Nothing is shown and no
+// events are processed, so the same model always yields the same output, whatever
+// the state of the on-screen widgets.
+class PlotRenderer
+{
+public:
+    explicit PlotRenderer(const PlotRenderModel &model);
+
+    // size is in logical pixels (96 per inch); dpi scales the raster
+    QImage renderImage(const QSize &size, int dpi) const;
+    bool renderPdf(const QString &filePath, const QSize &size) const;
+    // Format from the extension (.pdf → vector) or the given raster format
+    bool save(const QString &filePath, const QString &format, const QSize &size, int dpi) const;
+    // Encodes a rendered image (JPEG at quality 95). Thread-safe, so encoding can be
+    // handed to a worker while the next chart is laid out.
+    static bool saveImage(const QImage &image, const QString &filePath, const QString &format);
+
+private:
+    struct LegendRow {
+        QString label;
+        bool hasLine = false;
+        QPen linePen;
+        bool hasMarker = false;
+        QPen markerPen;
+        QBrush markerBrush;
+        QString symbol;
+    };
+    QVector<LegendRow> legendRows() const;
+    void paint(QPainter *painter, const QSizeF &size) const;
+    void paintErrorBars(QPainter *painter, QChart *chart) const;
+    void paintLegend(QPainter *painter, const QVector<LegendRow> &rows, const QRectF &box) const;
+    QSizeF legendSize(const QVector<LegendRow> &rows) const;
+
+    PlotRenderModel m_model;
+};
+
+#endif // PLOTRENDERER_H
@@ -96,15 +96,36 @@ struct PlotSettings {
     // Scatter panel overlay metrics (subset of available stats to display)
     QSet<QString> scatterMetrics = {"RMSE", "R²"};
 
+    // Scatter panels with more points than this draw binned density instead of one
+    // marker per point (0 = never)
+    int scatterDensityThreshold = 20000;
+    QString scatterDensityShape = "hex";  // "hex" or "square"
+    int scatterDensityBins = 40;          // bins across each axis
+
     // Time series panel overlay metrics (shown in multi-panel mode, per variable)
     QSet<QString> tsMetrics = {"RMSE", "d-stat"};
 
+    // Bootstrap resamples behind the RMSE / d-stat / R² confidence intervals of the
+    // metrics (0 = no intervals)
+    int bootstrapResamples = 2000;
+
     // Interaction settings
     bool showHoverTooltip = true;
 
     // Layout settings
     bool multiPanelTimeSeries = false;  // tile Y variables in a grid instead of overlaying
+
+    // Rendering: above either budget simulated lines are drawn into one raster layer
+    // instead of one chart item per series (0 = never)
+    int rasterSeriesBudget = 150;
+    int rasterPointBudgetK = 2000;      // thousands of simulated points
+    // Above this many RUNs per treatment, simulated runs are summarised as percentile
+    // bands plus a median line (0 = never)
+    int ensembleRunThreshold = 50;
     bool rememberLastCropFolder = false; // restore last selected crop folder on startup
+    // Loaded tables plus caches; above it caches are dropped and further outfiles are
+    // refused (0 = no limit)
+    int memoryBudgetMB = 4096;
 
     // Treatment filter (empty excludedSeriesKeys = show all)
     QSet<QString> excludedSeriesKeys;  // format: "varName::expId::trtId"
@@ -218,13 +239,21 @@ private:
 
     // Layout controls
     QCheckBox *m_multiPanelTSCheckBox;
+    QSpinBox *m_rasterSeriesBudgetSpinBox;
+    QSpinBox *m_rasterPointBudgetSpinBox;
+    QSpinBox *m_ensembleRunThresholdSpinBox;
     QCheckBox *m_rememberLastCropFolderCheckBox;
+    QSpinBox *m_memoryBudgetSpinBox;
 
     // Scatter metrics checkboxes
     QMap<QString, QCheckBox*> m_scatterMetricCheckBoxes;
+    QSpinBox *m_scatterDensityThresholdSpinBox;
+    QComboBox *m_scatterDensityShapeComboBox;
+    QSpinBox *m_scatterDensityBinsSpinBox;
 
     // Time series panel metrics checkboxes
     QMap<QString, QCheckBox*> m_tsMetricCheckBoxes;
+    QSpinBox *m_bootstrapResamplesSpinBox;
 
     // Buttons
     QPushButton *m_resetButton;
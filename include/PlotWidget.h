@@ -8,6 +8,7 @@
 #include <QtCharts/QChartView>
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QScatterSeries>
+#include <QtCharts/QAreaSeries>
 #include <QtCharts/QValueAxis>
 #include <QtCharts/QDateTimeAxis>
 #include <QtCharts/QLegend>
@@ -29,10 +30,13 @@
 #include <QTreeWidgetItem>
 #include <QStackedWidget>
 #include <QMap>
+#include <QHash>
+#include <QSet>
 #include <QPoint>
 #include <QVector>
 #include <QSharedPointer>
 #include <QPointer>
+#include <QImage>
 #include <QtCharts/QAbstractSeries>
 #include <QSlider>
 #include <QTimer>
@@ -69,6 +73,11 @@ struct PlotData {
     // Populated for observed series only; used by animation metrics to avoid re-matching.
     struct MatchedPair { double x; double obs; double sim; };
     QVector<MatchedPair> matchedPairs;
+    // Ensemble summary of many RUNs (see ensemblePlotData): empty for ordinary series,
+    // otherwise "P5-P95" / "P25-P75" for a band (points = upper edge, lowerPoints = lower
+    // edge) or "Mean" / "P50" for a line
+    QString ensembleRole;
+    QVector<QPointF> lowerPoints;
 };
 
 class ErrorBarChartView : public QChartView
@@ -77,6 +86,8 @@ class ErrorBarChartView : public QChartView
 public:
     explicit ErrorBarChartView(QChart *chart, QWidget *parent = nullptr);
     void setErrorBarData(const QMap<QAbstractSeries*, QVector<ErrorBarData>> &errorBars);
+    // Animation: draw only the first count (x-sorted) bars of a series; -1 = all
+    void setErrorBarPrefix(QAbstractSeries *series, int count);
     /** Draw error bars onto the given painter. Use viewportOffset when painting on full chart-view-sized pixmap (e.g. export). */
     void paintErrorBars(QPainter *painter, const QPoint &viewportOffset = QPoint(0, 0));
 
@@ -108,6 +119,7 @@ public:
         QColor color;          // fill color (distinct per variable)
         int varIndex = 0;      // which variable this box belongs to (for side-by-side offset)
         int varCount = 1;      // total number of variables being plotted
+        int n = 0;             // number of values summarised (0 = empty group)
     };
     void setBoxPlotData(const QVector<BoxPlotStats> &stats, double yMin, double yMax);
     void setBoxPlotYBounds(double yMin, double yMax);
@@ -119,6 +131,37 @@ public:
     void setBoxPlotMedians(const QVector<QPointF> &, int, double, double) {}
     void setBoxPlotWhiskers(const QVector<QPointF> &, const QVector<QPointF> &) {}
 
+    // Raster layer for very dense plots: the listed line series keep no points of their
+    // own (legend, hover and highlight still go through them) and are drawn together
+    // into one cached image, re-rendered only when data, axes, pens or visibility change.
+    // The image is painted by an item in the chart's scene stacked beneath the series,
+    // so observed markers and error bars stay on top of it (and render() includes it).
+    struct RasterLine {
+        QPointer<QAbstractSeries> series;
+        QVector<QPointF> points;
+    };
+    void setRasterLines(const QVector<RasterLine> &lines);
+    void setRasterLinePoints(QAbstractSeries *series, const QVector<QPointF> &points);
+    void clearRasterLines();
+    bool hasRasterLines() const { return !m_rasterLines.isEmpty(); }
+    void invalidateRasterLayer();
+    void paintRasterLayer(QPainter *painter, const QPoint &viewportOffset = QPoint(0, 0));
+
+    // Density layer for very dense scatter panels: point counts per hexagonal or square
+    // bin, colour-mapped on a log scale. Bins are in data units and mapped through the
+    // axes of mappingSeries at paint time, so zoom and resize need no rebinning.
+    struct DensityBins {
+        bool hexagonal = true;
+        double binWidth = 0.0;    // hex: centre spacing along x; square: side
+        double binHeight = 0.0;   // hex: spacing of same-lattice rows along y; square: side
+        QVector<QPointF> centres;
+        QVector<int> counts;
+        int maxCount = 0;
+    };
+    void setDensityBins(const DensityBins &bins, QAbstractSeries *mappingSeries);
+    void clearDensityBins();
+    void paintDensityLayer(QPainter *painter, const QPoint &viewportOffset = QPoint(0, 0));
+
 protected:
     void paintEvent(QPaintEvent *event) override;
 
@@ -130,9 +173,21 @@ private:
     void paintAxisBreaks(QPainter *painter);
 
     QMap<QAbstractSeries*, QVector<ErrorBarData>> m_errorBars;
+    QHash<QAbstractSeries*, int> m_errorBarPrefix;
     int m_errorBarCapWidth = 5;
     int m_errorBarLineWidth = 2;
     QVector<BoxPlotStats> m_boxStats;
+    QVector<RasterLine> m_rasterLines;
+    QGraphicsItem *m_rasterItem = nullptr;  // child of m_rasterItemChart, owned by it
+    QPointer<QChart> m_rasterItemChart;
+    QImage m_rasterImage;               // viewport-sized, device-pixel-ratio aware
+    QString m_rasterSignature;          // plot area + axis mapping the image was drawn for
+    bool m_rasterDirty = true;
+    static constexpr size_t RASTER_PARALLEL_MIN_LINES = 64;
+    QString rasterSignature() const;
+    void renderRasterLayer();
+    DensityBins m_densityBins;
+    QPointer<QAbstractSeries> m_densitySeries;
     double m_bpYMin  = 0.0;
     double m_bpYMax  = 0.0;
     QFont  m_catLabelFont = QFont("Arial", 9);
@@ -174,6 +229,7 @@ private:
 };
 
 class PlotWidget;
+struct PlotRenderModel;
 
 // Simple legend - no complex row widgets needed
 
@@ -214,6 +270,9 @@ public:
         const DataTable &evaluateData,
         const QStringList &varNames
     );
+    // Base names of the first S/M column pairs of an EVALUATE table, for scatter runs
+    // that name no variables (headless and batch)
+    static QStringList defaultScatterVariables(const DataTable &evaluateData, int maxCount = 4);
     
     QChart *chart() const { return m_chart; }
     void setData(const DataTable &data);
@@ -228,10 +287,22 @@ public:
                    const QString &treatment = QString(), const QString &plotType = "Line");
     void clear();
     void clearChart();  // Clear chart without clearing data
+    // Heap held by the plotted tables, the snapshot and the plot caches (see MemoryUsage)
+    MemoryUsage memoryUsage(QSet<const void *> *seen = nullptr) const;
+    // Drops every cache the next plot rebuilds on demand; the plotted data stays
+    void releaseCaches();
     QString getPlotCSV() const;
     QString getPlotRCode() const;  // ggplot2 R script reproducing the current plot
     QString getScatterCSV() const; // CSV export for multi-panel scatter (VARIABLE,EXPERIMENT,SIMULATED,MEASURED)
-    void exportPlot(const QString &filePath, const QString &format = "PNG", int dpi = 300);
+    // quiet: report failure through the return value only, no message box (headless
+    // and batch runs, where a modal dialog would block the process)
+    bool exportPlot(const QString &filePath, const QString &format = "PNG", int dpi = 300,
+                    bool quiet = false);
+    // Copy of the visible single-chart plot for PlotRenderer (offscreen export)
+    PlotRenderModel renderModel() const;
+    // True when the current plot can be exported through PlotRenderer (single
+    // time-series chart); other modes export by grabbing their widgets
+    bool canRenderOffscreen() const;
     void exportPlotComposite(const QString &filePath, const QString &format, int width, int height, int dpi);
     void copyPlotToClipboard();  // Copy plot to clipboard
     QPixmap cropToContent(const QPixmap &source);
@@ -266,6 +337,7 @@ protected:
 signals:
     void plotUpdated();
     void errorOccurred(const QString &error);
+    void warningOccurred(const QString &warning);   // non-fatal: the plot is still drawn
     void metricsCalculated(const QVector<QMap<QString, QVariant>> &metrics);
     void xVariableChanged(const QString &xVariable);
     void refreshFilesRequested();
@@ -281,9 +353,13 @@ private slots:
     void onPlotSettingsChanged();
     void onXAxisButtonClicked();
     void applyPlotSettings(const PlotSettings &settings, bool skipAxisRange = false);
+    static bool settingsAffectData(const PlotSettings &a, const PlotSettings &b, bool scatterMode);
     void saveSettings() const;
     void loadSettings();
     void onBoxPlotButtonClicked();
+    void scheduleLevelOfDetail();
+    void applyLevelOfDetail();
+    void processPendingHover();
 private:
     // Core plotting functions (matching Python structure)
     // DataTable loadSimulationData(const QString &selectedFolder, const QStringList &selectedOutFiles); // Removed
@@ -302,7 +378,46 @@ private:
                      const QMap<QString, QStringList> &yVarFileFilter = QMap<QString, QStringList>());
     void plotOsuBoxPlot(const DataTable &simData, const QStringList &yVars,
                         const QStringList &treatments, const QString &selectedExperiment);
+    // Box plot grouping and per-variable quantiles, cached across replots of the same data
+    // (m_dataVersion; see PlotWidget_BoxPlot.cpp)
+    struct BoxPlotGrouping {
+        quint64 dataVersion = 0;            // m_dataVersion the grouping was built for
+        QString filterKey;                  // treatments + experiment the grouping was built for
+        QVector<int> rowGroup;              // per row: group index, -1 when filtered out
+        QVector<bool> rowMdatMissing;       // per row: MDAT missing (crop-failure test)
+        bool anyMdatMissing = false;        // some grouped row is a potential crop failure
+        DataColumn groupColumn;             // rowGroup as cells for DataColumn::groupStats
+        QStringList groupKeys;
+        QStringList groupLabels;
+        bool isSequenceMode = false;
+    };
+    struct BoxPlotVarCache {
+        quint64 dataVersion = 0;            // m_dataVersion the stats were built for
+        QString scaleKey;                   // scale factor/offset applied to the column
+        QVector<ErrorBarChartView::BoxPlotStats> stats;  // one per group index
+    };
+    const BoxPlotGrouping &boxPlotGroupingFor(const DataTable &simData, const QStringList &treatments,
+                                              const QString &selectedExperiment);
+    const QVector<ErrorBarChartView::BoxPlotStats> &boxPlotStatsFor(const DataTable &simData,
+                                                                    const QString &yVar);
     QVector<ErrorBarData> aggregateReplicates(const QVector<QPointF> &points, const QString &xVar, double xTolerance = 0.01);
+    static void groupReplicates(const QVector<QPointF> &points, double tolerance,
+                                QVector<ErrorBarData> &errorBars, QVector<int> *singleIndex);
+    // Replicate groupings cached per x-variable and observed series (see replicateGroupsFor)
+    struct ReplicateGroups {
+        QVector<QPointF> points;         // input the grouping was built from
+        QVector<ErrorBarData> errorBars; // x-sorted means with SD and n
+        QVector<int> singleIndex;        // per bar: source point index for n==1 groups, else -1
+    };
+    const ReplicateGroups &replicateGroupsFor(const QString &seriesKey, const QVector<QPointF> &points,
+                                              const QString &xVar);
+    // Ensemble bands (PlotWidget_Ensemble.cpp): per-x percentiles pooled over all runs
+    struct EnsembleStats { double x, p5, p25, p50, p75, p95, mean; };
+    static QVector<EnsembleStats> summariseEnsemble(const QVector<QVector<QPointF>> &runs);
+    static QVector<PlotData> ensemblePlotData(const PlotData &base, const QVector<EnsembleStats> &stats);
+    QAbstractSeries *createEnsembleBandSeries(const QSharedPointer<PlotData> &plotData) const;
+    void linkEnsembleSeries(const QVector<QSharedPointer<PlotData>> &plotDataList);
+    static constexpr int ENSEMBLE_PARALLEL_MIN_POINTS = 200000;
     void setupUI();
     void setupChart();
     void enforceAxisColors();
@@ -315,10 +430,38 @@ private:
     void updateAnimLabel(int frame);
     void stopAnim();
     void addSeriesToPlot(const QVector<PlotData> &plotDataList);
+    QVector<PlotData> buildPlotModel(const DataTable &simData, const DataTable &obsData,
+                                     const QString &xVar, const QStringList &yVars,
+                                     const QStringList &treatments, const QString &selectedExperiment,
+                                     const QMap<QString, QStringList> &yVarFileFilter);
+    QByteArray plotModelKey(const DataTable &simData, const DataTable &obsData,
+                            const QString &xVar, const QStringList &yVars,
+                            const QStringList &treatments, const QString &selectedExperiment,
+                            const QMap<QString, QStringList> &yVarFileFilter) const;
+    QVector<PlotData> plotModelFor(const DataTable &simData, const DataTable &obsData,
+                                   const QString &xVar, const QStringList &yVars,
+                                   const QStringList &treatments, const QString &selectedExperiment,
+                                   const QMap<QString, QStringList> &yVarFileFilter);
+    void clearPlotModelCache();
+    void syncDataVersion();
+    // Series pool: a replot parks the chart's line/scatter series by identity and reuses
+    // them for the same variable/crop/experiment/treatment/run instead of reallocating
+    static QString seriesPoolKey(const PlotData &plotData);
+    void poolChartSeries();
+    QAbstractSeries *takePooledSeries(const PlotData &plotData, bool scatter, bool *pointsUnchanged);
+    void releaseSeriesPool();
+    void removeUnpooledSeries();
+    // Level-of-detail: per-pixel-column min/max envelope of x-sorted line data
+    static QVector<QPointF> decimateMinMax(const QVector<QPointF> &points, double xMin, double xMax, int columns);
+    QVector<QPointF> levelOfDetailPoints(const QVector<QPointF> &points, bool visibleRangeOnly) const;
+    int levelOfDetailColumns() const;
     void updateScalingLabel(const QStringList &yVars);
     void updatePlotWithScaling();
     void setupPreplotPanel();
     void resizeScatterPanels();
+    // Scatter density mode: pooled sim/obs pairs counted into bins over [axMin, axMax]²
+    static ErrorBarChartView::DensityBins binDensity(const QVector<QPointF> &points, double axMin,
+                                                     double axMax, int bins, bool hexagonal);
     QPixmap grabScatterAtSize(int panelSide);
     void plotTimeSeriesMultiPanel();
     void resizeTimeSeriesPanels();
@@ -354,6 +497,28 @@ private:
     void selectLegendRowForSeries(QAbstractSeries* series);
     QAbstractSeries* findSeriesNearPoint(const QPoint& viewPos) const;
     QPointF findNearestDataPoint(QAbstractSeries* series, const QPoint& viewPos) const;
+    // Hover hit-testing index: series points mapped to chart pixels and bucketed
+    // in a uniform grid, rebuilt lazily after plotting or an axis/plot-area change
+    struct HoverIndex {
+        struct Track {
+            QPointer<QAbstractSeries> series;
+            QVector<QPointF> data;    // full-resolution points (shared with PlotData)
+            QVector<QPointF> pixels;  // data mapped to chart item coordinates
+            bool isLine = false;
+            double threshold = 0.0;   // hit radius in pixels
+        };
+        struct Entry { int track; int index; };  // index = point, or segment start for lines
+        QVector<Track> tracks;
+        QRectF extent;
+        double cellSize = 24.0;
+        int cols = 0, rows = 0;
+        QVector<int> cellStart;                  // CSR offsets into entries, size cols*rows+1
+        QVector<Entry> entries;
+        int seriesCount = 0;                     // chart series count when built
+        bool valid = false;
+    };
+    void ensureHoverIndex() const;
+    void invalidateHoverIndex();
 
     // Hover tooltip
     void showHoverTooltip(QAbstractSeries* series, const QPointF& dataPoint, const QPoint& viewPos);
@@ -396,8 +561,9 @@ private:
     QString getTreatmentDisplayName(const QString &trtId, const QString &experimentId, const QString &cropId = QString());
     QString getTreatmentNameFromData(const QString &treatment, const QString &experiment, const QString &crop);
     void testScalingFunctionality(); // TEMPORARY: Test scaling logic
-    QStringList computeAnimMetricsForVar(const QString &varCode, double cutoff,
+    QStringList computeAnimMetricsForVar(const QString &varCode, int frame,
                                          const QSet<QString> &selectedMetrics) const;
+    void rebuildAnimMetricsIndex();
     QString buildTSOverlayHtml(const QVector<QMap<QString, QVariant>> &metrics,
                                 const QSet<QString> &selectedMetrics) const;
     void refreshTSMetricsOverlay();
@@ -438,6 +604,18 @@ private:
     QVector<double> m_animXValues;   // sorted unique x values across all series
     int  m_animFrame   = 0;
     bool m_animPlaying = false;
+    // Per-series animation state (see buildAnimTracks): x-sorted series show a prefix of
+    // their points, so a frame step only appends or removes the points in between
+    struct AnimTrack {
+        QSharedPointer<PlotData> plotData;
+        QPointer<QAbstractSeries> series;        // series the prefixes were built for
+        QPointer<ErrorBarChartView> errorBarView; // view drawing this series' error bars
+        QVector<int> pointPrefix;     // per frame: points with x <= cutoff; empty = not x-sorted
+        QVector<int> errorBarPrefix;  // per frame: error bars with meanX <= cutoff
+        int shownPoints = -1;         // points the series currently holds; -1 = unknown
+    };
+    QVector<AnimTrack> m_animTracks;
+    void buildAnimTracks();
 
     // Legend area
     QScrollArea *m_legendScrollArea;
@@ -462,6 +640,11 @@ private:
     // Legend management (simplified)
     QVector<QSharedPointer<PlotData>> m_plotDataList;
     QMap<QAbstractSeries*, QSharedPointer<PlotData>> m_seriesToPlotData;
+    struct PooledSeries {
+        QPointer<QAbstractSeries> series;
+        QVector<QPointF> points;  // full-resolution points the series was last built from
+    };
+    QHash<QString, QVector<PooledSeries>> m_seriesPool;
 
     // Obs/Sim global toggle state (persist across legend rebuilds; reset on full clear())
     bool m_obsVisible = true;
@@ -471,6 +654,9 @@ private:
 
     // Plot→Legend hit-testing state
     QAbstractSeries* m_hoveredSeries = nullptr;
+    mutable HoverIndex m_hoverIndex;
+    QTimer *m_hoverTimer = nullptr;       // coalesces mouse moves to one hit test per frame
+    QPoint m_pendingHoverPos;
     QPoint m_chartClickPressPos;
     bool m_isZoomed = false;
     bool m_ctrlDragPending = false;
@@ -488,6 +674,17 @@ private:
     QMap<QString, QVector<AnimPair>> m_animMatchedPairs;
     QSet<QString> m_animValidKeys; // keys that pass treatment/series filters
 
+    // Per-variable prefix accumulators over the valid anim pairs, pooled and sorted by x.
+    // Built once per plot/metrics pass so each animation frame is an O(1) lookup.
+    struct AnimMetricsIndex {
+        QVector<double> x, obs, sim;        // pooled pairs, x-sorted
+        QVector<double> sumObs;             // prefix sums (size n+1)
+        QVector<double> sumSqErr;           // prefix sums of (obs - sim)^2 (size n+1)
+        QVector<int>    frameCount;         // pairs with x <= m_animXValues[frame]
+        QVector<double> frameDStat;         // d-stat of each frame's prefix
+    };
+    QHash<QString, AnimMetricsIndex> m_animMetricsIndex;
+
     // Snapshot / comparison mode
     QVector<QSharedPointer<PlotData>> m_snapshotDataList;
     bool         m_snapshotActive = false;
@@ -504,6 +701,7 @@ private:
     QString      m_snapshotExperiment;
     // Rebuild ghost points from the frozen data using the current x-variable.
     QVector<QSharedPointer<PlotData>> buildSnapshotSeriesForCurrentX();
+    QHash<QString, QVector<QSharedPointer<PlotData>>> m_snapshotGhostCache;  // xVar → ghosts
     bool snapshotXValue(const QString &xVar, const QVariant &xVal, double &outX);
 
     // Per-variable metrics overlay labels for multi-panel mode (variable -> label)
@@ -537,6 +735,8 @@ private:
     int m_maxLegendEntries;
     bool m_isScatterMode;
     bool m_isBoxPlotMode;
+    BoxPlotGrouping m_boxPlotGrouping;
+    QHash<QString, BoxPlotVarCache> m_boxPlotVarCache;  // yVar → quantiles for m_boxPlotGrouping
 
     // Multi-panel scatter: grid of QChartViews owned here, shown in m_scatterPanelArea
     QWidget *m_scatterPanelContainer = nullptr;
@@ -563,10 +763,36 @@ private:
     // Optimization: Date parsing cache to avoid re-parsing same dates
     QMap<QString, qint64> m_dateCache;
 
+    // Optimization: PlotData models of recent plot requests (see plotModelFor), so
+    // switching back to an earlier x-axis/scaling/filter configuration skips the build
+    struct PlotModel {
+        QVector<PlotData> plotDataList;           // real x units, before axis-break remap
+        QMap<QString, QColor> treatmentColorMap;  // colour assignment of the build
+        qint64 bytes = 0;
+    };
+    QHash<QByteArray, PlotModel> m_plotModelCache;
+    QList<QByteArray> m_plotModelOrder;  // least recently used first
+    qint64 m_plotModelBytes = 0;
+    quint64 m_dataVersion = 0;           // bumped when m_simData/m_obsData hold other buffers
+    // Shallow copies of the tables m_dataVersion was taken for. They pin the column
+    // buffers, so a later table can never reuse their addresses (see syncDataVersion)
+    DataTable m_versionSimData;
+    DataTable m_versionObsData;
+    static constexpr qint64 PLOT_MODEL_CACHE_BYTES = 64ll * 1024 * 1024;
+
+    // Optimization: replicate groupings keyed by "xVar|yVar|crop__exp__trt"
+    QHash<QString, ReplicateGroups> m_replicateCache;
+    static constexpr int MAX_REPLICATE_CACHE_ENTRIES = 4096;
+
     // Optimization: Track pending auto-fit to avoid multiple calls
     bool m_autoFitPending;
     QTimer *m_autoFitTimer;
 
+    // Optimization: line series hold a decimated copy of PlotData::points, rebuilt
+    // (coalesced) when the plot area or x range changes
+    QTimer *m_lodTimer = nullptr;
+    static constexpr int LOD_POINTS_PER_COLUMN = 4;  // first/min/max/last per pixel column
+
 
     // Axis break support (DATE x-axis only)
     // Each break: first = gap start (real msec), second = gap end (real msec)
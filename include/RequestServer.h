@@ -0,0 +1,95 @@
+#ifndef REQUESTSERVER_H
+#define REQUESTSERVER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QJsonObject>
+#include <QSharedPointer>
+#include <QDateTime>
+#include "DataProcessor.h"
+
+class QLocalServer;
+class QLocalSocket;
+class PlotWidget;
+
+// Resident request server (GB2 --serve [name]). Clients connect to the local socket
+// `name` (default "gb2-server") and send one JSON request per line; each request
+// is answered with one JSON header line followed by exactly "size" payload bytes:
+//
+//   > {"cmd": "metrics", "cropDir": "Maize", "files": ["PlantGro.OUT"], "format": "csv"}
+//   < {"ok": true, "contentType": "text/csv", "size": 1234, "cached": true}\n<1234 bytes>
+//   < {"ok": false, "error": "...", "size": 0}\n
+//
+// Commands (cropDir + files name a file set, as in a --batch job):
+//   ping                                   server version, cached sets
+//   load     cropDir files                 table shapes; parses and caches the set
+//   table    cropDir files [table] [columns] [format]
+//            table "sim" (default), "obs" or "evaluate"; format "csv" (default) or
+//            "columnar": per column, rows x float64 LE (NaN = missing) for numeric
+//            columns, rows x (uint32 LE length + UTF-8) for text; the header lists
+//            {name, type: "f64" | "utf8"} in payload order
+//   metrics  cropDir files [vars] [treatments] [format "csv" | "json"]
+//   plot     cropDir files yvars [xvar] [treatments] [width] [height] [dpi] [format]
+//            time-series PNG/JPG bytes; width/height are clamped to 64..8192 and dpi
+//            is lowered to keep the image within 64 Mpx (the header reports the dpi used)
+//   evict                                  drop every cached file set
+//
+// Parsed file sets stay cached (LRU, revalidated against file size and mtime) and
+// the DSSAT lookups (DATA.CDE, DETAIL.CDE) stay warm for the life of the process.
+class RequestServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RequestServer(QObject *parent = nullptr);
+    ~RequestServer();
+
+    static constexpr const char *DEFAULT_NAME = "gb2-server";
+
+    bool listen(const QString &name);
+    QString errorString() const { return m_error; }
+
+private slots:
+    void onNewConnection();
+    void onReadyRead();
+
+private:
+    struct FileSet {
+        QString key;
+        QString folderName;
+        QVector<QPair<QString, QString>> files;   // (file name, absolute path)
+        QVector<QPair<qint64, QDateTime>> stamps; // size and mtime when parsed
+        OutputFileSet data;
+        qint64 loadMs = 0;
+    };
+
+    struct Response {
+        QJsonObject header;
+        QByteArray payload;
+    };
+
+    static Response errorResponse(const QString &message);
+    Response handle(const QJsonObject &request);
+    QSharedPointer<FileSet> fileSetFor(const QJsonObject &request, bool *cached, QString *error);
+    Response tableResponse(const FileSet &set, const QJsonObject &request);
+    Response metricsResponse(const FileSet &set, const QJsonObject &request);
+    Response plotResponse(const FileSet &set, const QJsonObject &request);
+    void send(QLocalSocket *socket, Response response);
+
+    static constexpr int MAX_CACHED_SETS = 16;
+    static constexpr int PROBE_TIMEOUT_MS = 500;       // live-server check before listen()
+    // Limits for plot requests (logical pixels, and pixels after dpi supersampling)
+    static constexpr int MIN_IMAGE_SIDE = 64;
+    static constexpr int MAX_IMAGE_SIDE = 8192;
+    static constexpr int MIN_IMAGE_DPI = 48;
+    static constexpr qint64 MAX_IMAGE_PIXELS = 64ll * 1024 * 1024;
+
+    QLocalServer *m_server = nullptr;
+    QString m_error;
+    QVector<QSharedPointer<FileSet>> m_cache;     // most recently used first
+    PlotWidget *m_plot = nullptr;                 // hidden, reused for every plot request
+};
+
+#endif // REQUESTSERVER_H
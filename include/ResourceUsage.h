@@ -0,0 +1,24 @@
+#ifndef RESOURCEUSAGE_H
+#define RESOURCEUSAGE_H
+
+#include <QtGlobal>
+
+// Process memory figures for gb2-bench and the perf tests.
+//
+// Allocation counting needs GB2_COUNT_ALLOCATIONS and a GNU-style linker: the bench
+// target is linked with --wrap=malloc/calloc/realloc, which also catches the
+// allocations inside the statically linked Qt (QString, QVector, QVariant payloads),
+// not just operator new. Without it the counters stay at zero.
+namespace ResourceUsage {
+
+// Peak resident set size of the process so far, -1 where unknown
+qint64 peakRssBytes();
+
+bool countsAllocations();
+// Totals since process start; diff two readings to count a region
+quint64 allocationCount();
+quint64 allocatedBytes();
+
+} // namespace ResourceUsage
+
+#endif // RESOURCEUSAGE_H
@@ -17,10 +17,11 @@ public:
 
     bool isFirstInstance() const { return m_isFirstInstance; }
     void showAlreadyRunningMessage();
+    // Gives up the instance lock, for modes that run alongside the GUI instance
+    void cleanupLock();
 
 private:
     bool lockInstance();
-    void cleanupLock();
 
     QString m_appId;
     QString m_lockFilePath;
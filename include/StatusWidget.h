@@ -8,6 +8,7 @@
 #include <QTimer>
 #include <QMessageBox>
 #include "Config.h"
+#include "DataProcessor.h"
 
 class StatusWidget : public QWidget
 {
@@ -24,6 +25,8 @@ public:
     void hideProgress();
     void clear();
     void setRightWidget(QWidget *widget);
+    // Right-most readout of loaded data memory against the budget (0 = no limit)
+    void setMemoryUsage(const MemoryUsage &usage, qint64 budget);
 
 private slots:
     void onClearTimer();
@@ -37,6 +40,7 @@ private:
     QHBoxLayout *m_layout;
     QLabel *m_messageLabel;
     QProgressBar *m_progressBar;
+    QLabel *m_memoryLabel;
     QTimer *m_clearTimer;
     QTimer *m_flashTimer;
 
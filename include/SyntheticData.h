@@ -0,0 +1,47 @@
+#ifndef SYNTHETICDATA_H
+#define SYNTHETICDATA_H
+
+#include <QString>
+#include <QStringList>
+
+// Shape of a synthetic DSSAT run. Values follow logistic growth curves per
+// variable, treatment and run with seeded noise, so the same spec always writes
+// byte-identical files on every platform.
+struct SyntheticSpec {
+    int runs = 2;
+    int treatments = 4;
+    int days = 150;              // daily rows per run and treatment
+    int columns = 24;            // PlantGro variables besides YEAR/DOY/DAS/DAP
+    double missingRate = 0.02;   // share of value cells written as -99
+    int obsInterval = 10;        // days between observations in the T file
+    int obsColumns = 8;          // observed variables (the first PlantGro variables)
+    quint32 seed = 1;
+    QString experiment = "UFGA0001";
+    QString crop = "MZ";
+    int firstYear = 2001;        // run r is simulated in firstYear + r - 1
+
+    qint64 simRows() const { return qint64(runs) * treatments * days; }
+};
+
+// Paths of one written data set, all in the same folder
+struct SyntheticFiles {
+    QString plantGro;    // PlantGro.OUT: *RUN sections of daily rows
+    QString summaryOsu;  // Summary.OSU: one fixed-width row per run and treatment
+    QString evaluate;    // EVALUATE.OUT: simulated/measured pairs per run and treatment
+    QString tFile;       // <experiment>.<crop>T: observed time series of run 1
+    QStringList variables;
+    QStringList observedVariables;
+};
+
+namespace SyntheticData {
+
+// PlantGro variable names: real DSSAT codes first, then V001, V002, ...
+QStringList variableNames(int count);
+// Writes all four files into dir (created if missing). False, with *error set,
+// if a file cannot be written.
+bool write(const QString &dir, const SyntheticSpec &spec, SyntheticFiles *files,
+           QString *error = nullptr);
+
+} // namespace SyntheticData
+
+#endif // SYNTHETICDATA_H
@@ -0,0 +1,88 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <atomic>
+#include <utility>
+
+// Scoped-timer tracing written as Chrome trace-event JSON (chrome://tracing,
+// ui.perfetto.dev), one track per thread. Recording is off unless started with
+// --trace <file> or GB2_TRACE=<file> (or --startup-trace, which prints a summary
+// instead); a disabled scope costs one relaxed atomic load, and argument
+// expressions are not evaluated.
+//
+//   GB2_TRACE_SCOPE("metrics");
+//   GB2_TRACE_SCOPE_ARG("readFile", QFileInfo(path).fileName());
+//   Trace::mark("setupUI");   // sequential phase ending now
+namespace Trace {
+
+extern std::atomic<bool> g_enabled;
+
+inline bool isEnabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+// Starts recording; stop() writes everything recorded so far to filePath. While
+// already recording, only sets the file.
+void start(const QString &filePath);
+// Starts recording (without a file unless start() adds one) for printSummary()
+void startSummary();
+// startSummary() was called and printSummary() has not run yet
+bool summaryPending();
+// Prints the calling thread's spans so far to stderr as a table; once per process
+void printSummary();
+// start() with $GB2_TRACE, if set and recording is not already on
+void startFromEnvironment();
+// Writes the trace file and stops recording. True if nothing was recording.
+bool stop();
+// Names the calling thread's track ("main" and "worker N" otherwise)
+void setThreadName(const QString &name);
+
+// Steady clock in nanoseconds
+qint64 now();
+void record(const char *name, qint64 startNs, qint64 endNs, const QString &arg);
+// Records a span from the calling thread's previous mark (or the start of recording)
+// to now, for sequential phases that are not a block of their own
+void mark(const char *phase);
+
+class Scope
+{
+public:
+    explicit Scope(const char *name)
+        : m_name(isEnabled() ? name : nullptr), m_start(m_name ? now() : 0) {}
+    // argFn runs only while recording
+    template <typename ArgFn>
+    Scope(const char *name, ArgFn &&argFn) : Scope(name)
+    {
+        if (m_name) m_arg = std::forward<ArgFn>(argFn)();
+    }
+    ~Scope() { finish(); }
+
+    // Ends the span early, for phases that are not a block of their own
+    void finish()
+    {
+        if (m_name) record(m_name, m_start, now(), m_arg);
+        m_name = nullptr;
+    }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *m_name;
+    qint64 m_start;
+    QString m_arg;
+};
+
+// Stops and writes the trace when it goes out of scope (end of main)
+struct Session {
+    ~Session() { stop(); }
+};
+
+} // namespace Trace
+
+#define GB2_TRACE_CONCAT_(a, b) a##b
+#define GB2_TRACE_CONCAT(a, b) GB2_TRACE_CONCAT_(a, b)
+#define GB2_TRACE_SCOPE(name) \
+    Trace::Scope GB2_TRACE_CONCAT(gb2TraceScope_, __LINE__)(name)
+#define GB2_TRACE_SCOPE_ARG(name, arg) \
+    Trace::Scope GB2_TRACE_CONCAT(gb2TraceScope_, __LINE__)(name, [&]() { return QString(arg); })
+
+#endif // TRACE_H
@@ -0,0 +1,392 @@
+#include "BatchRunner.h"
+#include "PlotWidget.h"
+#include "PlotRenderer.h"
+#include "MetricsCalculator.h"
+#include "Trace.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QTextStream>
+#include <QHash>
+#include <cstdio>
+
+namespace {
+
+// Manifest lists may be JSON arrays or comma-separated strings, as on the command line
+QStringList stringList(const QJsonValue &value)
+{
+    QStringList out;
+    if (value.isArray()) {
+        for (const QJsonValue &item : value.toArray()) {
+            const QString s = item.isString() ? item.toString() : QString::number(item.toDouble());
+            if (!s.trimmed().isEmpty()) out.append(s.trimmed());
+        }
+    } else if (value.isString()) {
+        for (const QString &s : value.toString().split(',', Qt::SkipEmptyParts))
+            out.append(s.trimmed());
+    }
+    return out;
+}
+
+QString resolvePath(const QDir &base, const QString &path)
+{
+    if (path.isEmpty() || QDir::isAbsolutePath(path)) return path;
+    return base.absoluteFilePath(path);
+}
+
+QString imageFormatFor(const QString &path)
+{
+    const QString suffix = QFileInfo(path).suffix().toUpper();
+    return suffix.isEmpty() ? QString("PNG") : suffix;
+}
+
+} // namespace
+
+BatchRunner::BatchRunner()
+{
+}
+
+BatchRunner::~BatchRunner()
+{
+    delete m_timeSeriesPlot;
+    delete m_scatterPlot;
+}
+
+bool BatchRunner::loadManifest(const QString &manifestPath, QString *error)
+{
+    QFile file(manifestPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = QString("cannot open %1: %2").arg(manifestPath, file.errorString());
+        return false;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (doc.isNull()) {
+        *error = QString("%1: %2 at offset %3").arg(manifestPath, parseError.errorString())
+                     .arg(parseError.offset);
+        return false;
+    }
+
+    // Relative paths in the manifest are relative to the manifest itself
+    const QDir base = QFileInfo(manifestPath).absoluteDir();
+    QJsonArray jobs;
+    if (doc.isArray()) {
+        jobs = doc.array();
+    } else {
+        const QJsonObject root = doc.object();
+        jobs = root.value("jobs").toArray();
+        m_threads = root.value("threads").toInt(0);
+        m_summaryPath = resolvePath(base, root.value("summary").toString());
+        // Same override the GUI honours (DataProcessor::getDSSATBase)
+        if (root.contains("dssatBase"))
+            qputenv("DSSAT_PATH", root.value("dssatBase").toString().toLocal8Bit());
+    }
+
+    for (int i = 0; i < jobs.size(); ++i) {
+        const QJsonObject o = jobs.at(i).toObject();
+        BatchJob job;
+        job.name = o.value("name").toString(QString("job%1").arg(i + 1));
+        job.cropDir = o.value("cropDir").toString();
+        job.files = stringList(o.value("files"));
+        job.xVar = o.value("xvar").toString(job.xVar);
+        job.yVars = stringList(o.value("yvars"));
+        job.treatments = stringList(o.value("treatments"));
+        job.plotType = o.value("plotType").toString(job.plotType).toLower();
+        job.outputPath = resolvePath(base, o.value("output").toString());
+        job.metricsPath = resolvePath(base, o.value("metrics").toString());
+        job.width = o.value("width").toInt(job.width);
+        job.height = o.value("height").toInt(job.height);
+        job.dpi = o.value("dpi").toInt(job.dpi);
+
+        if (job.plotType == "scatter" && job.files.isEmpty())
+            job.files << "EVALUATE.OUT";
+        if (job.cropDir.isEmpty() || job.files.isEmpty())
+            job.error = "cropDir and files are required";
+        else if (job.plotType != "timeseries" && job.plotType != "boxplot" && job.plotType != "scatter")
+            job.error = QString("unknown plotType '%1'").arg(job.plotType);
+        else if (job.plotType != "scatter" && job.yVars.isEmpty())
+            job.error = "yvars is required";
+        else if (job.outputPath.isEmpty() && job.metricsPath.isEmpty())
+            job.error = "nothing to write (no output or metrics path)";
+        m_jobs.append(job);
+    }
+    if (m_jobs.isEmpty()) {
+        *error = QString("%1: no jobs").arg(manifestPath);
+        return false;
+    }
+    return true;
+}
+
+// Groups jobs by the files they read and parses each distinct set once, in parallel
+void BatchRunner::loadFileSets()
+{
+    DataProcessor resolver;
+    QHash<QString, int> setIndex;
+    for (BatchJob &job : m_jobs) {
+        if (!job.error.isEmpty()) continue;
+
+        // A crop name instead of a path resolves like the crop list does
+        QString folderPath = job.cropDir;
+        if (!QDir(folderPath).exists())
+            folderPath = resolver.getActualFolderPath(job.cropDir);
+        if (folderPath.isEmpty() || !QDir(folderPath).exists()) {
+            job.error = QString("crop folder not found: %1").arg(job.cropDir);
+            continue;
+        }
+        const QDir folder(folderPath);
+
+        auto set = QSharedPointer<FileSet>::create();
+        set->folderName = folder.dirName();
+        QStringList keyParts;
+        for (const QString &name : job.files) {
+            const QString path = QDir::cleanPath(folder.absoluteFilePath(name));
+            set->files.append(qMakePair(QFileInfo(path).fileName(), path));
+            keyParts.append(path.toLower());
+        }
+        keyParts.sort();
+        const QString key = folder.absolutePath().toLower() + '|' + keyParts.join('|');
+
+        auto it = setIndex.constFind(key);
+        if (it != setIndex.constEnd()) {
+            job.fileSet = it.value();
+            job.sharedLoad = true;
+        } else {
+            job.fileSet = m_fileSets.size();
+            setIndex.insert(key, job.fileSet);
+            m_fileSets.append(set);
+        }
+    }
+
+    // Workers only read these shared lookups once they are resolved here. With no DSSAT
+    // install the crop list is rescanned on every call, so parse one set at a time.
+    DataProcessor::getDSSATBase();
+    DataProcessor::getVariableInfo(QString());
+    const bool haveCropList = !DataProcessor::getCropDetails().isEmpty();
+
+    QThreadPool pool;
+    if (m_threads > 0) pool.setMaxThreadCount(m_threads);
+    if (!haveCropList) pool.setMaxThreadCount(1);
+    for (const QSharedPointer<FileSet> &set : m_fileSets) {
+        FileSet *fs = set.data();
+        pool.start([fs]() {
+            QElapsedTimer timer;
+            timer.start();
+            DataProcessor processor;
+            processor.loadOutputFiles(fs->folderName, fs->files, fs->data);
+            fs->loadMs = timer.elapsed();
+        });
+    }
+    pool.waitForDone();
+
+    for (BatchJob &job : m_jobs)
+        if (job.fileSet >= 0 && !job.sharedLoad)
+            job.loadMs = m_fileSets[job.fileSet]->loadMs;
+}
+
+PlotWidget *BatchRunner::plotWidgetFor(const BatchJob &job)
+{
+    // One widget per kind, reused across jobs; never shown
+    PlotWidget *&plot = job.plotType == "scatter" ? m_scatterPlot : m_timeSeriesPlot;
+    if (!plot) plot = new PlotWidget();
+    return plot;
+}
+
+// Builds the chart on this thread and queues image encoding and the metrics CSV
+void BatchRunner::runJob(BatchJob &job, QThreadPool &pool)
+{
+    GB2_TRACE_SCOPE_ARG("batch job", job.name);
+    const FileSet &set = *m_fileSets[job.fileSet];
+    QElapsedTimer timer;
+    timer.start();
+
+    PlotWidget *plot = plotWidgetFor(job);
+    bool plotted = false;
+    QVector<QMap<QString, QVariant>> metrics;
+    QMetaObject::Connection updated = QObject::connect(plot, &PlotWidget::plotUpdated, plot,
+        [&plotted]() { plotted = true; });
+    QMetaObject::Connection calculated = QObject::connect(plot, &PlotWidget::metricsCalculated, plot,
+        [&metrics](const QVector<QMap<QString, QVariant>> &m) { metrics = m; });
+
+    if (job.plotType == "scatter") {
+        if (set.data.evaluateData.rowCount == 0) {
+            job.error = "no EVALUATE.OUT data";
+        } else {
+            // No yvars: the same S/M pairs a headless --scatter run picks
+            if (job.yVars.isEmpty())
+                job.yVars = PlotWidget::defaultScatterVariables(set.data.evaluateData);
+            if (job.yVars.isEmpty())
+                job.error = "no simulated/measured variable pairs in EVALUATE.OUT";
+            else
+                plot->plotScatter(set.data.evaluateData, job.yVars);
+        }
+    } else if (set.data.simData.rowCount == 0) {
+        job.error = "no simulated data";
+    } else {
+        QStringList fileNames;
+        for (const auto &file : set.files) fileNames.append(file.first);
+        const QString experiment = set.data.experimentCodes.isEmpty()
+                                   ? QString() : set.data.experimentCodes.values().first();
+        plot->setBoxPlotMode(job.plotType == "boxplot");
+        plot->plotTimeSeries(set.data.simData, set.folderName, fileNames, experiment,
+                             job.treatments, job.xVar, job.yVars, set.data.obsData,
+                             set.data.treatmentNames);
+    }
+    QObject::disconnect(updated);
+    QObject::disconnect(calculated);
+
+    if (!plotted) {
+        if (job.error.isEmpty()) job.error = "no plot produced";
+        job.plotMs = timer.elapsed();
+        job.imageOk = job.outputPath.isEmpty();
+        job.metricsOk = job.metricsPath.isEmpty();
+        return;
+    }
+    job.plotOk = true;
+    job.plotMs = timer.elapsed();
+
+    BatchJob *target = &job;   // m_jobs is not resized while the pool runs
+    if (!job.outputPath.isEmpty()) {
+        const QString format = imageFormatFor(job.outputPath);
+        const bool pdf = format == "PDF";
+        if (plot->canRenderOffscreen() && !pdf) {
+            PlotRenderer renderer(plot->renderModel());
+            const QImage image = renderer.renderImage(QSize(job.width, job.height), job.dpi);
+            // Rendering counts as plotting; the image fields belong to the task from here
+            job.plotMs = timer.elapsed();
+            pool.start([target, image, format]() {
+                QElapsedTimer t;
+                t.start();
+                target->imageOk = PlotRenderer::saveImage(image, target->outputPath, format);
+                target->imageMs = t.elapsed();
+            });
+        } else {
+            // PDF pages and grabbed widgets (scatter grid, box plot) are written here.
+            // Check the path first: exportPlot reports failures with a dialog.
+            QFile probe(job.outputPath);
+            if (!probe.open(QIODevice::WriteOnly)) {
+                job.imageOk = false;
+                job.error = QString("cannot write %1").arg(job.outputPath);
+            } else {
+                probe.close();
+                probe.remove();
+                plot->resize(job.width, job.height);
+                QElapsedTimer t;
+                t.start();
+                job.imageOk = plot->exportPlot(job.outputPath, format, job.dpi, true /* quiet */);
+                job.imageMs = t.elapsed();
+            }
+        }
+    }
+
+    if (!job.metricsPath.isEmpty()) {
+        if (metrics.isEmpty()) {
+            job.metricsOk = false;
+            job.error = "no metrics (no observed values matched)";
+        } else {
+            QVariantList rows;
+            for (const auto &m : metrics) rows.append(QVariant(m));
+            pool.start([target, rows]() {
+                QElapsedTimer t;
+                t.start();
+                target->metricsOk = MetricsCalculator::writeMetricsCsv(target->metricsPath, rows);
+                target->metricsMs = t.elapsed();
+            });
+        }
+    }
+}
+
+bool BatchRunner::run(const QString &manifestPath)
+{
+    QElapsedTimer total;
+    total.start();
+
+    QString error;
+    if (!loadManifest(manifestPath, &error)) {
+        fprintf(stderr, "[BATCH] %s\n", error.toLocal8Bit().constData());
+        fflush(stderr);
+        return false;
+    }
+
+    loadFileSets();
+
+    QThreadPool pool;
+    if (m_threads > 0) pool.setMaxThreadCount(m_threads);
+    for (BatchJob &job : m_jobs)
+        if (job.error.isEmpty() && job.fileSet >= 0)
+            runJob(job, pool);
+    pool.waitForDone();
+
+    for (BatchJob &job : m_jobs) {
+        if (!job.imageOk && job.error.isEmpty())
+            job.error = QString("cannot write %1").arg(job.outputPath);
+        else if (!job.metricsOk && job.error.isEmpty())
+            job.error = QString("cannot write %1").arg(job.metricsPath);
+    }
+
+    const qint64 totalMs = total.elapsed();
+    printSummary(totalMs);
+    if (!m_summaryPath.isEmpty() && !writeSummary(m_summaryPath, totalMs))
+        fprintf(stderr, "[BATCH] cannot write summary %s\n", m_summaryPath.toLocal8Bit().constData());
+
+    bool allOk = true;
+    for (const BatchJob &job : m_jobs)
+        allOk = allOk && job.error.isEmpty();
+    return allOk;
+}
+
+void BatchRunner::printSummary(qint64 totalMs) const
+{
+    int failed = 0;
+    for (const BatchJob &job : m_jobs)
+        if (!job.error.isEmpty()) ++failed;
+
+    QTextStream out(stdout);
+    out << QString("Batch: %1 jobs, %2 failed, %3 file sets, %4 ms\n")
+               .arg(m_jobs.size()).arg(failed).arg(m_fileSets.size()).arg(totalMs);
+    out << QString("%1 %2 %3 %4 %5 %6  %7\n")
+               .arg("job", -24).arg("status", -6).arg("load", 8).arg("plot", 8)
+               .arg("image", 8).arg("metrics", 8).arg("detail");
+    for (const BatchJob &job : m_jobs) {
+        const QString load = job.sharedLoad ? QString("shared") : QString::number(job.loadMs);
+        out << QString("%1 %2 %3 %4 %5 %6  %7\n")
+                   .arg(job.name.left(24), -24)
+                   .arg(job.error.isEmpty() ? "ok" : "FAIL", -6)
+                   .arg(load, 8).arg(job.plotMs, 8).arg(job.imageMs, 8).arg(job.metricsMs, 8)
+                   .arg(job.error.isEmpty() ? job.outputPath : job.error);
+    }
+    out.flush();
+}
+
+bool BatchRunner::writeSummary(const QString &path, qint64 totalMs) const
+{
+    QJsonArray jobs;
+    for (const BatchJob &job : m_jobs) {
+        QJsonObject o;
+        o["name"] = job.name;
+        o["ok"] = job.error.isEmpty();
+        if (!job.error.isEmpty()) o["error"] = job.error;
+        o["sharedLoad"] = job.sharedLoad;
+        o["loadMs"] = job.loadMs;
+        o["plotMs"] = job.plotMs;
+        o["imageMs"] = job.imageMs;
+        o["metricsMs"] = job.metricsMs;
+        if (!job.outputPath.isEmpty()) o["output"] = job.outputPath;
+        if (!job.metricsPath.isEmpty()) o["metrics"] = job.metricsPath;
+        jobs.append(o);
+    }
+    QJsonObject root;
+    root["totalMs"] = totalMs;
+    root["fileSets"] = m_fileSets.size();
+    root["jobs"] = jobs;
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    file.write(QJsonDocument(root).toJson());
+    return true;
+}
@@ -40,6 +40,14 @@ CommandLineArgs CommandLineHandler::parseCommandLineArgs(const QStringList &args
                 result.saveMetricsPath = tokens[++i];
             } else if (tok == "--boxplot") {
                 result.boxPlotMode = true;
+            } else if (tok == "--batch" && i + 1 < tokens.size()) {
+                result.batchManifest = tokens[++i];
+                result.headlessMode = true;
+            } else if (tok == "--serve") {
+                result.serveMode = true;
+                result.headlessMode = true;
+                if (i + 1 < tokens.size() && !tokens[i + 1].startsWith('-'))
+                    result.serveName = tokens[++i];
             } else if (tok == "--scatter") {
                 result.scatterMode = true;
                 result.headlessMode = true;
@@ -81,6 +89,12 @@ CommandLineArgs CommandLineHandler::parseCommandLineArgs(const QStringList &args
             }
         }
 
+        // Batch mode takes everything from the manifest, server mode from its requests
+        if (!result.batchManifest.isEmpty() || result.serveMode) {
+            result.isValid = true;
+            return result;
+        }
+
         // Scatter headless mode only needs crop name (1 positional arg)
         if (result.scatterMode && params.size() >= 1) {
             result.cropName = params[0];
@@ -187,7 +201,7 @@ void CommandLineHandler::selectOutputFiles()
     if (!m_mainWindow || m_args.outputFiles.isEmpty()) {
         // For scatter headless mode, no output files needed — go straight to scatter plot
         if (m_args.scatterMode)
-            QTimer::singleShot(100, this, &CommandLineHandler::loadInitialContent);
+            QTimer::singleShot(0, this, &CommandLineHandler::loadInitialContent);
         return;
     }
     
@@ -197,8 +211,9 @@ void CommandLineHandler::selectOutputFiles()
             QString message = QString("Loaded %1 with %2 output files")
                                 .arg(m_args.cropName).arg(selectedCount);
 
-            // Load the first tab content
-            QTimer::singleShot(100, this, &CommandLineHandler::loadInitialContent);
+            // Files are read synchronously by selectOutputFiles(); continue once
+            // control is back in the event loop
+            QTimer::singleShot(0, this, &CommandLineHandler::loadInitialContent);
         } else {
             QString message = QString("No valid output files found from: %1")
                                 .arg(m_args.outputFiles.join(", "));
@@ -209,7 +224,8 @@ void CommandLineHandler::selectOutputFiles()
                 QMessageBox::warning(m_mainWindow, "Warning", message);
             }
         }
-        
+
+
     } catch (const std::exception &e) {
         QString message = QString("Error selecting output files: %1").arg(e.what());
         QMessageBox::critical(m_mainWindow, "File Selection Error", message);
@@ -233,13 +249,13 @@ void CommandLineHandler::loadInitialContent()
 
             if (m_args.scatterMode) {
                 // Scatter headless — trigger scatter plot directly
-                QTimer::singleShot(300, this, &CommandLineHandler::headlessScatterPlot);
+                QTimer::singleShot(0, this, &CommandLineHandler::headlessScatterPlot);
             } else if (currentTab == 0) {  // Time series tab
                 // Load variables but don't auto-plot
                 m_mainWindow->loadVariables();
 
                 if (m_args.headlessMode) {
-                    QTimer::singleShot(300, this, &CommandLineHandler::headlessAutoPlot);
+                    QTimer::singleShot(0, this, &CommandLineHandler::headlessAutoPlot);
                 }
             }
             
@@ -298,6 +314,50 @@ QString CommandLineHandler::extractCropNameFromPath(const QString &cropDirPath)
     return fallbackName;
 }
 
+void CommandLineHandler::watchHeadlessPlot(PlotWidget *plot)
+{
+    // PlotWidget builds and lays out the chart synchronously and signals once it is done
+    m_headlessPlotReady = false;
+    connect(plot, &PlotWidget::plotUpdated, this, [this]() { m_headlessPlotReady = true; },
+            Qt::SingleShotConnection);
+    connect(plot, &PlotWidget::errorOccurred, this, [this](const QString &error) {
+        qCritical() << "CommandLineHandler (headless):" << error;
+        m_headlessFailed = true;
+    }, Qt::SingleShotConnection);
+    connect(plot, &PlotWidget::warningOccurred, this, [](const QString &warning) {
+        qWarning() << "CommandLineHandler (headless):" << warning;
+    }, Qt::SingleShotConnection);
+}
+
+void CommandLineHandler::writeHeadlessOutputs(PlotWidget *plot, bool writeMetrics)
+{
+    if (!m_headlessPlotReady) {
+        qCritical() << "CommandLineHandler (headless): no plot was produced";
+        m_headlessFailed = true;
+    }
+
+    if (plot && m_headlessPlotReady && !m_args.savePlotPath.isEmpty()) {
+        if (!plot->exportPlot(m_args.savePlotPath, "PNG", 300, true /* quiet */)) {
+            qCritical() << "CommandLineHandler (headless): failed to save plot to"
+                        << m_args.savePlotPath;
+            m_headlessFailed = true;
+        }
+    }
+    if (writeMetrics && !m_args.saveMetricsPath.isEmpty()) {
+        if (!m_mainWindow->saveMetricsToFile(m_args.saveMetricsPath)) {
+            qWarning() << "CommandLineHandler (headless): failed to save metrics to"
+                       << m_args.saveMetricsPath;
+            m_headlessFailed = true;
+        }
+    }
+}
+
+void CommandLineHandler::finishHeadless()
+{
+    // Non-zero exit status lets batch scripts detect a missing or unwritten plot
+    QApplication::exit(m_headlessFailed ? 1 : 0);
+}
+
 void CommandLineHandler::headlessAutoPlot()
 {
     if (!m_mainWindow) {
@@ -308,7 +368,7 @@ void CommandLineHandler::headlessAutoPlot()
     PlotWidget *plot = m_mainWindow->getPlotWidget();
     if (!plot) {
         qCritical() << "CommandLineHandler (headless): no PlotWidget";
-        QApplication::quit();
+        QApplication::exit(1);
         return;
     }
 
@@ -329,32 +389,18 @@ void CommandLineHandler::headlessAutoPlot()
 
     // Enable box plot mode if requested
     if (m_args.boxPlotMode) {
-        PlotWidget *pw = m_mainWindow->getPlotWidget();
-        if (pw) pw->setBoxPlotMode(true);
+        plot->setBoxPlotMode(true);
     }
 
-    // Trigger plot update
+    // Trigger plot update; plotUpdated has fired by the time this returns
+    watchHeadlessPlot(plot);
     m_mainWindow->updateTimeSeriesPlot();
 
-    // After 2000 ms: export plot and/or save metrics, then quit.
-    // Axes are now fitted synchronously so 2s is sufficient for Qt to finish rendering.
-    QTimer::singleShot(2000, this, [this]() {
-        PlotWidget *plot = m_mainWindow->getPlotWidget();
-        if (plot && !m_args.savePlotPath.isEmpty()) {
-            // Render at a fixed canvas size, then export at 300 DPI (or vector PDF
-            // if the save path ends in .pdf) via the publication-quality path
-            plot->resize(1200, 800);
-            QApplication::processEvents(QEventLoop::AllEvents, 500);
-            plot->exportPlot(m_args.savePlotPath, "PNG", 300);
-        }
-        if (!m_args.saveMetricsPath.isEmpty()) {
-            if (!m_mainWindow->saveMetricsToFile(m_args.saveMetricsPath)) {
-                qWarning() << "CommandLineHandler (headless): failed to save metrics to"
-                           << m_args.saveMetricsPath;
-            }
-        }
-        QApplication::quit();
-    });
+    // Export at a fixed canvas size, 300 DPI (or vector PDF if the save path ends
+    // in .pdf). The time-series chart is rendered offscreen, so no repaint is awaited.
+    plot->resize(1200, 800);
+    writeHeadlessOutputs(plot, true);
+    finishHeadless();
 }
 
 void CommandLineHandler::headlessScatterPlot()
@@ -364,58 +410,42 @@ void CommandLineHandler::headlessScatterPlot()
     PlotWidget *plot = m_mainWindow->getScatterPlotWidget();
     if (!plot) {
         fprintf(stderr, "[SCATTER-HEADLESS] no scatter PlotWidget\n"); fflush(stderr);
-        QApplication::quit();
+        QApplication::exit(1);
         return;
     }
 
-    // Select Evaluate.OUT via the same UI path as the user would
+    // Select Evaluate.OUT via the same UI path as the user would; the file is read
+    // before selectOutputFiles() returns
     m_mainWindow->selectOutputFiles({"Evaluate.OUT"});
+    DataTable evalData = m_mainWindow->getEvaluateData();
 
-    // Wait for file to load then get evaluate data and plot
-    QTimer::singleShot(1500, this, [this]() {
-        PlotWidget *plot = m_mainWindow->getScatterPlotWidget();
-        DataTable evalData = m_mainWindow->getEvaluateData();
-
-        if (evalData.rowCount == 0) {
-            QApplication::quit();
-            return;
-        }
-
-        // Determine variables
-        QStringList vars = m_args.scatterVars;
-        if (vars.isEmpty()) {
-            QSet<QString> seen;
-            for (const QString &col : evalData.columnNames) {
-                if ((col.endsWith('S') || col.endsWith('M')) && col.length() > 1) {
-                    QString base = col.left(col.length() - 1);
-                    if (!seen.contains(base)) { seen.insert(base); vars.append(base); }
-                }
-                if (vars.size() >= 4) break;
-            }
-        }
+    if (evalData.rowCount == 0) {
+        qCritical() << "CommandLineHandler (headless): no Evaluate.OUT data";
+        QApplication::exit(1);
+        return;
+    }
 
-        // Apply metrics
-        if (!m_args.scatterMetrics.isEmpty()) {
-            PlotSettings s = plot->getPlotSettings();
-            s.scatterMetrics.clear();
-            for (const QString &m : m_args.scatterMetrics) {
-                if (m == "R2") s.scatterMetrics.insert("R\xc2\xb2");  // R²
-                else s.scatterMetrics.insert(m);
-            }
-            plot->setPlotSettings(s);
+    // Determine variables
+    QStringList vars = m_args.scatterVars;
+    if (vars.isEmpty())
+        vars = PlotWidget::defaultScatterVariables(evalData);
+
+    // Apply metrics
+    if (!m_args.scatterMetrics.isEmpty()) {
+        PlotSettings s = plot->getPlotSettings();
+        s.scatterMetrics.clear();
+        for (const QString &m : m_args.scatterMetrics) {
+            if (m == "R2") s.scatterMetrics.insert("R\xc2\xb2");  // R²
+            else s.scatterMetrics.insert(m);
         }
+        plot->setPlotSettings(s);
+    }
 
-        plot->plotScatter(evalData, vars);
+    watchHeadlessPlot(plot);
+    plot->plotScatter(evalData, vars);
 
-        // Export after render
-        QTimer::singleShot(3000, this, [this]() {
-            PlotWidget *p = m_mainWindow->getScatterPlotWidget();
-            if (p && !m_args.savePlotPath.isEmpty()) {
-                p->show();
-                QApplication::processEvents(QEventLoop::AllEvents, 500);
-                p->exportPlot(m_args.savePlotPath, "PNG");
-            }
-            QApplication::quit();
-        });
-    });
-}
\ No newline at end of file
+    // Scatter panels are grabbed from their views; exportPlot shows and lays them
+    // out itself before grabbing
+    writeHeadlessOutputs(plot, false);
+    finishHeadless();
+}
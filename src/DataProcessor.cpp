@@ -1,5 +1,6 @@
 #include "DataProcessor.h"
 #include "Config.h"
+#include "Trace.h"
 #include <QFile>
 #include <QTextStream>
 #include <QDir>
@@ -7,8 +8,236 @@
 #include <QStandardPaths>
 #include <QTime>
 #include <QRegularExpression>
+#include <QMutex>
+#include <QMutexLocker>
 #include <algorithm>
 #include <cmath>
+#include <limits>
+
+// ColumnStats implementation
+double ColumnStats::magnitude() const
+{
+    if (nonZeroCount == 0) return std::numeric_limits<double>::quiet_NaN();
+    double meanAbs = sumAbsNonZero / nonZeroCount;
+    return meanAbs > 0 ? std::floor(std::log10(meanAbs)) : std::numeric_limits<double>::quiet_NaN();
+}
+
+double ColumnStats::quantile(double p) const
+{
+    if (quantiles.isEmpty()) return std::numeric_limits<double>::quiet_NaN();
+    double pos = qBound(0.0, p, 1.0) * (quantiles.size() - 1);
+    int lo = static_cast<int>(pos);
+    int hi = qMin(lo + 1, static_cast<int>(quantiles.size()) - 1);
+    return quantiles[lo] + (pos - lo) * (quantiles[hi] - quantiles[lo]);
+}
+
+void ColumnStats::add(double value)
+{
+    if (count == 0) {
+        min = max = value;
+    } else {
+        min = qMin(min, value);
+        max = qMax(max, value);
+    }
+    ++count;
+    double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+    if (qAbs(value) > 1e-10) {
+        sumAbsNonZero += qAbs(value);
+        ++nonZeroCount;
+    }
+}
+
+void ColumnStats::merge(const ColumnStats &other)
+{
+    missingCount += other.missingCount;
+    quantiles.clear();
+    if (other.count == 0) return;
+    if (count == 0) {
+        int missing = missingCount;
+        *this = other;
+        missingCount = missing;
+        quantiles.clear();
+        return;
+    }
+    // Chan et al. pairwise combination of mean / M2
+    double n = count + other.count;
+    double delta = other.mean - mean;
+    m2 += other.m2 + delta * delta * (double(count) * other.count / n);
+    mean += delta * other.count / n;
+    count += other.count;
+    min = qMin(min, other.min);
+    max = qMax(max, other.max);
+    sumAbsNonZero += other.sumAbsNonZero;
+    nonZeroCount += other.nonZeroCount;
+}
+
+namespace {
+// Fill a quantile sketch from the (unsorted) values of one column or group
+void buildQuantileSketch(QVector<double> &values, ColumnStats &stats)
+{
+    stats.quantiles.clear();
+    if (values.isEmpty()) return;
+    std::sort(values.begin(), values.end());
+    const int n = values.size();
+    stats.quantiles.resize(ColumnStats::QUANTILE_SKETCH_SIZE);
+    for (int q = 0; q < ColumnStats::QUANTILE_SKETCH_SIZE; ++q) {
+        double pos = double(q) / (ColumnStats::QUANTILE_SKETCH_SIZE - 1) * (n - 1);
+        int lo = static_cast<int>(pos);
+        int hi = qMin(lo + 1, n - 1);
+        stats.quantiles[q] = values[lo] + (pos - lo) * (values[hi] - values[lo]);
+    }
+}
+}
+
+// DataColumn statistics cache
+const ColumnStats &DataColumn::stats(bool withQuantiles) const
+{
+    if (m_statsRows == data.size() && m_statsBuffer == data.constData()
+        && (!withQuantiles || m_statsHasQuantiles)) {
+        return m_stats;
+    }
+
+    ColumnStats result;
+    QVector<double> values;
+    if (withQuantiles) values.reserve(data.size());
+    for (const QVariant &val : data) {
+        if (DataProcessor::isMissingValue(val)) { ++result.missingCount; continue; }
+        bool ok = false;
+        double v = val.toDouble(&ok);
+        if (!ok) { ++result.missingCount; continue; }
+        result.add(v);
+        if (withQuantiles) values.append(v);
+    }
+    if (withQuantiles) buildQuantileSketch(values, result);
+
+    m_stats = result;
+    m_statsBuffer = data.constData();
+    m_statsRows = data.size();
+    m_statsHasQuantiles = withQuantiles;
+    return m_stats;
+}
+
+const QHash<QString, ColumnStats> &DataColumn::groupStats(const DataColumn &groupColumn,
+                                                          bool withQuantiles) const
+{
+    GroupStatsEntry &entry = m_groupStats[groupColumn.name];
+    if (entry.rows == data.size() && entry.groupRows == groupColumn.data.size()
+        && entry.buffer == data.constData() && entry.groupBuffer == groupColumn.data.constData()
+        && (!withQuantiles || entry.hasQuantiles)) {
+        return entry.stats;
+    }
+
+    entry.stats.clear();
+    QHash<QString, QVector<double>> values;
+    const int n = qMin(data.size(), groupColumn.data.size());
+    for (int row = 0; row < n; ++row) {
+        if (!groupColumn.data[row].isValid()) continue;
+        const QString key = groupColumn.data[row].toString();
+        ColumnStats &gs = entry.stats[key];
+        const QVariant &val = data[row];
+        if (DataProcessor::isMissingValue(val)) { ++gs.missingCount; continue; }
+        bool ok = false;
+        double v = val.toDouble(&ok);
+        if (!ok) { ++gs.missingCount; continue; }
+        gs.add(v);
+        if (withQuantiles) values[key].append(v);
+    }
+    if (withQuantiles) {
+        for (auto it = values.begin(); it != values.end(); ++it)
+            buildQuantileSketch(it.value(), entry.stats[it.key()]);
+    }
+
+    entry.buffer = data.constData();
+    entry.groupBuffer = groupColumn.data.constData();
+    entry.rows = data.size();
+    entry.groupRows = groupColumn.data.size();
+    entry.hasQuantiles = withQuantiles;
+    return entry.stats;
+}
+
+void DataColumn::invalidateStats()
+{
+    releaseCaches();
+    m_usageBuffer = nullptr;
+    m_usageRows = -1;
+}
+
+void DataColumn::releaseCaches()
+{
+    m_statsBuffer = nullptr;
+    m_statsRows = -1;
+    m_statsHasQuantiles = false;
+    m_stats = ColumnStats();
+    m_groupStats.clear();
+}
+
+// Memory accounting
+namespace {
+qint64 stringPayloadBytes(const QString &s)
+{
+    return s.capacity() > 0
+        ? qint64(sizeof(QArrayData)) + qint64(s.capacity() + 1) * qint64(sizeof(QChar))
+        : 0;
+}
+}
+
+MemoryUsage &MemoryUsage::operator+=(const MemoryUsage &other)
+{
+    buffers += other.buffers;
+    strings += other.strings;
+    caches += other.caches;
+    return *this;
+}
+
+QString MemoryUsage::format(qint64 bytes)
+{
+    const double mb = 1024.0 * 1024.0;
+    if (bytes < 1024 * 1024) return QString("%1 KB").arg((bytes + 1023) / 1024);
+    if (bytes < 1024ll * 1024 * 1024) return QString("%1 MB").arg(bytes / mb, 0, 'f', 1);
+    return QString("%1 GB").arg(bytes / (mb * 1024.0), 0, 'f', 1);
+}
+
+MemoryUsage DataColumn::memoryUsage(QSet<const void *> *seen) const
+{
+    MemoryUsage usage;
+    usage.strings += stringPayloadBytes(name) + stringPayloadBytes(dataType);
+
+    // A buffer shared with a column counted earlier (a COW copy) costs nothing extra
+    bool shared = false;
+    if (seen && data.capacity() > 0) {
+        shared = seen->contains(data.constData());
+        seen->insert(data.constData());
+    }
+    if (!shared) {
+        if (m_usageBuffer != data.constData() || m_usageRows != data.size()) {
+            m_usage = MemoryUsage();
+            m_usage.buffers = qint64(data.capacity()) * qint64(sizeof(QVariant));
+            const QChar *previous = nullptr;  // runs of cells appended from one QString share it
+            for (const QVariant &cell : data) {
+                if (cell.metaType() != QMetaType::fromType<QString>()) continue;
+                const QString *text = static_cast<const QString *>(cell.constData());
+                if (text->constData() == previous) continue;
+                previous = text->constData();
+                m_usage.strings += stringPayloadBytes(*text);
+            }
+            m_usageBuffer = data.constData();
+            m_usageRows = data.size();
+        }
+        usage += m_usage;
+    }
+
+    usage.caches += qint64(m_stats.quantiles.capacity()) * qint64(sizeof(double));
+    for (auto it = m_groupStats.cbegin(); it != m_groupStats.cend(); ++it) {
+        usage.caches += stringPayloadBytes(it.key());
+        for (auto group = it->stats.cbegin(); group != it->stats.cend(); ++group) {
+            usage.caches += qint64(sizeof(ColumnStats)) + stringPayloadBytes(group.key())
+                          + qint64(group->quantiles.capacity()) * qint64(sizeof(double));
+        }
+    }
+    return usage;
+}
 
 // DataTable implementation
 void DataTable::addColumn(const DataColumn &column)
@@ -54,6 +283,7 @@ void DataTable::setValue(int row, const QString &columnName, const QVariant &val
     DataColumn* column = getColumn(columnName);
     if (column && row >= 0 && row < column->data.size()) {
         column->data[row] = value;
+        column->invalidateStats();
     }
 }
 
@@ -126,12 +356,41 @@ void DataTable::merge(const DataTable &other)
     this->isObservedOnly = this->isObservedOnly && other.isObservedOnly;
 }
 
+MemoryUsage DataTable::memoryUsage(QSet<const void *> *seen) const
+{
+    MemoryUsage usage;
+    usage.buffers += qint64(columns.capacity()) * qint64(sizeof(DataColumn));
+    usage.strings += stringPayloadBytes(tableName);
+    for (const DataColumn &column : columns)
+        usage += column.memoryUsage(seen);
+    return usage;
+}
+
+void DataTable::releaseCaches()
+{
+    for (DataColumn &column : columns)
+        column.releaseCaches();
+}
+
+void DataTable::squeeze()
+{
+    for (DataColumn &column : columns) {
+        // squeeze() on a shared buffer would detach it, costing a full copy
+        if (column.data.isDetached() && column.data.capacity() > column.data.size())
+            column.data.squeeze();
+    }
+}
+
 QMap<QString, QPair<QString, QString>> DataProcessor::m_variableInfoCache;
 bool DataProcessor::m_variableInfoLoaded = false;
 QString DataProcessor::m_dssatBasePath = "";
 QVector<CropDetails> DataProcessor::m_cropDetailsCache;
 bool DataProcessor::m_cropDetailsCached = false;
 
+// Guards m_dssatBasePath and the crop details cache: folder discovery and batch loads
+// fill them on pool threads while the GUI thread may be loading files
+static QMutex s_installCacheMutex;
+
 // DataProcessor implementation
 DataProcessor::DataProcessor(QObject *parent)
     : QObject(parent)
@@ -140,6 +399,7 @@ DataProcessor::DataProcessor(QObject *parent)
 
 bool DataProcessor::readFile(const QString &filePath, DataTable &table)
 {
+    GB2_TRACE_SCOPE_ARG("readFile", QFileInfo(filePath).fileName());
     if (!QFile::exists(filePath)) {
         emit errorOccurred(QString("File does not exist: %1").arg(filePath));
         return false;
@@ -182,6 +442,7 @@ bool DataProcessor::readOutFile(const QString &filePath, DataTable &table)
         // Try UTF-8 first, fallback to Latin-1 if needed
         in.setEncoding(QStringConverter::Utf8);
         
+        Trace::Scope readScope("read lines");
         QStringList lines;
         int lineCount = 0;
         while (!in.atEnd()) {
@@ -205,6 +466,7 @@ bool DataProcessor::readOutFile(const QString &filePath, DataTable &table)
         file.close();
     }
     
+        readScope.finish();
         if (lines.isEmpty()) {
             emit errorOccurred(QString("Cannot read file or file is empty: %1").arg(filePath));
             return false;
@@ -220,6 +482,7 @@ bool DataProcessor::readOutFile(const QString &filePath, DataTable &table)
         QMap<QString, QString> trtToTname;
         
         QVector<DataTable> allTables;
+        Trace::Scope tokenizeScope("tokenize");
     
     for (int i = 0; i < lines.size(); ++i) {
         QString line = lines[i].trimmed();
@@ -355,6 +618,7 @@ bool DataProcessor::readOutFile(const QString &filePath, DataTable &table)
             i = j - 1;
         }
     }
+    tokenizeScope.finish();
     
     if (allTables.isEmpty()) {
         emit errorOccurred("No valid data tables found in file");
@@ -364,9 +628,12 @@ bool DataProcessor::readOutFile(const QString &filePath, DataTable &table)
     // Combine all tables while preserving all columns from every section
     // Use DataTable::merge so that columns unique to later sections are kept
     table.clear();
-    for (const DataTable &sectionTable : allTables) {
-        if (sectionTable.rowCount > 0) {
-            table.merge(sectionTable);
+    {
+        GB2_TRACE_SCOPE("merge sections");
+        for (const DataTable &sectionTable : allTables) {
+            if (sectionTable.rowCount > 0) {
+                table.merge(sectionTable);
+            }
         }
     }
     
@@ -460,6 +727,7 @@ bool DataProcessor::readOutFile(const QString &filePath, DataTable &table)
                         rawDate->data[r] = dt.isValid() ? dt.toString("yyyy-MM-dd") : QVariant();
                     }
                 }
+                rawDate->invalidateStats();
             }
         }
     }
@@ -597,6 +865,7 @@ bool DataProcessor::readCsvFile(const QString &filePath, DataTable &table)
                 if (s.length() > 8)
                     val = QVariant(s.left(8));
             }
+            expCol->invalidateStats();
         }
     }
 
@@ -1096,6 +1365,192 @@ static QString getDirectoryFromDssatProByThreeLetterCode(const QString &threeLet
     return QString();
 }
 
+void DataProcessor::loadOutputFiles(const QString &folderName,
+                                    const QVector<QPair<QString, QString>> &files,
+                                    OutputFileSet &out)
+{
+    GB2_TRACE_SCOPE_ARG("loadOutputFiles", QString("%1 (%2 files)").arg(folderName).arg(files.size()));
+    out = OutputFileSet();
+    QString firstValidFile;
+    QString firstValidRegularFile;  // For observed data lookup
+    qint64 loadedBytes = m_residentBytes;  // resident data + files accepted so far
+
+    for (const auto &file : files) {
+        const QString &selectedFile = file.first;
+        const QString &filePath = file.second;
+
+        // Check if THIS specific file is EVALUATE.OUT or evaluate.csv
+        bool isEvaluateFile = selectedFile.toUpper().contains("EVALUATE");
+        if (isEvaluateFile) {
+            out.hasEvaluateFile = true;
+        } else {
+            out.hasRegularFile = true;
+            if (firstValidRegularFile.isEmpty()) {
+                firstValidRegularFile = filePath;
+            }
+        }
+
+        // Refuse a file that would take the set past the budget rather than let the
+        // machine swap; files read earlier in the set stay loaded
+        if (m_memoryBudget > 0) {
+            const qint64 estimate = estimatedLoadBytes(filePath);
+            if (loadedBytes + estimate > m_memoryBudget) {
+                out.refusedPaths << filePath;
+                emit errorOccurred(QString("Not loading %1: it needs about %2 in memory, which "
+                                           "would exceed the %3 memory budget")
+                                       .arg(selectedFile, MemoryUsage::format(estimate),
+                                            MemoryUsage::format(m_memoryBudget)));
+                continue;
+            }
+            loadedBytes += estimate;
+        }
+
+        // readFile dispatches .OUT to readEvaluateFile and .csv to readCsvFile
+        DataTable fileData;
+        if (!readFile(filePath, fileData)) continue;
+
+        out.loadedPaths << filePath;
+        if (firstValidFile.isEmpty()) {
+            firstValidFile = filePath;
+        }
+
+        // Store data in appropriate location based on file type
+        GB2_TRACE_SCOPE("merge");
+        if (isEvaluateFile) {
+            // Store EVALUATE.OUT data separately for scatter plots
+            if (out.evaluateData.rowCount == 0) {
+                out.evaluateData = fileData;
+            } else {
+                out.evaluateData.merge(fileData);
+            }
+        } else {
+            // Store regular .OUT data for time series plots
+            out.fileColumns[selectedFile] = fileData.columnNames;
+            // Stamp each row with the source filename so plotDatasets can filter by file
+            DataColumn srcCol("__SRCFILE__");
+            for (int i = 0; i < fileData.rowCount; ++i)
+                srcCol.data.append(selectedFile);
+            fileData.addColumn(srcCol);
+            if (out.simData.rowCount == 0) {
+                out.simData = fileData;
+            } else {
+                out.simData.merge(fileData);
+            }
+        }
+
+        // Extract experiment codes and treatment names from this file (only for regular files)
+        if (!isEvaluateFile && fileData.columnNames.contains("TRT") && fileData.columnNames.contains("TNAME")) {
+            const DataColumn* expCol = fileData.getColumn("EXPERIMENT");
+            const DataColumn* trtCol = fileData.getColumn("TRT");
+            const DataColumn* tnameCol = fileData.getColumn("TNAME");
+
+            if (trtCol && tnameCol) {
+                for (int i = 0; i < fileData.rowCount; ++i) {
+                    QString expCode = expCol ? expCol->data[i].toString().trimmed() : QString();
+                    QString trtCode = trtCol->data[i].toString().trimmed();
+                    QString tname = tnameCol->data[i].toString().trimmed();
+
+                    if (!expCode.isEmpty() && expCode != "DEFAULT") {
+                        out.experimentCodes.insert(expCode);
+                    }
+                    if (!trtCode.isEmpty() && !tname.isEmpty()) {
+                        // T files have no EXPERIMENT column; store under "default" so
+                        // getTreatmentDisplayName's fallback can find them.
+                        QString key = expCode.isEmpty() ? "default" : expCode;
+                        out.treatmentNames[key][trtCode] = tname;
+                    }
+                }
+            }
+        }
+    }
+
+    // merge() grows columns row by row; give the slack back once the set is complete
+    out.evaluateData.squeeze();
+
+    // Process regular .OUT files (for time series plots)
+    if (out.simData.rowCount == 0) return;
+
+    // Determine crop code
+    QString cropCode = "XX";
+
+    // Special handling for SensWork - extract crop code from the file itself
+    if (folderName.compare("SensWork", Qt::CaseInsensitive) == 0 && !firstValidFile.isEmpty()) {
+        QPair<QString, QString> sensWorkCodes = extractSensWorkCodes(firstValidFile);
+        if (!sensWorkCodes.second.isEmpty()) {
+            cropCode = sensWorkCodes.second.toUpper();
+        }
+    } else {
+        // Regular crop folder - try to get crop code from the selected folder name by matching with crop details
+        QVector<CropDetails> allCropDetails = getCropDetails();
+        QString selectedFolderLower = folderName.toLower();
+
+        // Two-pass: exact matches first, then partial (to avoid "Pea" matching before "Peanut")
+        QString partialCode;
+        for (const CropDetails& crop : allCropDetails) {
+            QString dirName = QFileInfo(crop.directory).fileName().toLower();
+            QString cropNameLower = crop.cropName.toLower();
+
+            bool dirNameMatch = (dirName == selectedFolderLower);
+            bool cropNameMatch = (cropNameLower == selectedFolderLower);
+            bool pathContainsFolder = crop.directory.toLower().contains("/" + selectedFolderLower) ||
+                                     crop.directory.toLower().contains("\\" + selectedFolderLower);
+
+            if (dirNameMatch || cropNameMatch || pathContainsFolder) {
+                cropCode = crop.cropCode.toUpper();
+                break;
+            }
+
+            // Partial match: only keep first candidate, don't break
+            if (partialCode.isEmpty()) {
+                bool cropNameContains = cropNameLower.contains(selectedFolderLower) ||
+                                       selectedFolderLower.contains(cropNameLower);
+                if (cropNameContains)
+                    partialCode = crop.cropCode.toUpper();
+            }
+        }
+
+        // Fall back to partial match only if no exact match found
+        if (cropCode == "XX" && !partialCode.isEmpty())
+            cropCode = partialCode;
+    }
+
+    // Add CROP column to simulated data if it doesn't exist
+    if (!out.simData.columnNames.contains("CROP")) {
+        DataColumn cropCol("CROP");
+        for (int r = 0; r < out.simData.rowCount; ++r) {
+            cropCol.data.append(cropCode);
+        }
+        out.simData.addColumn(cropCol);
+    }
+
+    // Attempt to load and merge observed data for each unique experiment code (only for regular files)
+    if (folderName.compare("SensWork", Qt::CaseInsensitive) == 0) {
+        // For SensWork, use the dynamic observed data lookup
+        if (!firstValidRegularFile.isEmpty()) {
+            DataTable sensWorkObsData;
+            if (readSensWorkObservedData(firstValidRegularFile, sensWorkObsData)) {
+                out.obsData.merge(sensWorkObsData);
+            }
+        }
+    } else {
+        // Regular crop folder - use the first valid regular file path for observed data lookup
+        for (const QString& expCode : out.experimentCodes) {
+            GB2_TRACE_SCOPE_ARG("readObservedData", expCode);
+            DataTable tempObsData;
+            if (!firstValidRegularFile.isEmpty() && readObservedData(firstValidRegularFile, expCode, cropCode, tempObsData)) {
+                out.obsData.merge(tempObsData);
+            }
+        }
+    }
+
+    // Add DAS/DAP columns to observed data if it exists
+    if (out.obsData.rowCount > 0) {
+        addDasDapColumns(out.obsData, out.simData);
+    }
+    out.simData.squeeze();
+    out.obsData.squeeze();
+}
+
 bool DataProcessor::readObservedData(const QString &simulatedFilePath, const QString &experimentCode, const QString &cropCode, DataTable &table)
 {
     table.clear(); // Clear the table before populating
@@ -1175,6 +1630,7 @@ bool DataProcessor::readObservedData(const QString &simulatedFilePath, const QSt
 
 void DataProcessor::standardizeDataTypes(DataTable &table)
 {
+    GB2_TRACE_SCOPE_ARG("type inference", table.tableName);
     for (auto &column : table.columns) {
         if (column.dataType == "numeric") {
             processNumericColumn(column);
@@ -1241,6 +1697,7 @@ bool DataProcessor::handleMissingValues(DataTable &table, const QString &xVariab
             }
         }
         column.data = newData;
+        column.invalidateStats();
     }
     
     table.rowCount = validRows.size();
@@ -1258,24 +1715,29 @@ void DataProcessor::convertDates(DataTable &table)
 
 QString DataProcessor::getDSSATBase()
 {
+    auto remember = [](const QString &path) {
+        QMutexLocker lock(&s_installCacheMutex);
+        DataProcessor::m_dssatBasePath = path;
+    };
+
     // Check environment variable override first
     QString envPath = qgetenv("DSSAT_PATH");
     if (!envPath.isEmpty() && QDir(envPath).exists()) {
-        DataProcessor::m_dssatBasePath = envPath;
+        remember(envPath);
         return envPath;
     }
     
     // Use Config.h base path
     QString basePath = Config::DSSAT_BASE;
     if (QDir(basePath).exists()) {
-        DataProcessor::m_dssatBasePath = basePath;
+        remember(basePath);
         return basePath;
     }
     
     // Try other search paths from Config.h
     for (const QString& searchPath : Config::DSSAT_SEARCH_PATHS) {
         if (QDir(searchPath).exists()) {
-            DataProcessor::m_dssatBasePath = searchPath;
+            remember(searchPath);
             return searchPath;
         }
     }
@@ -1675,8 +2137,10 @@ void DataProcessor::parseDataCDE()
 QVector<CropDetails> DataProcessor::getCropDetails()
 {
     // Return cached results if available
-    if (m_cropDetailsCached && !m_cropDetailsCache.isEmpty()) {
-        return m_cropDetailsCache;
+    {
+        QMutexLocker lock(&s_installCacheMutex);
+        if (m_cropDetailsCached && !m_cropDetailsCache.isEmpty())
+            return m_cropDetailsCache;
     }
 
 
@@ -1846,6 +2310,7 @@ QVector<CropDetails> DataProcessor::getCropDetails()
     }
 
     // Cache the results
+    QMutexLocker lock(&s_installCacheMutex);
     m_cropDetailsCache = cropDetails;
     m_cropDetailsCached = true;
 
@@ -2045,8 +2510,10 @@ QPair<QString, QString> DataProcessor::getVariableInfo(const QString &variableNa
         parseDataCDE();
     }
 
-    if (m_variableInfoCache.contains(variableName)) {
-        return qMakePair(m_variableInfoCache[variableName].first, m_variableInfoCache[variableName].second);
+    // Read-only lookup: safe to call from worker threads once DATA.CDE is loaded
+    auto it = m_variableInfoCache.constFind(variableName);
+    if (it != m_variableInfoCache.constEnd()) {
+        return it.value();
     }
     return qMakePair(QString(), QString());
 }
@@ -2147,8 +2614,18 @@ QString DataProcessor::detectDataType(const QVector<QVariant> &data)
     }
 }
 
+// Parsed cells are 32-byte QVariants, plus a QString payload for text columns, for
+// typically 6-8 bytes of fixed-width text
+static const qint64 LOAD_BYTES_PER_FILE_BYTE = 6;
+
+qint64 DataProcessor::estimatedLoadBytes(const QString &filePath)
+{
+    return QFileInfo(filePath).size() * LOAD_BYTES_PER_FILE_BYTE;
+}
+
 void DataProcessor::setDSSATBasePath(const QString &path)
 {
+    QMutexLocker lock(&s_installCacheMutex);
     m_dssatBasePath = path;
 }
 
@@ -2286,6 +2763,7 @@ void DataProcessor::processNumericColumn(DataColumn &column)
             value = QVariant();
         }
     }
+    column.invalidateStats();
 }
 
 void DataProcessor::processCategoricalColumn(DataColumn &column)
@@ -2298,6 +2776,7 @@ void DataProcessor::processCategoricalColumn(DataColumn &column)
             value = value.toString();
         }
     }
+    column.invalidateStats();
 }
 
 void DataProcessor::processDateColumn(DataColumn &column)
@@ -2315,6 +2794,7 @@ void DataProcessor::processDateColumn(DataColumn &column)
             value = QVariant();
         }
     }
+    column.invalidateStats();
 }
 
 
@@ -2480,6 +2960,7 @@ bool DataProcessor::readTFile(const QString &filePath, DataTable &table)
                     dateCol->data[r] = QVariant();
                 }
             }
+            dateCol->invalidateStats();
         }
     }
 
@@ -2559,6 +3040,7 @@ DataTable DataProcessor::filterData(const DataTable &data, const QString &column
 
 void DataProcessor::addDasDapColumns(DataTable &observedData, const DataTable &simulatedData)
 {
+    GB2_TRACE_SCOPE("DAS/DAP join");
     
     // Check if required columns exist
     if (!observedData.columnNames.contains("DATE") || !simulatedData.columnNames.contains("DATE")) {
@@ -2702,6 +3184,114 @@ void DataProcessor::addDasDapColumns(DataTable &observedData, const DataTable &s
     
 }
 
+QVector<ObsSimGroup> DataProcessor::matchObsSim(const DataTable &simData, const DataTable &obsData,
+                                                const QString &variable)
+{
+    QVector<ObsSimGroup> groups;
+
+    const DataColumn *simYColumn = simData.getColumn(variable);
+    const DataColumn *obsYColumn = obsData.getColumn(variable);
+    const DataColumn *simTrtColumn = simData.getColumn("TRT");
+    const DataColumn *obsTrtColumn = obsData.getColumn("TRT");
+    const DataColumn *simDateColumn = simData.getColumn("DATE");
+    const DataColumn *obsDateColumn = obsData.getColumn("DATE");
+    if (!simYColumn || !obsYColumn || !simTrtColumn || !obsTrtColumn || !simDateColumn || !obsDateColumn) {
+        return groups;
+    }
+    const DataColumn *simExpColumn = simData.getColumn("EXPERIMENT");
+    const DataColumn *obsExpColumn = obsData.getColumn("EXPERIMENT");
+    const DataColumn *simCropColumn = simData.getColumn("CROP");
+    const DataColumn *obsCropColumn = obsData.getColumn("CROP");
+    const DataColumn *simRunColumn = simData.getColumn("RUN");
+
+    auto cell = [](const DataColumn *column, int row) {
+        return column && row < column->data.size() ? column->data[row].toString() : QString();
+    };
+    // treatment_experiment_crop_date; sequences (SQ) match on experiment and date only
+    auto createMatchKey = [](const QString &trt, const QString &exp, const QString &crop, const QString &date) {
+        if (crop == "SQ") {
+            return QString("SQ_ALL_%1_%2").arg(exp, date);
+        }
+        return QString("%1_%2_%3_%4").arg(trt, exp, crop, date);
+    };
+
+    // match key -> (runId -> sim value); runId is empty without a RUN column
+    QHash<QString, QMap<QString, double>> simByKey;
+    // For sequences, the simulated TRT behind each match key
+    QHash<QString, QString> matchKeyToSimTrt;
+    for (int row = 0; row < simData.rowCount; ++row) {
+        if (row >= simYColumn->data.size() || row >= simTrtColumn->data.size() || row >= simDateColumn->data.size()) continue;
+        const QVariant &yVal = simYColumn->data[row];
+        if (isMissingValue(yVal)) continue;
+
+        const QString trt = simTrtColumn->data[row].toString();
+        const QString crop = cell(simCropColumn, row);
+        const QString key = createMatchKey(trt, cell(simExpColumn, row), crop, simDateColumn->data[row].toString());
+        QString runId;
+        const QString rv = cell(simRunColumn, row);
+        if (!rv.isEmpty()) runId = QString("RUN%1").arg(rv);
+        simByKey[key][runId] = yVal.toDouble();
+        if (crop == "SQ") matchKeyToSimTrt[key] = trt;
+    }
+    if (simByKey.isEmpty()) return groups;
+
+    // Group key (trt_variable_exp_crop[_run]) -> index into groups; QMap keeps the
+    // output in group-key order
+    QMap<QString, int> groupIndex;
+    QHash<QString, QSet<QString>> baseGroupRuns;
+    for (int row = 0; row < obsData.rowCount; ++row) {
+        if (row >= obsYColumn->data.size() || row >= obsTrtColumn->data.size() || row >= obsDateColumn->data.size()) continue;
+        const QVariant &obsVal = obsYColumn->data[row];
+        if (isMissingValue(obsVal)) continue;
+
+        const QString obsTrt = obsTrtColumn->data[row].toString();
+        const QString date = obsDateColumn->data[row].toString();
+        const QString exp = cell(obsExpColumn, row);
+        const QString crop = cell(obsCropColumn, row);
+        const QString matchKey = createMatchKey(obsTrt, exp, crop, date);
+        auto simIt = simByKey.constFind(matchKey);
+        if (simIt == simByKey.constEnd()) continue;
+
+        // Sequences observe TRT 1; report under the simulated treatment instead
+        const QString trt = crop == "SQ" ? matchKeyToSimTrt.value(matchKey, obsTrt) : obsTrt;
+        const QString baseGroupKey = QString("%1_%2_%3_%4").arg(trt, variable, exp, crop);
+
+        // Dates become ms since epoch (the time-series x axis); DAS/DAP stay numeric
+        const QDateTime dt = QDateTime::fromString(date, "yyyy-MM-dd");
+        const double xVal = dt.isValid() ? static_cast<double>(dt.toMSecsSinceEpoch()) : date.toDouble();
+
+        for (auto runIt = simIt->constBegin(); runIt != simIt->constEnd(); ++runIt) {
+            const QString &runId = runIt.key();
+            const QString groupKey = runId.isEmpty() ? baseGroupKey : QString("%1_%2").arg(baseGroupKey, runId);
+            auto idx = groupIndex.constFind(groupKey);
+            if (idx == groupIndex.constEnd()) {
+                ObsSimGroup group;
+                group.treatment = trt;
+                group.experiment = exp;
+                group.crop = crop;
+                group.runId = runId;
+                groups.append(group);
+                idx = groupIndex.insert(groupKey, groups.size() - 1);
+            }
+            ObsSimGroup &group = groups[idx.value()];
+            group.x.append(xVal);
+            group.obs.append(obsVal.toDouble());
+            group.sim.append(runIt.value());
+            baseGroupRuns[baseGroupKey].insert(runId);
+        }
+    }
+
+    QVector<ObsSimGroup> ordered;
+    ordered.reserve(groups.size());
+    for (int idx : std::as_const(groupIndex)) {
+        ObsSimGroup &group = groups[idx];
+        const QString baseGroupKey = QString("%1_%2_%3_%4").arg(group.treatment, variable, group.experiment, group.crop);
+        group.multiRun = baseGroupRuns.value(baseGroupKey).size() > 1;
+        ordered.append(std::move(group));
+    }
+    return ordered;
+}
+
 QString DataProcessor::findOutfileCde()
 {
     QString dssatBase = getDSSATBase();
@@ -7,6 +7,7 @@ DataTableWidget::DataTableWidget(QWidget* parent)
     , m_mainLayout(nullptr)
     , m_controlsLayout(nullptr)
     , m_exportButton(nullptr)
+    , m_memoryLabel(nullptr)
     , m_filterGroup(nullptr)
     , m_filterColumn(nullptr)
     , m_filterValue(nullptr)
@@ -53,6 +54,10 @@ void DataTableWidget::setupUI()
     filterLayout->addWidget(m_clearFilterButton);
     
     m_controlsLayout->addWidget(m_filterGroup);
+
+    m_memoryLabel = new QLabel();
+    m_memoryLabel->setStyleSheet("color: #666666;");
+    m_controlsLayout->addWidget(m_memoryLabel);
     
     // Add controls to main layout
     m_mainLayout->addLayout(m_controlsLayout);
@@ -144,6 +149,37 @@ void DataTableWidget::setData(const DataTable& simData, const DataTable& obsData
     onTabChanged(m_tabWidget->currentIndex());
 }
 
+MemoryUsage DataTableWidget::memoryUsage(QSet<const void *> *seen) const
+{
+    MemoryUsage usage;
+    for (const DataTable *table : { &m_simData, &m_filteredSimData, &m_obsData, &m_filteredObsData })
+        usage += table->memoryUsage(seen);
+    for (const PandasTableModel *model : { m_simModel, m_obsModel }) {
+        if (model) usage += model->getData().memoryUsage(seen);
+    }
+    return usage;
+}
+
+void DataTableWidget::updateMemoryLabel()
+{
+    const int currentTab = m_tabWidget->currentIndex();
+    const PandasTableModel *model = (currentTab == 0) ? m_simModel : m_obsModel;
+    if (!model) {
+        m_memoryLabel->clear();
+        m_memoryLabel->setToolTip(QString());
+        return;
+    }
+
+    const DataTable &shown = model->getData();
+    const MemoryUsage usage = shown.memoryUsage();
+    m_memoryLabel->setText(QString("Memory: %1").arg(MemoryUsage::format(usage.total())));
+    m_memoryLabel->setToolTip(QString("%1 rows × %2 columns\nBuffers: %3\nStrings: %4\nCaches: %5\n"
+                                      "Hover a column header for its share")
+                                  .arg(shown.rowCount).arg(shown.columnNames.size())
+                                  .arg(MemoryUsage::format(usage.buffers), MemoryUsage::format(usage.strings),
+                                       MemoryUsage::format(usage.caches)));
+}
+
 void DataTableWidget::setTabsVisible(bool visible)
 {
     if (m_tabWidget)
@@ -171,6 +207,7 @@ void DataTableWidget::clear()
     
     m_filterColumn->clear();
     m_filterValue->clear();
+    updateMemoryLabel();
 }
 
 void DataTableWidget::exportData()
@@ -261,6 +298,7 @@ void DataTableWidget::applyFilter()
             m_obsModel->setData(m_filteredObsData);
         }
     }
+    updateMemoryLabel();
 }
 
 void DataTableWidget::clearFilter()
@@ -280,6 +318,7 @@ void DataTableWidget::clearFilter()
     }
     
     m_filterValue->clear();
+    updateMemoryLabel();
 }
 
 void DataTableWidget::updateFilterValues()
@@ -316,6 +355,7 @@ void DataTableWidget::updateFilterValues()
 void DataTableWidget::onTabChanged(int index)
 {
     updateFilterColumns();
+    updateMemoryLabel();
 }
 
 DataTable DataTableWidget::removeEmptyColumns(const DataTable& data)
@@ -1,8 +1,12 @@
 #include "MainWindow.h"
 #include "DataTableWidget.h"
 #include "PlotWidget.h"
+#include "MetricsCalculator.h"
 #include "CDECodesDialog.h"
+#include "Trace.h"
 #include <QApplication>
+#include <QPointer>
+#include <QThreadPool>
 #include <QSettings>
 #include <QClipboard>
 #include <QMessageBox>
@@ -140,23 +144,31 @@ MainWindow::MainWindow(QWidget *parent)
         "QPushButton:hover { background-color: #3D8BC7; }"
         "QPushButton:disabled { background-color: #C9D6DF; color: #6c757d; }"
     );
+    Trace::mark("window stylesheet");
     
     setupUI();
+    Trace::mark("setupUI");
     connectSignals();
     centerWindow();
     resetInterface();
+    Trace::mark("signals + reset");
+
+    // First paint closes the startup trace (in GUI mode the folder list follows)
+    if (Trace::summaryPending())
+        installEventFilter(this);
 
     // Show window first so it appears instantly
     setAttribute(Qt::WA_ShowWithoutActivating, false);
     setVisible(true);
     raise();
     activateWindow();
+    Trace::mark("window shown");
 
     // In CLI mode, skip populateFolders — the CLI handler calls selectCropFolder()
     // which adds only the target crop on demand, avoiding a full scan of all crops.
-    // In GUI mode, defer until after the window has painted.
+    // In GUI mode, the DSSAT install is located off the GUI thread behind a placeholder.
     if (QApplication::arguments().size() < 2)
-        QTimer::singleShot(0, this, &MainWindow::populateFolders);
+        populateFoldersAsync();
 }
 
 MainWindow::~MainWindow()
@@ -256,7 +268,9 @@ void MainWindow::setupMainWidget()
     mainLayout->addWidget(m_mainSplitter);
     
     setupControlPanel();
+    Trace::mark("control panel");
     setupDataPanel();
+    Trace::mark("data panel");
     
     // Set splitter proportions
     m_mainSplitter->setSizes({200, 800});
@@ -516,25 +530,75 @@ void MainWindow::setupDataPanel()
     }
     dataLayout->addWidget(m_dataInfoLabel);
     
-    m_dataTableWidget = new DataTableWidget();
-    dataLayout->addWidget(m_dataTableWidget);
+    // The table itself is built when the tab is first shown (ensureDataTableWidget)
+    m_dataTabLayout = dataLayout;
     
     m_tabWidget->addTab(dataWidget, "Data View");
     
-    // Scatter Plot Tab
+    // Scatter Plot Tab — PlotWidget built on first use (ensureScatterPlotWidget)
     QWidget *scatterPlotWidget = new QWidget();
-    QVBoxLayout *scatterPlotLayout = new QVBoxLayout(scatterPlotWidget);
+    m_scatterTabLayout = new QVBoxLayout(scatterPlotWidget);
+    
+    m_tabWidget->addTab(scatterPlotWidget, "Scatter Plot");
+
+    // Statistics Tab (index 3) — contents built on first activation (ensureStatisticsTab)
+    m_statsTab = new QWidget();
+    m_tabWidget->addTab(m_statsTab, "Statistics");
+
+    // Wrap tab widget + status widget in a container so status only spans plot area
+    QWidget *dataPanel = new QWidget();
+    QVBoxLayout *dataPanelLayout = new QVBoxLayout(dataPanel);
+    dataPanelLayout->setContentsMargins(0, 0, 0, 0);
+    dataPanelLayout->setSpacing(0);
+    dataPanelLayout->addWidget(m_tabWidget, 1);
+
+    m_statusWidget = new StatusWidget(this);
+    // Place scaling label in the right half of the status bar
+    if (m_plotWidget)
+        m_statusWidget->setRightWidget(m_plotWidget->scalingLabel());
+    m_statusWidget->setMemoryUsage(MemoryUsage(), memoryBudgetBytes());
+    // Embed inside PlotWidget's left layout so the status bar ends at the plot edge, not under the legend
+    if (m_plotWidget)
+        m_plotWidget->setBottomStatusWidget(m_statusWidget);
+
+    m_mainSplitter->addWidget(dataPanel);
     
+    // Connect tab changed signal
+    connect(m_tabWidget, &QTabWidget::currentChanged, this, &MainWindow::onTabChanged);
+}
+
+PlotWidget *MainWindow::ensureScatterPlotWidget()
+{
+    if (m_scatterPlotWidget || !m_scatterTabLayout) return m_scatterPlotWidget;
+
     // Use PlotWidget for scatter plots (same widget, different mode)
     m_scatterPlotWidget = new PlotWidget();
     m_scatterPlotWidget->setPreplotPanelVisible(false);
-    scatterPlotLayout->addWidget(m_scatterPlotWidget);
-    
-    m_tabWidget->addTab(scatterPlotWidget, "Scatter Plot");
+    m_scatterPlotWidget->setXAxisButtonsVisible(false);
+    m_scatterTabLayout->addWidget(m_scatterPlotWidget);
+
+    connect(m_scatterPlotWidget, SIGNAL(metricsCalculated(const QVector<QMap<QString,QVariant>>&)),
+            this, SLOT(updateScatterMetrics(const QVector<QMap<QString,QVariant>>&)));
+    connect(m_scatterPlotWidget, &PlotWidget::refreshFilesRequested, this, &MainWindow::onRefreshFiles);
+    return m_scatterPlotWidget;
+}
 
-    // Statistics Tab (index 3)
-    QWidget *statsWidget = new QWidget();
-    QVBoxLayout *statsLayout = new QVBoxLayout(statsWidget);
+DataTableWidget *MainWindow::ensureDataTableWidget()
+{
+    if (m_dataTableWidget || !m_dataTabLayout) return m_dataTableWidget;
+
+    m_dataTableWidget = new DataTableWidget();
+    m_dataTabLayout->addWidget(m_dataTableWidget);
+    // Whatever is loaded already has never been shown
+    m_dataNeedsRefresh = true;
+    return m_dataTableWidget;
+}
+
+void MainWindow::ensureStatisticsTab()
+{
+    if (m_statsTSWidget || !m_statsTab) return;
+
+    QVBoxLayout *statsLayout = new QVBoxLayout(m_statsTab);
     statsLayout->setContentsMargins(8, 8, 8, 8);
     statsLayout->setSpacing(8);
 
@@ -570,27 +634,7 @@ void MainWindow::setupDataPanel()
     m_statsScatterWidget = new MetricsTableWidget();
     statsLayout->addWidget(m_statsScatterWidget);
 
-    m_tabWidget->addTab(statsWidget, "Statistics");
-
-    // Wrap tab widget + status widget in a container so status only spans plot area
-    QWidget *dataPanel = new QWidget();
-    QVBoxLayout *dataPanelLayout = new QVBoxLayout(dataPanel);
-    dataPanelLayout->setContentsMargins(0, 0, 0, 0);
-    dataPanelLayout->setSpacing(0);
-    dataPanelLayout->addWidget(m_tabWidget, 1);
-
-    m_statusWidget = new StatusWidget(this);
-    // Place scaling label in the right half of the status bar
-    if (m_plotWidget)
-        m_statusWidget->setRightWidget(m_plotWidget->scalingLabel());
-    // Embed inside PlotWidget's left layout so the status bar ends at the plot edge, not under the legend
-    if (m_plotWidget)
-        m_plotWidget->setBottomStatusWidget(m_statusWidget);
-
-    m_mainSplitter->addWidget(dataPanel);
-    
-    // Connect tab changed signal
-    connect(m_tabWidget, &QTabWidget::currentChanged, this, &MainWindow::onTabChanged);
+    updateStatisticsTab();
 }
 
 // Remove setupPlotPanel - integrated into setupDataPanel
@@ -638,11 +682,6 @@ void MainWindow::connectSignals()
                 this, SLOT(updateTimeSeriesMetrics(const QVector<QMap<QString,QVariant>>&)));
     }
 
-    if (m_scatterPlotWidget) {
-        connect(m_scatterPlotWidget, SIGNAL(metricsCalculated(const QVector<QMap<QString,QVariant>>&)),
-                this, SLOT(updateScatterMetrics(const QVector<QMap<QString,QVariant>>&)));
-    }
-    
     if (m_tabWidget) {
         connect(m_tabWidget, &QTabWidget::currentChanged, this, &MainWindow::onTabChanged);
     }
@@ -680,9 +719,6 @@ void MainWindow::connectSignals()
     if (m_plotWidget) {
         connect(m_plotWidget, &PlotWidget::refreshFilesRequested, this, &MainWindow::onRefreshFiles);
     }
-    if (m_scatterPlotWidget) {
-        connect(m_scatterPlotWidget, &PlotWidget::refreshFilesRequested, this, &MainWindow::onRefreshFiles);
-    }
 
     // Connect Y variable search
     if (m_yVarSearch) {
@@ -1184,6 +1220,10 @@ void MainWindow::onUserManual()
   <tr><td><code>--scatter</code></td><td>—</td><td>Headless scatter plot mode (requires EVALUATE.OUT)</td></tr>
   <tr><td><code>--scatter-vars</code></td><td><code>VAR1,VAR2</code></td><td>Limit scatter panels to these variables</td></tr>
   <tr><td><code>--scatter-metrics</code></td><td><code>RMSE,R2</code></td><td>Override which statistics appear in scatter panels</td></tr>
+  <tr><td><code>--batch</code></td><td><code>jobs.json</code></td><td>Run every plot/metrics job in a JSON manifest in one process, then print a per-job summary</td></tr>
+  <tr><td><code>--serve</code></td><td><code>[name]</code></td><td>Stay resident and answer table, metrics and plot requests on the local socket <code>name</code> (default <code>gb2-server</code>), keeping parsed files cached between requests</td></tr>
+  <tr><td><code>--startup-trace</code></td><td></td><td>Print how long each start-up phase took (window setup, first paint, crop folder discovery) to the console</td></tr>
+  <tr><td><code>--trace</code></td><td><code>file.json</code></td><td>Record file reading, parsing, metrics, plotting and export timings as a Chrome/Perfetto trace (open in <code>ui.perfetto.dev</code>). <code>GB2_TRACE=file.json</code> does the same</td></tr>
   <tr><td><code>-v</code></td><td>—</td><td>Verbose debug output to console</td></tr>
 </table>
 
@@ -1209,6 +1249,18 @@ GB2.exe C:/DSSAT48 C:/DSSAT48/Wheat KSAS8101.WHT --xvar DATE --yvar GWAD
 
 # Headless save of a T file plot
 GB2.exe C:/DSSAT48 C:/DSSAT48/Wheat KSAS8101.WHT --xvar DATE --yvar GWAD --save tfile.png
+
+# Many plots in one process; jobs reading the same files share one parse
+GB2.exe --batch jobs.json
+#   { "threads": 4, "summary": "summary.json", "jobs": [
+#     { "name": "laid", "cropDir": "C:/DSSAT48/Maize", "files": ["PlantGro.OUT"],
+#       "xvar": "DATE", "yvars": ["LAID"], "treatments": ["1","2"],
+#       "plotType": "timeseries", "output": "laid.png", "metrics": "laid.csv" } ] }
+
+# Resident server for calibration loops: one JSON request per line on the local
+# socket, each answered by a JSON header line and "size" bytes of CSV/JSON/PNG
+GB2.exe --serve gb2-server
+#   {"cmd": "metrics", "cropDir": "C:/DSSAT48/Maize", "files": ["PlantGro.OUT"], "format": "csv"}
 </pre>
 
 <p><b>Note:</b> When <code>--save</code> is used, GB2 renders the plot and exits automatically. Relative output paths are resolved against the terminal's working directory at the time GB2 was launched.</p>
@@ -1384,6 +1436,7 @@ void MainWindow::onUpdatePlot()
     // Mark data as refreshed
     m_dataNeedsRefresh = false;
     m_variableSelectionChanged = false;
+    updateMemoryUsage();
 }
 
 void MainWindow::onTabChanged(int index)
@@ -1446,6 +1499,7 @@ void MainWindow::onTabChanged(int index)
 
     } else if (index == 1) {
         // Data View tab
+        ensureDataTableWidget();
         if (m_updatePlotButton) {
             m_updatePlotButton->setText("Data");
         }
@@ -1476,7 +1530,7 @@ void MainWindow::onTabChanged(int index)
         }
         
         // Hide DAS, DAP, DATE buttons for scatter plot widget (not applicable)
-        if (m_scatterPlotWidget) {
+        if (ensureScatterPlotWidget()) {
             m_scatterPlotWidget->setXAxisButtonsVisible(false);
         }
         // Show buttons for time series plot widget (if user switches back)
@@ -1496,6 +1550,8 @@ void MainWindow::onTabChanged(int index)
         } else if (selectedItems.isEmpty()) {
             m_statusWidget->showInfo("Select EVALUATE.OUT file and variables, then click 'Plot' to view scatter plot");
         }
+    } else if (index == 3) {
+        ensureStatisticsTab();
     }
 
     if (index == 0) {
@@ -2018,7 +2074,7 @@ void MainWindow::updateScatterPlot()
     if (selectedVars.size() > 9) selectedVars = selectedVars.mid(0, 9);
 
 
-    if (m_scatterPlotWidget) {
+    if (ensureScatterPlotWidget()) {
         m_scatterPlotWidget->plotScatter(m_evaluateData, selectedVars);
     } else {
         qWarning() << "MainWindow::updateScatterPlot() - Scatter plot widget is null!";
@@ -2234,14 +2290,45 @@ void MainWindow::resizeEvent(QResizeEvent *event)
 
 void MainWindow::populateFolders()
 {
-    if (!m_fileComboBox || !m_dataProcessor) {
+    // A pending background scan fills the list itself
+    if (!m_fileComboBox || !m_dataProcessor || m_discoveringFolders) {
         return;
     }
     
+    fillFolderCombo(m_dataProcessor->prepareFolders(true));
+}
+
+// Locates the DSSAT install (DSSATPRO, DETAIL.CDE) and lists its crop folders on a
+// worker thread; the crop selector shows a placeholder until the list arrives
+void MainWindow::populateFoldersAsync()
+{
+    if (!m_fileComboBox || m_discoveringFolders) return;
+
+    m_discoveringFolders = true;
+    m_fileComboBox->blockSignals(true);
+    m_fileComboBox->clear();
+    m_fileComboBox->addItem("Locating DSSAT installation...");
+    m_fileComboBox->blockSignals(false);
+    m_fileComboBox->setEnabled(false);
+
+    QPointer<MainWindow> self(this);
+    QThreadPool::globalInstance()->start([self]() {
+        DataProcessor processor;
+        const QStringList folders = processor.prepareFolders(true);
+        QMetaObject::invokeMethod(qApp, [self, folders]() {
+            if (!self) return;
+            self->m_discoveringFolders = false;
+            self->m_fileComboBox->setEnabled(true);
+            self->fillFolderCombo(folders);
+            Trace::mark("crop folders listed");
+            Trace::printSummary();
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::fillFolderCombo(const QStringList &folders)
+{
     m_fileComboBox->clear();
-    
-    QStringList folders = m_dataProcessor->prepareFolders(true);
-    
     
     if (folders.isEmpty()) {
         m_fileComboBox->addItem("No DSSAT folders found");
@@ -2271,12 +2358,23 @@ void MainWindow::populateFolders()
 
 bool MainWindow::eventFilter(QObject *obj, QEvent *event)
 {
+    if (obj == this && event->type() == QEvent::Paint) {
+        // Installed only for --startup-trace
+        removeEventFilter(this);
+        Trace::mark("first paint");
+        if (!m_discoveringFolders)
+            Trace::printSummary();
+    }
     return QMainWindow::eventFilter(obj, event);
 }
 
 void MainWindow::addDroppedOutFile(const QString &filePath)
 {
     if (!m_fileListWidget || filePath.isEmpty()) return;
+    if (m_discoveringFolders) {
+        m_statusWidget->showInfo("Still locating the DSSAT installation; drop the file again in a moment.");
+        return;
+    }
 
     QFileInfo fi(filePath);
     if (!fi.exists() || !fi.isFile()) return;
@@ -2523,6 +2621,7 @@ void MainWindow::onFileSelectionChanged()
             m_statusWidget->showInfo("Click outfile and click refresh data to view data");
         }
 
+        updateMemoryUsage();
         return;
     }
 
@@ -2532,27 +2631,14 @@ void MainWindow::onFileSelectionChanged()
     // Load data from all selected files to get comprehensive Y variable list
     if (!selectedItems.isEmpty()) {
         
-        // Clear previous data - separate storage for different file types
-        m_currentData.clear();  // For time series (regular .OUT files)
-        m_currentObsData.clear();  // For time series observed data
-        m_evaluateData.clear();  // For scatter plots (EVALUATE.OUT files)
-        m_fileColumnMap.clear();  // Reset per-file column tracking
-        
-        // Load and merge data from all selected files, separating by type
-        QSet<QString> uniqueExperimentCodes;
-        QMap<QString, QMap<QString, QString>> extractedTreatmentNames;
-        QString firstValidFile;
-        QString firstValidRegularFile;  // For observed data lookup
-        bool hasEvaluateFile = false;
-        bool hasRegularFile = false;
-        QStringList loadedPaths;  // absolute paths actually read, for the file watcher
-
+        // Resolve each selected item to its file path
+        QVector<QPair<QString, QString>> files;
         for (QListWidgetItem* selectedItem : selectedItems) {
             QString selectedFile = selectedItem->text();
-        
+
             if (selectedFile != "No .OUT files found") {
                 QString dssatBase = m_dataProcessor->getDSSATBase();
-                
+
                 // Dropped external files store their full path in UserRole
                 QString droppedPath = selectedItem->data(Qt::UserRole).toString();
                 QString folderPath  = m_dataProcessor->getActualFolderPath(m_selectedFolder);
@@ -2564,185 +2650,45 @@ void MainWindow::onFileSelectionChanged()
                 } else {
                     filePath = QDir(dssatBase).absoluteFilePath(m_selectedFolder + QDir::separator() + selectedFile);
                 }
-                
-                // Check if THIS specific file is EVALUATE.OUT or evaluate.csv
-                QString upperFileName = selectedFile.toUpper();
-                bool isEvaluateFile = upperFileName.contains("EVALUATE");
-                if (isEvaluateFile) {
-                    hasEvaluateFile = true;
-                } else {
-                    hasRegularFile = true;
-                    if (firstValidRegularFile.isEmpty()) {
-                        firstValidRegularFile = filePath;
-                    }
-                }
-
-                // Load data from current file using appropriate reader
-                DataTable fileData;
-                bool readSuccess = false;
-                if (isEvaluateFile) {
-                    // readFile dispatches .OUT to readEvaluateFile and .csv to readCsvFile
-                    readSuccess = m_dataProcessor->readFile(filePath, fileData);
-                } else {
-                    readSuccess = m_dataProcessor->readFile(filePath, fileData);
-                }
-                
-                if (readSuccess) {
-
-                    loadedPaths << filePath;  // watch this file for on-disk changes
+                files.append(qMakePair(selectedFile, filePath));
+            }
+        }
 
-                    // Keep track of first valid file for later processing
-                    if (firstValidFile.isEmpty()) {
-                        firstValidFile = filePath;
-                    }
-                    
-                    // Store data in appropriate location based on file type
-                    if (isEvaluateFile) {
-                        // Store EVALUATE.OUT data separately for scatter plots
-                        if (m_evaluateData.rowCount == 0) {
-                            m_evaluateData = fileData;
-                        } else {
-                            m_evaluateData.merge(fileData);
-                        }
-                    } else {
-                        // Store regular .OUT data for time series plots
-                        m_fileColumnMap[selectedFile] = fileData.columnNames;
-                        // Stamp each row with the source filename so plotDatasets can filter by file
-                        DataColumn srcCol("__SRCFILE__");
-                        for (int i = 0; i < fileData.rowCount; ++i)
-                            srcCol.data.append(selectedFile);
-                        fileData.addColumn(srcCol);
-                        if (m_currentData.rowCount == 0) {
-                            m_currentData = fileData;
-                        } else {
-                            m_currentData.merge(fileData);
-                        }
-                    }
-                    
-                    // Extract experiment codes and treatment names from this file (only for regular files)
-                    if (!isEvaluateFile && fileData.columnNames.contains("TRT") && fileData.columnNames.contains("TNAME")) {
-                        const DataColumn* expCol = fileData.getColumn("EXPERIMENT");
-                        const DataColumn* trtCol = fileData.getColumn("TRT");
-                        const DataColumn* tnameCol = fileData.getColumn("TNAME");
-
-                        if (trtCol && tnameCol) {
-                            for (int i = 0; i < fileData.rowCount; ++i) {
-                                QString expCode = expCol ? expCol->data[i].toString().trimmed() : QString();
-                                QString trtCode = trtCol->data[i].toString().trimmed();
-                                QString tname = tnameCol->data[i].toString().trimmed();
-
-                                if (!expCode.isEmpty() && expCode != "DEFAULT") {
-                                    uniqueExperimentCodes.insert(expCode);
-                                }
-                                if (!trtCode.isEmpty() && !tname.isEmpty()) {
-                                    // T files have no EXPERIMENT column; store under "default" so
-                                    // getTreatmentDisplayName's fallback can find them.
-                                    QString key = expCode.isEmpty() ? "default" : expCode;
-                                    extractedTreatmentNames[key][trtCode] = tname;
-                                }
-                            }
-                        }
-                    }
-                } else {
-                }
+        // Load and merge data from all selected files, separating by type. Every holder
+        // of the previous set lets go of it first (the plots and their caches and the Data
+        // View share its buffers), so the old and new tables never coexist. Whatever
+        // stays resident, such as a plot snapshot, counts against the budget.
+        m_currentData.clear();
+        m_currentObsData.clear();
+        m_evaluateData.clear();
+        for (PlotWidget *plot : { m_plotWidget, m_scatterPlotWidget }) {
+            if (plot) {
+                plot->clear();
+                plot->releaseCaches();
             }
         }
-        
-        // Process regular .OUT files (for time series plots)
+        if (m_dataTableWidget) m_dataTableWidget->clear();
+        OutputFileSet loaded;
+        m_dataProcessor->setMemoryBudget(memoryBudgetBytes());
+        m_dataProcessor->setResidentBytes(measureMemoryUsage().total());
+        m_dataProcessor->loadOutputFiles(m_selectedFolder, files, loaded);
+        m_currentData = loaded.simData;         // For time series (regular .OUT files)
+        m_currentObsData = loaded.obsData;      // For time series observed data
+        m_evaluateData = loaded.evaluateData;   // For scatter plots (EVALUATE.OUT files)
+        m_fileColumnMap = loaded.fileColumns;
+        const bool hasEvaluateFile = loaded.hasEvaluateFile;
+        const bool hasRegularFile = loaded.hasRegularFile;
+        const QStringList loadedPaths = loaded.loadedPaths;  // for the file watcher
+
         if (m_currentData.rowCount > 0) {
-            m_treatmentNames = extractedTreatmentNames; // Assign to member variable
+            m_treatmentNames = loaded.treatmentNames;
 
             // Set m_selectedExperiment to the first available experiment code
-            if (!uniqueExperimentCodes.isEmpty()) {
-                m_selectedExperiment = uniqueExperimentCodes.values().first();
+            if (!loaded.experimentCodes.isEmpty()) {
+                m_selectedExperiment = loaded.experimentCodes.values().first();
             } else {
                 m_selectedExperiment = ""; // Or a default value if no experiments are found
             }
-
-            // Determine crop code
-            QString cropCode = "XX";
-            
-            // Special handling for SensWork - extract crop code from the file itself
-            if (m_selectedFolder.compare("SensWork", Qt::CaseInsensitive) == 0 && !firstValidFile.isEmpty()) {
-                QPair<QString, QString> sensWorkCodes = m_dataProcessor->extractSensWorkCodes(firstValidFile);
-                if (!sensWorkCodes.second.isEmpty()) {
-                    cropCode = sensWorkCodes.second.toUpper();
-                } else {
-                }
-            } else {
-                // Regular crop folder - try to get crop code from the selected folder name by matching with crop details
-                QVector<CropDetails> allCropDetails = m_dataProcessor->getCropDetails();
-                QString selectedFolderLower = m_selectedFolder.toLower();
-
-                // Two-pass: exact matches first, then partial (to avoid "Pea" matching before "Peanut")
-                QString partialCode;
-                for (const CropDetails& crop : allCropDetails) {
-                    QString dirName = QFileInfo(crop.directory).fileName().toLower();
-                    QString cropNameLower = crop.cropName.toLower();
-
-                    bool dirNameMatch = (dirName == selectedFolderLower);
-                    bool cropNameMatch = (cropNameLower == selectedFolderLower);
-                    bool pathContainsFolder = crop.directory.toLower().contains("/" + selectedFolderLower) ||
-                                             crop.directory.toLower().contains("\\" + selectedFolderLower);
-
-                    if (dirNameMatch || cropNameMatch || pathContainsFolder) {
-                        cropCode = crop.cropCode.toUpper();
-                        break;
-                    }
-
-                    // Partial match: only keep first candidate, don't break
-                    if (partialCode.isEmpty()) {
-                        bool cropNameContains = cropNameLower.contains(selectedFolderLower) ||
-                                               selectedFolderLower.contains(cropNameLower);
-                        if (cropNameContains)
-                            partialCode = crop.cropCode.toUpper();
-                    }
-                }
-
-                // Fall back to partial match only if no exact match found
-                if (cropCode == "XX" && !partialCode.isEmpty())
-                    cropCode = partialCode;
-            }
-
-            // Add CROP column to simulated data if it doesn't exist
-            if (!m_currentData.columnNames.contains("CROP")) {
-                DataColumn cropCol("CROP");
-                for (int r = 0; r < m_currentData.rowCount; ++r) {
-                    cropCol.data.append(cropCode);
-                }
-                m_currentData.addColumn(cropCol);
-            }
-
-            // Attempt to load and merge observed data for each unique experiment code (only for regular files)
-            // Special handling for SensWork files
-            if (m_selectedFolder.compare("SensWork", Qt::CaseInsensitive) == 0) {
-                
-                // For SensWork, use the dynamic observed data lookup
-                if (!firstValidRegularFile.isEmpty()) {
-                    DataTable sensWorkObsData;
-                    if (m_dataProcessor->readSensWorkObservedData(firstValidRegularFile, sensWorkObsData)) {
-                        m_currentObsData.merge(sensWorkObsData);
-                    } else {
-                    }
-                }
-            } else {
-                // Regular crop folder - use standard observed data lookup
-                
-                for (const QString& expCode : uniqueExperimentCodes) {
-                    DataTable tempObsData;
-                    // Use the first valid regular file path for observed data lookup
-                    if (!firstValidRegularFile.isEmpty() && m_dataProcessor->readObservedData(firstValidRegularFile, expCode, cropCode, tempObsData)) {
-                        m_currentObsData.merge(tempObsData);
-                    } else {
-                    }
-                }
-            }
-            
-            // Add DAS/DAP columns to observed data if it exists
-            if (m_currentObsData.rowCount > 0) {
-                m_dataProcessor->addDasDapColumns(m_currentObsData, m_currentData);
-            } else {
-            }
         }
         
         // Process EVALUATE.OUT files (for scatter plots)
@@ -2821,6 +2767,18 @@ void MainWindow::onFileSelectionChanged()
 
         // Watch the freshly loaded files so we can warn if DSSAT overwrites them.
         rearmFileWatcher(loadedPaths);
+
+        if (!loaded.refusedPaths.isEmpty()) {
+            QStringList names;
+            for (const QString &path : loaded.refusedPaths)
+                names << QFileInfo(path).fileName();
+            QMessageBox::warning(this, "Memory Budget",
+                QString("These files were not loaded because they would take the loaded data past "
+                        "the %1 memory budget:\n\n%2\n\nSelect fewer outfiles, or raise the budget "
+                        "in Plot Settings if this machine has memory to spare.")
+                    .arg(MemoryUsage::format(memoryBudgetBytes()), names.join("\n")));
+        }
+        updateMemoryUsage();
     }
 }
 
@@ -2934,6 +2892,56 @@ void MainWindow::markDataNeedsRefresh()
     m_tabContentLoaded.clear();
 }
 
+qint64 MainWindow::memoryBudgetBytes() const
+{
+    // The live settings: OK in the settings dialog applies without saving
+    const int budgetMB = m_plotWidget ? m_plotWidget->getPlotSettings().memoryBudgetMB
+                                      : PlotSettings().memoryBudgetMB;
+    return qint64(qMax(budgetMB, 0)) * 1024 * 1024;
+}
+
+MemoryUsage MainWindow::measureMemoryUsage() const
+{
+    // One seen-set across all holders: the plot and data view share column buffers
+    // with m_currentData until they modify them. Columns cache their cell sizes, so
+    // only buffers created since the last call are scanned.
+    QSet<const void *> seen;
+    MemoryUsage usage = m_currentData.memoryUsage(&seen);
+    usage += m_currentObsData.memoryUsage(&seen);
+    usage += m_evaluateData.memoryUsage(&seen);
+    for (PlotWidget *plot : { m_plotWidget, m_scatterPlotWidget }) {
+        if (plot) usage += plot->memoryUsage(&seen);
+    }
+    if (m_dataTableWidget) usage += m_dataTableWidget->memoryUsage(&seen);
+    return usage;
+}
+
+void MainWindow::updateMemoryUsage()
+{
+    const qint64 budget = memoryBudgetBytes();
+    MemoryUsage usage = measureMemoryUsage();
+    if (budget > 0 && usage.total() > budget) {
+        // Caches first: the next plot rebuilds what it needs
+        for (PlotWidget *plot : { m_plotWidget, m_scatterPlotWidget }) {
+            if (plot) plot->releaseCaches();
+        }
+        for (DataTable *table : { &m_currentData, &m_currentObsData, &m_evaluateData })
+            table->releaseCaches();
+        // Then the Data View's filtered and sorted copies, rebuilt when the tab is shown
+        if (m_dataTableWidget && m_tabWidget && m_tabWidget->currentIndex() != 1) {
+            m_dataTableWidget->clear();
+            m_dataNeedsRefresh = true;
+        }
+        usage = measureMemoryUsage();
+        if (usage.total() > budget) {
+            m_statusWidget->showWarning(QString("Loaded data uses %1, over the %2 memory budget — select fewer outfiles")
+                                            .arg(MemoryUsage::format(usage.total()), MemoryUsage::format(budget)),
+                                        0 /* keep visible */);
+        }
+    }
+    m_statusWidget->setMemoryUsage(usage, budget);
+}
+
 void MainWindow::filterOutFiles(const QString &text)
 {
     if (!m_fileListWidget) {
@@ -3342,52 +3350,7 @@ int MainWindow::selectYVariables(const QStringList &varNames)
 bool MainWindow::saveMetricsToFile(const QString &filePath)
 {
     if (m_currentMetrics.isEmpty()) return false;
-
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "MainWindow::saveMetricsToFile: cannot open" << filePath;
-        return false;
-    }
-
-    QTextStream out(&file);
-    out.setEncoding(QStringConverter::Utf8);
-
-    // UTF-8 BOM
-    out << "\xEF\xBB\xBF";
-
-    // Header
-    out << "Treatment,Treatment Name,Experiment,Crop,Variable,n,RMSE,d-stat\n";
-
-    for (const QVariant &item : m_currentMetrics) {
-        QVariantMap row = item.toMap();
-
-        auto getVal = [&](const QStringList &keys) -> QString {
-            for (const QString &k : keys) {
-                if (row.contains(k)) return row[k].toString();
-            }
-            return QString();
-        };
-
-        QString treatment    = getVal({"Treatment", "treatment", "trt", "TRT"});
-        QString treatmentName = getVal({"TreatmentName", "Treatment Name", "treatment_name", "trt_name"});
-        QString experiment   = getVal({"Experiment", "experiment", "exp", "EXP"});
-        QString crop         = getVal({"CropName", "Crop", "crop", "CROP"});
-        QString variable     = getVal({"VariableName", "Variable", "variable", "var"});
-        int     n            = (int)getVal({"n", "N", "samples", "count"}).toDouble();
-        double  rmse         = getVal({"RMSE", "rmse"}).toDouble();
-        double  dstat        = getVal({"d-stat", "Willmott's d-stat", "d_stat", "dstat", "willmott_d"}).toDouble();
-
-        out << treatment << ","
-            << treatmentName << ","
-            << experiment << ","
-            << crop << ","
-            << variable << ","
-            << n << ","
-            << QString::number(rmse,  'f', 3) << ","
-            << QString::number(dstat, 'f', 4) << "\n";
-    }
-
-    return true;
+    return MetricsCalculator::writeMetricsCsv(filePath, m_currentMetrics);
 }
 
 void MainWindow::onDataViewFileTypeChanged()
@@ -1,7 +1,16 @@
 #include "MetricsCalculator.h"
+#include "DataProcessor.h"
+#include "Parallel.h"
 #include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextStream>
 #include <algorithm>
 #include <numeric>
+#include <random>
+#include <vector>
 
 double MetricsCalculator::dStat(const QVector<double>& measured, const QVector<double>& simulated)
 {
@@ -258,7 +267,8 @@ void MetricsCalculator::mseDecomposition(const QVector<double>& observed,
 
 QVariantMap MetricsCalculator::calculateMetrics(const QVector<double>& simValues, 
                                               const QVector<double>& obsValues, 
-                                              int treatmentNumber)
+                                              int treatmentNumber,
+                                              int bootstrapResamples)
 {
     QVariantMap result;
     
@@ -317,6 +327,10 @@ QVariantMap MetricsCalculator::calculateMetrics(const QVector<double>& simValues
         result["ObsMean"] = mean_obs;
         result["SimMean"] = mean_sim;
 
+        // 95% bootstrap confidence intervals (obs/sim are already filtered)
+        if (bootstrapResamples > 0)
+            storeBootstrapCI(result, bootstrapCI(obs, sim, bootstrapResamples));
+
         
     } catch (const std::exception& e) {
         qWarning() << "Error calculating metrics:" << e.what();
@@ -325,7 +339,421 @@ QVariantMap MetricsCalculator::calculateMetrics(const QVector<double>& simValues
     return result;
 }
 
+MetricsCalculator::FusedMetrics MetricsCalculator::fusedMetrics(const double* observed,
+                                                                const double* simulated,
+                                                                const int* indices, int n)
+{
+    FusedMetrics r;
+    r.n = n;
+    if (n <= 0) return r;
+
+    // Pass 1: means
+    double sumObs = 0.0;
+    double sumSim = 0.0;
+    for (int k = 0; k < n; ++k) {
+        const int i = indices ? indices[k] : k;
+        sumObs += observed[i];
+        sumSim += simulated[i];
+    }
+    const double meanObs = sumObs / n;
+    const double meanSim = sumSim / n;
+
+    // Pass 2: squared error, Willmott denominator and centred (co)variances together
+    double sse = 0.0, dDen = 0.0, cov = 0.0, varObs = 0.0, varSim = 0.0;
+    for (int k = 0; k < n; ++k) {
+        const int i = indices ? indices[k] : k;
+        const double o = observed[i];
+        const double s = simulated[i];
+        const double diff = o - s;
+        sse += diff * diff;
+        const double term = std::abs(o - meanObs) + std::abs(s - meanObs);
+        dDen += term * term;
+        const double dO = o - meanObs;
+        const double dS = s - meanSim;
+        cov    += dO * dS;
+        varObs += dO * dO;
+        varSim += dS * dS;
+    }
+
+    r.rmse  = std::sqrt(sse / n);
+    r.dStat = (dDen == 0.0) ? 0.0 : 1.0 - sse / dDen;
+    const double denom = std::sqrt(varObs * varSim);
+    if (n >= 2 && denom != 0.0) {
+        const double corr = cov / denom;
+        r.rSquared = corr * corr;
+    }
+    return r;
+}
+
+namespace {
+
+// SplitMix64 finaliser: turns (seed, block) into well-separated RNG seeds
+quint64 splitMix64(quint64 x)
+{
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Linear-interpolated percentile of an already sorted sample
+double sortedPercentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty()) return 0.0;
+    const double pos = p * (sorted.size() - 1);
+    const size_t lo = static_cast<size_t>(std::floor(pos));
+    const size_t hi = std::min(lo + 1, sorted.size() - 1);
+    const double frac = pos - lo;
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * frac;
+}
+
+// Bootstrap results are a pure function of these; replots of the same groups hit the cache
+struct BootstrapKey {
+    QVector<double> obs, sim;
+    int resamples = 0;
+    double confidence = 0.0;
+    quint64 seed = 0;
+
+    bool operator==(const BootstrapKey& other) const
+    {
+        return resamples == other.resamples && confidence == other.confidence &&
+               seed == other.seed && obs == other.obs && sim == other.sim;
+    }
+};
+
+size_t qHash(const BootstrapKey& key, size_t seed = 0)
+{
+    seed = qHashRange(key.obs.cbegin(), key.obs.cend(), seed);
+    seed = qHashRange(key.sim.cbegin(), key.sim.cend(), seed);
+    return qHashMulti(seed, key.resamples, key.confidence, key.seed);
+}
+
+constexpr int BOOTSTRAP_CACHE_LIMIT = 1024;  // entries; the cache is dropped when full
+
+QMutex s_bootstrapCacheMutex;
+QHash<BootstrapKey, MetricsCalculator::BootstrapCI> s_bootstrapCache;
+
+// One bootstrap run, split into blocks of resamples with their own RNG streams so the
+// result does not depend on which thread runs a block
+struct BootstrapRun {
+    static constexpr int BLOCK_SIZE = 64;  // resamples per RNG stream
+
+    QVector<double> obs, sim;
+    int n = 0;
+    int resamples = 0;
+    int nBlocks = 0;
+    quint64 seed = 0;
+    std::vector<double> rmseSamples, dSamples, r2Samples;
+
+    void runBlock(int block)
+    {
+        std::mt19937_64 rng(splitMix64(seed ^ splitMix64(static_cast<quint64>(block))));
+        std::vector<int> indices(n);
+        const int first = block * BLOCK_SIZE;
+        const int last = std::min(first + BLOCK_SIZE, resamples);
+        for (int r = first; r < last; ++r) {
+            for (int k = 0; k < n; ++k) {
+                indices[k] = static_cast<int>(rng() % static_cast<quint64>(n));
+            }
+            const MetricsCalculator::FusedMetrics fm =
+                MetricsCalculator::fusedMetrics(obs.constData(), sim.constData(), indices.data(), n);
+            rmseSamples[r] = fm.rmse;
+            dSamples[r] = fm.dStat;
+            r2Samples[r] = fm.rSquared;
+        }
+    }
+};
+
+} // namespace
+
+MetricsCalculator::BootstrapCI MetricsCalculator::bootstrapCI(const QVector<double>& observed,
+                                                              const QVector<double>& simulated,
+                                                              int resamples,
+                                                              double confidence,
+                                                              quint64 seed)
+{
+    BootstrapCI ci;
+    ci.resamples = resamples;
+    ci.confidence = confidence;
+    if (resamples < 2 || confidence <= 0.0 || confidence >= 1.0) {
+        return ci;
+    }
+
+    // Filter once; every resample then indexes into the same contiguous arrays
+    auto filteredPair = filterPairs(observed, simulated);
+    const int n = filteredPair.first.size();
+    if (n < 3) {
+        return ci;
+    }
+
+    BootstrapKey key{filteredPair.first, filteredPair.second, resamples, confidence, seed};
+    {
+        QMutexLocker lock(&s_bootstrapCacheMutex);
+        auto cached = s_bootstrapCache.constFind(key);
+        if (cached != s_bootstrapCache.constEnd()) return cached.value();
+    }
+
+    constexpr qint64 PARALLEL_MIN_WORK = 200000;  // n * resamples below this runs inline
+
+    BootstrapRun run;
+    run.obs = key.obs;
+    run.sim = key.sim;
+    run.n = n;
+    run.resamples = resamples;
+    run.nBlocks = (resamples + BootstrapRun::BLOCK_SIZE - 1) / BootstrapRun::BLOCK_SIZE;
+    run.seed = seed;
+    run.rmseSamples.resize(resamples);
+    run.dSamples.resize(resamples);
+    run.r2Samples.resize(resamples);
+
+    Parallel::forEach(run.nBlocks, Parallel::threadCount(static_cast<qint64>(n) * resamples, PARALLEL_MIN_WORK),
+                      [&run](int block) { run.runBlock(block); });
+
+    std::sort(run.rmseSamples.begin(), run.rmseSamples.end());
+    std::sort(run.dSamples.begin(), run.dSamples.end());
+    std::sort(run.r2Samples.begin(), run.r2Samples.end());
+
+    const double alpha = (1.0 - confidence) / 2.0;
+    ci.rmseLow      = sortedPercentile(run.rmseSamples, alpha);
+    ci.rmseHigh     = sortedPercentile(run.rmseSamples, 1.0 - alpha);
+    ci.dStatLow     = sortedPercentile(run.dSamples, alpha);
+    ci.dStatHigh    = sortedPercentile(run.dSamples, 1.0 - alpha);
+    ci.rSquaredLow  = sortedPercentile(run.r2Samples, alpha);
+    ci.rSquaredHigh = sortedPercentile(run.r2Samples, 1.0 - alpha);
+    ci.valid = true;
+
+    QMutexLocker lock(&s_bootstrapCacheMutex);
+    if (s_bootstrapCache.size() >= BOOTSTRAP_CACHE_LIMIT) s_bootstrapCache.clear();
+    s_bootstrapCache.insert(std::move(key), ci);
+    return ci;
+}
+
+void MetricsCalculator::clearBootstrapCache()
+{
+    QMutexLocker lock(&s_bootstrapCacheMutex);
+    s_bootstrapCache.clear();
+}
+
+void MetricsCalculator::storeBootstrapCI(QVariantMap& result, const BootstrapCI& ci,
+                                         const QString& keyPrefix)
+{
+    if (!ci.valid) return;
+    result[keyPrefix + "RMSE_CI_Low"]   = ci.rmseLow;
+    result[keyPrefix + "RMSE_CI_High"]  = ci.rmseHigh;
+    result[keyPrefix + "DStat_CI_Low"]  = ci.dStatLow;
+    result[keyPrefix + "DStat_CI_High"] = ci.dStatHigh;
+    result[keyPrefix + "R2_CI_Low"]     = ci.rSquaredLow;
+    result[keyPrefix + "R2_CI_High"]    = ci.rSquaredHigh;
+    result[keyPrefix + "CI_Level"]      = ci.confidence;
+    result[keyPrefix + "CI_Resamples"]  = ci.resamples;
+}
+
 // Helper functions
+void MetricsCalculator::sortMetricRows(QVector<QVariantMap>& metrics)
+{
+    std::sort(metrics.begin(), metrics.end(), [](const QVariantMap& a, const QVariantMap& b) {
+        const QString trtA = a.value("Treatment").toString();
+        const QString trtB = b.value("Treatment").toString();
+        bool okA, okB;
+        const int trtNumA = trtA.toInt(&okA);
+        const int trtNumB = trtB.toInt(&okB);
+        if (okA && okB) {
+            if (trtNumA != trtNumB) return trtNumA < trtNumB;
+        } else if (trtA != trtB) {
+            return trtA < trtB;
+        }
+
+        const QString varA = a.value("Variable").toString();
+        const QString varB = b.value("Variable").toString();
+        if (varA != varB) return varA < varB;
+
+        const QString expA = a.value("Experiment").toString();
+        const QString expB = b.value("Experiment").toString();
+        if (expA != expB) return expA < expB;
+
+        return a.value("Crop").toString() < b.value("Crop").toString();
+    });
+}
+
+void MetricsCalculator::addPooledMetrics(QVector<QVariantMap>& metrics,
+                                         const QMap<QString, QVector<double>>& pooledObs,
+                                         const QMap<QString, QVector<double>>& pooledSim,
+                                         int bootstrapResamples)
+{
+    QMap<QString, QVariantMap> pooledByVar;
+    for (auto it = pooledObs.constBegin(); it != pooledObs.constEnd(); ++it) {
+        if (it.value().isEmpty()) continue;
+        const QVector<double> sim = pooledSim.value(it.key());
+        QVariantMap pooled;
+        pooled["PooledDStat"] = dStat(it.value(), sim);
+        if (bootstrapResamples > 0)
+            storeBootstrapCI(pooled, bootstrapCI(it.value(), sim, bootstrapResamples), "Pooled");
+        pooledByVar[it.key()] = pooled;
+    }
+    for (auto &m : metrics) {
+        auto pit = pooledByVar.constFind(m.value("Variable").toString());
+        if (pit == pooledByVar.constEnd()) continue;
+        for (auto kv = pit.value().constBegin(); kv != pit.value().constEnd(); ++kv)
+            m[kv.key()] = kv.value();
+    }
+}
+
+namespace {
+
+// Key and date columns that are never metrics variables
+const QSet<QString> NON_VARIABLE_COLUMNS = {
+    "TRT", "TRNO", "RUN", "DATE", "YEAR", "DOY", "DAS", "DAP",
+    "EXPERIMENT", "CROP", "TNAME", "__SRCFILE__"
+};
+
+// Same lookup order as the time-series legend: experiment, experiment without the crop
+// suffix, "default", then the bare treatment number
+QString treatmentDisplayName(const QMap<QString, QMap<QString, QString>>& names,
+                             const QString& trt, const QString& experiment)
+{
+    QString name = names.value(experiment).value(trt);
+    if (name.isEmpty() && experiment.contains('_'))
+        name = names.value(experiment.split('_').first()).value(trt);
+    if (name.isEmpty())
+        name = names.value("default").value(trt);
+    if (name.isEmpty())
+        name = trt;
+    if (names.size() > 1 && !experiment.isEmpty())
+        name = QString("%1 (%2)").arg(name, experiment);
+    return name;
+}
+
+QString cropDisplayName(const QString& code)
+{
+    if (code.isEmpty() || code == "XX") return code;
+    for (const CropDetails& crop : DataProcessor::getCropDetails()) {
+        if (crop.cropCode.compare(code, Qt::CaseInsensitive) == 0)
+            return crop.cropName;
+    }
+    return code;
+}
+
+} // namespace
+
+QStringList MetricsCalculator::commonVariables(const DataTable& simData, const DataTable& obsData)
+{
+    QStringList variables;
+    for (const QString& column : simData.columnNames) {
+        if (!NON_VARIABLE_COLUMNS.contains(column) && obsData.getColumn(column))
+            variables.append(column);
+    }
+    return variables;
+}
+
+QVector<QVariantMap> MetricsCalculator::obsSimMetrics(const DataTable& simData, const DataTable& obsData,
+                                                      const QMap<QString, QMap<QString, QString>>& treatmentNames,
+                                                      const QStringList& variables,
+                                                      const QSet<QString>& treatments,
+                                                      int bootstrapResamples)
+{
+    QVector<QVariantMap> metrics;
+    QMap<QString, QVector<double>> pooledObs, pooledSim;
+    for (const QString& variable : variables) {
+        const QVector<ObsSimGroup> groups = DataProcessor::matchObsSim(simData, obsData, variable);
+        for (const ObsSimGroup& group : groups) {
+            if (!treatments.isEmpty() && !treatments.contains(group.treatment)
+                && !treatments.contains(group.experiment + "::" + group.treatment)) {
+                continue;
+            }
+            if (group.obs.isEmpty()) continue;
+
+            pooledObs[variable].append(group.obs);
+            pooledSim[variable].append(group.sim);
+
+            QVariantMap result = calculateMetrics(group.sim, group.obs, group.treatment.toInt(),
+                                                  bootstrapResamples);
+            if (result.isEmpty()) continue;
+
+            const QString variableName = DataProcessor::getVariableInfo(variable).first;
+            QString name = treatmentDisplayName(treatmentNames, group.treatment, group.experiment);
+            if (!group.runId.isEmpty() && group.multiRun)
+                name += QString(" (%1)").arg(group.runId);
+
+            result["Variable"] = variable;
+            result["VariableName"] = variableName.isEmpty() ? variable : variableName;
+            result["Treatment"] = group.treatment;
+            result["TreatmentName"] = name;
+            result["Experiment"] = group.experiment;
+            result["Crop"] = group.crop;
+            result["CropName"] = cropDisplayName(group.crop);
+            if (!group.runId.isEmpty())
+                result["Run"] = group.runId;
+            metrics.append(result);
+        }
+    }
+    sortMetricRows(metrics);
+    addPooledMetrics(metrics, pooledObs, pooledSim, bootstrapResamples);
+    return metrics;
+}
+
+bool MetricsCalculator::writeMetricsCsv(const QString& filePath, const QVariantList& metrics)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "MetricsCalculator::writeMetricsCsv: cannot open" << filePath;
+        return false;
+    }
+
+    QTextStream out(&file);
+    writeMetricsCsv(out, metrics);
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+void MetricsCalculator::writeMetricsCsv(QTextStream& out, const QVariantList& metrics)
+{
+    out.setEncoding(QStringConverter::Utf8);
+
+    // UTF-8 BOM
+    out << "\xEF\xBB\xBF";
+
+    // Header
+    out << "Treatment,Treatment Name,Experiment,Crop,Variable,n,RMSE,d-stat,"
+           "RMSE_CI_Low,RMSE_CI_High,dstat_CI_Low,dstat_CI_High,R2_CI_Low,R2_CI_High\n";
+
+    for (const QVariant &item : metrics) {
+        QVariantMap row = item.toMap();
+
+        auto getVal = [&](const QStringList &keys) -> QString {
+            for (const QString &k : keys) {
+                if (row.contains(k)) return row[k].toString();
+            }
+            return QString();
+        };
+
+        QString treatment    = getVal({"Treatment", "treatment", "trt", "TRT"});
+        QString treatmentName = getVal({"TreatmentName", "Treatment Name", "treatment_name", "trt_name"});
+        QString experiment   = getVal({"Experiment", "experiment", "exp", "EXP"});
+        QString crop         = getVal({"CropName", "Crop", "crop", "CROP"});
+        QString variable     = getVal({"VariableName", "Variable", "variable", "var"});
+        int     n            = (int)getVal({"n", "N", "samples", "count"}).toDouble();
+        double  rmse         = getVal({"RMSE", "rmse"}).toDouble();
+        double  dstat        = getVal({"d-stat", "Willmott's d-stat", "d_stat", "dstat", "willmott_d"}).toDouble();
+
+        // Bootstrap CI bounds; left empty when the group had too few pairs to resample
+        auto ciVal = [&](const QString &key, int prec) -> QString {
+            return row.contains(key) ? QString::number(row[key].toDouble(), 'f', prec) : QString();
+        };
+
+        out << treatment << ","
+            << treatmentName << ","
+            << experiment << ","
+            << crop << ","
+            << variable << ","
+            << n << ","
+            << QString::number(rmse,  'f', 3) << ","
+            << QString::number(dstat, 'f', 4) << ","
+            << ciVal("RMSE_CI_Low", 3)   << "," << ciVal("RMSE_CI_High", 3)  << ","
+            << ciVal("DStat_CI_Low", 4)  << "," << ciVal("DStat_CI_High", 4) << ","
+            << ciVal("R2_CI_Low", 4)     << "," << ciVal("R2_CI_High", 4)    << "\n";
+    }
+}
+
 double MetricsCalculator::mean(const QVector<double>& values)
 {
     if (values.isEmpty()) {
@@ -50,6 +50,15 @@ public:
     }
 };
 
+// Bootstrap CI columns display "[low, high]" built from a pair of row keys
+static bool ciKeysForColumn(const QString& columnName, QString& lowKey, QString& highKey)
+{
+    if (columnName == "RMSE 95% CI")   { lowKey = "RMSE_CI_Low";  highKey = "RMSE_CI_High";  return true; }
+    if (columnName == "d-stat 95% CI") { lowKey = "DStat_CI_Low"; highKey = "DStat_CI_High"; return true; }
+    if (columnName == "R² 95% CI")     { lowKey = "R2_CI_Low";    highKey = "R2_CI_High";    return true; }
+    return false;
+}
+
 // MetricsTableModel Implementation
 MetricsTableModel::MetricsTableModel(const QVariantList& data, bool isScatterPlot, QObject* parent)
     : QAbstractTableModel(parent)
@@ -58,9 +67,10 @@ MetricsTableModel::MetricsTableModel(const QVariantList& data, bool isScatterPlo
     // For scatter plots, exclude Treatment and Treatment Name columns
     if (isScatterPlot) {
         m_headers = {"Experiment", "Crop", "Variable", "n", "R²", "RMSE", "d-stat",
-                     "BIAS", "MSEs/MSE", "MSEu/MSE"};
+                     "BIAS", "MSEs/MSE", "MSEu/MSE", "R² 95% CI", "RMSE 95% CI", "d-stat 95% CI"};
     } else {
-        m_headers = {"Treatment", "Treatment Name", "Experiment", "Crop", "Variable", "n", "Obs. Mean", "Sim. Mean", "R²", "RMSE", "NRMSE", "d-stat"};
+        m_headers = {"Treatment", "Treatment Name", "Experiment", "Crop", "Variable", "n", "Obs. Mean", "Sim. Mean", "R²", "RMSE", "NRMSE", "d-stat",
+                     "RMSE 95% CI", "d-stat 95% CI", "R² 95% CI"};
     }
     
     // Set up key mapping for flexible data access
@@ -84,6 +94,10 @@ MetricsTableModel::MetricsTableModel(const QVariantList& data, bool isScatterPlo
     m_keyMap["MSEs/MSE"] = {"MSEs", "MSE systematic", "MSE_systematic", "MSE_s"};
     m_keyMap["MSEu/MSE"] = {"MSEu", "MSE unsystematic", "MSE_unsystematic", "MSE_u"};
     m_keyMap["MSE"]      = {"MSE"};
+    // CI columns sort by their lower bound
+    m_keyMap["RMSE 95% CI"]   = {"RMSE_CI_Low"};
+    m_keyMap["d-stat 95% CI"] = {"DStat_CI_Low"};
+    m_keyMap["R² 95% CI"]     = {"R2_CI_Low"};
 }
 
 int MetricsTableModel::rowCount(const QModelIndex& parent) const
@@ -121,6 +135,15 @@ QVariant MetricsTableModel::data(const QModelIndex& index, int role) const
             // fall through to numeric formatting below
         }
 
+        QString ciLowKey, ciHighKey;
+        if (ciKeysForColumn(columnName, ciLowKey, ciHighKey)) {
+            if (!rowData.contains(ciLowKey) || !rowData.contains(ciHighKey)) return "-";
+            const int prec = (columnName == "RMSE 95% CI") ? 3 : 4;
+            return QString("[%1, %2]")
+                .arg(rowData.value(ciLowKey).toDouble(), 0, 'f', prec)
+                .arg(rowData.value(ciHighKey).toDouble(), 0, 'f', prec);
+        }
+
         if (!value.isValid()) {
             return "NA";
         }
@@ -416,6 +439,15 @@ static QVariantMap computeOverallRow(const QVariantList& varRows, bool isScatter
         // Use pooled d-stat if available (correct), otherwise fall back to weighted average
         QVariant pooled = varRows.isEmpty() ? QVariant() : varRows.first().toMap().value("PooledDStat");
         overall["d-stat"]  = pooled.isValid() ? pooled.toDouble() : sumDStat / totalN;
+        // Pooled bootstrap CIs are stored on every row of the variable with a "Pooled" prefix
+        if (!varRows.isEmpty()) {
+            const QVariantMap first = varRows.first().toMap();
+            for (const QString& ciKey : {QStringLiteral("RMSE_CI_Low"), QStringLiteral("RMSE_CI_High"),
+                                         QStringLiteral("DStat_CI_Low"), QStringLiteral("DStat_CI_High"),
+                                         QStringLiteral("R2_CI_Low"), QStringLiteral("R2_CI_High")}) {
+                if (first.contains("Pooled" + ciKey)) overall[ciKey] = first.value("Pooled" + ciKey);
+            }
+        }
         if (isScatterPlot) overall["BIAS"] = sumBias / totalN;
     }
     return overall;
@@ -55,6 +55,18 @@ QVariant PandasTableModel::headerData(int section, Qt::Orientation orientation,
             return QString::number(section);
         }
     }
+    // Per-column memory, computed on hover rather than for every header repaint
+    if (role == Qt::ToolTipRole && orientation == Qt::Horizontal
+        && section >= 0 && section < m_data.columnNames.size()) {
+        const DataColumn* column = m_data.getColumn(m_data.columnNames[section]);
+        if (!column) {
+            return QVariant();
+        }
+        const MemoryUsage usage = column->memoryUsage();
+        return QString("%1\nMemory: %2 (buffer %3, strings %4, caches %5)")
+            .arg(column->name, MemoryUsage::format(usage.total()), MemoryUsage::format(usage.buffers),
+                 MemoryUsage::format(usage.strings), MemoryUsage::format(usage.caches));
+    }
     return QVariant();
 }
 
@@ -111,6 +123,7 @@ void PandasTableModel::sort(int column, Qt::SortOrder order)
                     newData[i] = col->data[indices[i]];
                 }
                 col->data = newData;
+                col->invalidateStats();
             }
         }
     }
@@ -0,0 +1,65 @@
+#include "Parallel.h"
+#include <QSemaphore>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace Parallel {
+
+namespace {
+
+// Shared with the helpers: one that starts after the loop has returned only reads
+// `next` and leaves, so the state must outlive the caller's frame
+struct Run {
+    std::atomic<int> next{0};
+    QSemaphore done;
+    int count = 0;
+    const std::function<void(int)> *fn = nullptr;
+
+    void work()
+    {
+        for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            (*fn)(i);
+            done.release();
+        }
+    }
+};
+
+} // namespace
+
+int threadCount(qint64 work, qint64 parallelMin, int maxThreads)
+{
+    if (work < parallelMin) return 1;
+    return std::max(1, std::min(QThreadPool::globalInstance()->maxThreadCount(), maxThreads));
+}
+
+void forEach(int count, int threads, const std::function<void(int)> &fn)
+{
+    if (count <= 0) return;
+    const int helpers = std::min(threads, count) - 1;
+    if (helpers <= 0) {
+        for (int i = 0; i < count; ++i) fn(i);
+        return;
+    }
+
+    auto run = std::make_shared<Run>();
+    run->count = count;
+    run->fn = &fn;
+    QThreadPool *pool = QThreadPool::globalInstance();
+    for (int t = 0; t < helpers; ++t)
+        pool->start([run]() { run->work(); });
+    run->work();
+    run->done.acquire(count);
+}
+
+void forChunks(int n, int chunks, const std::function<void(int, int, int)> &fn)
+{
+    chunks = std::max(1, chunks);
+    const int size = (n + chunks - 1) / chunks;
+    forEach(chunks, chunks, [&](int chunk) {
+        fn(std::min(n, chunk * size), std::min(n, (chunk + 1) * size), chunk);
+    });
+}
+
+} // namespace Parallel
@@ -0,0 +1,361 @@
+#include "PlotRenderer.h"
+#include "Trace.h"
+#include <QGraphicsScene>
+#include <QGraphicsLayout>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPdfWriter>
+#include <QPageSize>
+#include <QFontMetricsF>
+#include <QDateTime>
+#include <QDebug>
+#include <QtCharts/QChart>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QScatterSeries>
+#include <QtCharts/QAreaSeries>
+#include <QtCharts/QValueAxis>
+#include <QtCharts/QDateTimeAxis>
+#include <cmath>
+
+namespace {
+
+constexpr double LEGEND_SAMPLE_WIDTH = 36.0;
+constexpr double LEGEND_PADDING = 8.0;
+constexpr double LEGEND_ROW_SPACING = 4.0;
+
+QScatterSeries::MarkerShape markerShapeFor(const QString &symbol)
+{
+    if (symbol == "s") return QScatterSeries::MarkerShapeRectangle;
+    if (symbol == "d") return QScatterSeries::MarkerShapeRotatedRectangle;
+    if (symbol == "t" || symbol == "v") return QScatterSeries::MarkerShapeTriangle;
+    return QScatterSeries::MarkerShapeCircle;
+}
+
+void drawMarker(QPainter *painter, const QPointF &c, double size, const QString &symbol)
+{
+    const double r = size / 2.0;
+    if (symbol == "s") {
+        painter->drawRect(QRectF(c.x() - r, c.y() - r, size, size));
+    } else if (symbol == "d") {
+        painter->drawPolygon(QPolygonF({ QPointF(c.x(), c.y() - r), QPointF(c.x() + r, c.y()),
+                                         QPointF(c.x(), c.y() + r), QPointF(c.x() - r, c.y()) }));
+    } else if (symbol == "t") {
+        painter->drawPolygon(QPolygonF({ QPointF(c.x(), c.y() - r), QPointF(c.x() + r, c.y() + r),
+                                         QPointF(c.x() - r, c.y() + r) }));
+    } else if (symbol == "v") {
+        painter->drawPolygon(QPolygonF({ QPointF(c.x() - r, c.y() - r), QPointF(c.x() + r, c.y() - r),
+                                         QPointF(c.x(), c.y() + r) }));
+    } else {
+        painter->drawEllipse(c, r, r);
+    }
+}
+
+QAbstractAxis *createAxis(const PlotRenderAxis &spec, const PlotSettings &settings)
+{
+    QFont tickFont(settings.fontFamily, settings.axisTickFontSize);
+    QFont titleFont(settings.fontFamily, settings.axisLabelFontSize);
+    titleFont.setBold(settings.boldAxisLabels);
+
+    QAbstractAxis *axis = nullptr;
+    if (spec.isDate) {
+        auto *dateAxis = new QDateTimeAxis();
+        dateAxis->setRange(QDateTime::fromMSecsSinceEpoch(qint64(spec.min)),
+                           QDateTime::fromMSecsSinceEpoch(qint64(spec.max)));
+        dateAxis->setFormat(spec.labelFormat.isEmpty() ? QString("MMM dd, yyyy") : spec.labelFormat);
+        if (spec.tickCount > 1) dateAxis->setTickCount(spec.tickCount);
+        axis = dateAxis;
+    } else {
+        auto *valueAxis = new QValueAxis();
+        valueAxis->setRange(spec.min, spec.max);
+        if (spec.tickCount > 1) valueAxis->setTickCount(spec.tickCount);
+        valueAxis->setMinorTickCount(spec.minorTickCount);
+        valueAxis->setMinorGridLineVisible(settings.showMinorGrid && spec.minorTickCount > 0);
+        if (!spec.labelFormat.isEmpty()) valueAxis->setLabelFormat(spec.labelFormat);
+        axis = valueAxis;
+    }
+    axis->setLabelsFont(tickFont);
+    axis->setTitleFont(titleFont);
+    axis->setTitleText(settings.showAxisTitles ? spec.title : QString());
+    axis->setLabelsVisible(settings.showAxisLabels);
+    axis->setGridLineVisible(settings.showGrid);
+    return axis;
+}
+
+} // namespace
+
+PlotRenderer::PlotRenderer(const PlotRenderModel &model)
+    : m_model(model)
+{
+}
+
+// One row per treatment (and variable, when several are plotted), pairing the
+// simulated line with the observed marker as the on-screen legend does. Ensemble bands
+// and mean lines are represented by their median.
+QVector<PlotRenderer::LegendRow> PlotRenderer::legendRows() const
+{
+    QStringList variables;
+    for (const PlotData &pd : m_model.plotData)
+        if (!variables.contains(pd.variable)) variables.append(pd.variable);
+
+    QVector<LegendRow> rows;
+    QHash<QString, int> rowIndex;
+    for (const PlotData &pd : m_model.plotData) {
+        if (pd.points.isEmpty()) continue;
+        if (!pd.ensembleRole.isEmpty() && pd.ensembleRole != "P50") continue;
+
+        QString label = pd.treatmentName.isEmpty() ? pd.treatment : pd.treatmentName;
+        if (variables.size() > 1) label += " - " + pd.variable;
+        auto it = rowIndex.constFind(label);
+        if (it == rowIndex.constEnd()) {
+            it = rowIndex.insert(label, rows.size());
+            rows.append(LegendRow());
+            rows.last().label = label;
+        }
+        LegendRow &row = rows[it.value()];
+        if (pd.isObserved) {
+            row.hasMarker = true;
+            row.markerPen = pd.pen;
+            row.markerBrush = pd.brush;
+            row.symbol = pd.symbol;
+        } else {
+            row.hasLine = true;
+            row.linePen = pd.pen;
+        }
+    }
+    return rows;
+}
+
+QSizeF PlotRenderer::legendSize(const QVector<LegendRow> &rows) const
+{
+    if (rows.isEmpty()) return QSizeF();
+    QFontMetricsF fm(QFont(m_model.settings.fontFamily, m_model.settings.legendFontSize));
+    double textWidth = 0.0;
+    for (const LegendRow &row : rows)
+        textWidth = qMax(textWidth, fm.horizontalAdvance(row.label));
+    const double rowHeight = qMax(fm.height(), double(m_model.settings.markerSize) + 2.0);
+    return QSizeF(2 * LEGEND_PADDING + LEGEND_SAMPLE_WIDTH + 6.0 + textWidth,
+                  2 * LEGEND_PADDING + rows.size() * rowHeight + (rows.size() - 1) * LEGEND_ROW_SPACING);
+}
+
+void PlotRenderer::paintLegend(QPainter *painter, const QVector<LegendRow> &rows, const QRectF &box) const
+{
+    const QFont font(m_model.settings.fontFamily, m_model.settings.legendFontSize);
+    QFontMetricsF fm(font);
+    const double rowHeight = qMax(fm.height(), double(m_model.settings.markerSize) + 2.0);
+
+    painter->save();
+    QColor background = m_model.settings.legendBackgroundColor;
+    if (background.alpha() == 0) background = QColor(255, 255, 255, 230);
+    painter->setPen(QColor(180, 180, 180));
+    painter->setBrush(background);
+    painter->drawRect(box);
+    painter->setFont(font);
+
+    double y = box.top() + LEGEND_PADDING;
+    for (const LegendRow &row : rows) {
+        const double cy = y + rowHeight / 2.0;
+        const double sx = box.left() + LEGEND_PADDING;
+        if (row.hasLine) {
+            painter->setPen(row.linePen);
+            painter->setBrush(Qt::NoBrush);
+            painter->drawLine(QPointF(sx, cy), QPointF(sx + LEGEND_SAMPLE_WIDTH, cy));
+        }
+        if (row.hasMarker) {
+            painter->setPen(row.markerPen);
+            painter->setBrush(row.markerBrush);
+            drawMarker(painter, QPointF(sx + LEGEND_SAMPLE_WIDTH / 2.0, cy),
+                       m_model.settings.markerSize, row.symbol);
+        }
+        painter->setPen(Qt::black);
+        painter->drawText(QRectF(sx + LEGEND_SAMPLE_WIDTH + 6.0, y, box.right() - sx, rowHeight),
+                          Qt::AlignLeft | Qt::AlignVCenter, row.label);
+        y += rowHeight + LEGEND_ROW_SPACING;
+    }
+    painter->restore();
+}
+
+// Error bars of observed series, mapped through the laid-out chart
+void PlotRenderer::paintErrorBars(QPainter *painter, QChart *chart) const
+{
+    const QList<QAbstractSeries*> seriesList = chart->series();
+    painter->save();
+    painter->setClipRect(chart->plotArea());
+    for (QAbstractSeries *series : seriesList) {
+        const int index = series->property("render_index").toInt();
+        if (index < 0 || index >= m_model.plotData.size()) continue;
+        const PlotData &pd = m_model.plotData[index];
+        if (!pd.isObserved || pd.errorBars.isEmpty()) continue;
+
+        painter->setPen(QPen(pd.color, m_model.settings.errorBarLineWidth));
+        const double cap = m_model.settings.errorBarCapWidth;
+        for (const ErrorBarData &eb : pd.errorBars) {
+            const QPointF top = chart->mapToPosition(QPointF(eb.meanX, eb.meanY + eb.errorValue), series);
+            const QPointF bottom = chart->mapToPosition(QPointF(eb.meanX, eb.meanY - eb.errorValue), series);
+            painter->drawLine(top, bottom);
+            painter->drawLine(QPointF(top.x() - cap, top.y()), QPointF(top.x() + cap, top.y()));
+            painter->drawLine(QPointF(bottom.x() - cap, bottom.y()), QPointF(bottom.x() + cap, bottom.y()));
+        }
+    }
+    painter->restore();
+}
+
+void PlotRenderer::paint(QPainter *painter, const QSizeF &size) const
+{
+    GB2_TRACE_SCOPE("export: render");
+    const PlotSettings &settings = m_model.settings;
+    const QVector<LegendRow> rows = m_model.showLegend ? legendRows() : QVector<LegendRow>();
+    const QSizeF legendBox = legendSize(rows);
+    const bool legendOutside = !rows.isEmpty() && settings.legendPosition == "outside-right";
+
+    QRectF chartRect(QPointF(0, 0), size);
+    if (legendOutside)
+        chartRect.setWidth(qMax(size.width() / 2.0, size.width() - legendBox.width() - 2 * LEGEND_PADDING));
+
+    // The scene owns the chart; the chart owns series and axes
+    QGraphicsScene scene;
+    QChart *chart = new QChart();
+    scene.addItem(chart);
+    chart->legend()->setVisible(false);
+    chart->setBackgroundBrush(QBrush(settings.backgroundColor));
+    chart->setPlotAreaBackgroundBrush(QBrush(settings.plotAreaColor));
+    chart->setPlotAreaBackgroundVisible(true);
+    chart->setBackgroundRoundness(0);
+    chart->setMargins(QMargins(0, 0, 0, 0));
+    chart->setAnimationOptions(QChart::NoAnimation);
+    if (!m_model.title.isEmpty()) {
+        QFont titleFont(settings.fontFamily, settings.titleFontSize);
+        titleFont.setBold(settings.boldTitle);
+        chart->setTitleFont(titleFont);
+        chart->setTitle(m_model.title);
+    }
+
+    QAbstractAxis *xAxis = createAxis(m_model.xAxis, settings);
+    QAbstractAxis *yAxis = createAxis(m_model.yAxis, settings);
+    chart->addAxis(xAxis, Qt::AlignBottom);
+    chart->addAxis(yAxis, Qt::AlignLeft);
+    for (QAbstractAxis *axis : { xAxis, yAxis }) {
+        axis->setLinePen(QPen(settings.axisLineColor.isValid() ? settings.axisLineColor : QColor(Qt::black)));
+        axis->setLabelsBrush(QBrush(Qt::black));
+    }
+
+    for (int i = 0; i < m_model.plotData.size(); ++i) {
+        const PlotData &pd = m_model.plotData[i];
+        if (pd.points.isEmpty()) continue;
+
+        QAbstractSeries *series = nullptr;
+        if (!pd.lowerPoints.isEmpty()) {
+            auto *upper = new QLineSeries();
+            auto *lower = new QLineSeries();
+            upper->replace(pd.points);
+            lower->replace(pd.lowerPoints);
+            auto *area = new QAreaSeries(upper, lower);
+            upper->setParent(area);
+            lower->setParent(area);
+            area->setPen(Qt::NoPen);
+            area->setBrush(pd.brush);
+            series = area;
+        } else if (pd.isObserved) {
+            auto *scatter = new QScatterSeries();
+            scatter->setMarkerShape(markerShapeFor(pd.symbol));
+            scatter->setMarkerSize(settings.markerSize);
+            scatter->setPen(pd.pen);
+            scatter->setBrush(pd.brush);
+            scatter->replace(pd.points);
+            series = scatter;
+        } else {
+            auto *line = new QLineSeries();
+            line->setPen(pd.pen);
+            line->replace(pd.points);
+            series = line;
+        }
+        series->setUseOpenGL(false);
+        series->setProperty("render_index", i);
+        chart->addSeries(series);
+        series->attachAxis(xAxis);
+        series->attachAxis(yAxis);
+    }
+
+    // Synchronous layout at the target geometry — no event loop involved
+    chart->setGeometry(chartRect);
+    if (chart->layout()) chart->layout()->activate();
+
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, true);
+    painter->setRenderHint(QPainter::TextAntialiasing, true);
+    painter->fillRect(QRectF(QPointF(0, 0), size), settings.backgroundColor);
+    scene.render(painter, chartRect, chartRect);
+    paintErrorBars(painter, chart);
+
+    if (!rows.isEmpty()) {
+        QRectF box;
+        if (legendOutside) {
+            box = QRectF(QPointF(chartRect.right() + LEGEND_PADDING,
+                                 (size.height() - legendBox.height()) / 2.0), legendBox);
+        } else {
+            // Top-left corner at legendX/legendY percent of the plot area, kept inside it
+            const QRectF area = chart->plotArea();
+            double x = area.left() + settings.legendX / 100.0 * area.width();
+            double y = area.top() + settings.legendY / 100.0 * area.height();
+            x = qBound(area.left(), x, qMax(area.left(), area.right() - legendBox.width()));
+            y = qBound(area.top(), y, qMax(area.top(), area.bottom() - legendBox.height()));
+            box = QRectF(QPointF(x, y), legendBox);
+        }
+        paintLegend(painter, rows, box);
+    }
+    painter->restore();
+}
+
+QImage PlotRenderer::renderImage(const QSize &size, int dpi) const
+{
+    // Supersample via device pixel ratio so text and lines are drawn at the target DPI
+    const double scale = qMax(1.0, dpi / 96.0);
+    QImage image(size * scale, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(scale);
+    image.fill(Qt::white);
+    {
+        QPainter painter(&image);
+        paint(&painter, QSizeF(size));
+    }
+    const int dotsPerMeter = qRound(dpi / 0.0254);
+    image.setDotsPerMeterX(dotsPerMeter);
+    image.setDotsPerMeterY(dotsPerMeter);
+    return image;
+}
+
+bool PlotRenderer::renderPdf(const QString &filePath, const QSize &size) const
+{
+    // Device units = logical pixels (96/inch); text and lines stay vectors
+    QPdfWriter writer(filePath);
+    writer.setResolution(96);
+    writer.setPageSize(QPageSize(QSizeF(size.width() * 25.4 / 96.0, size.height() * 25.4 / 96.0),
+                                 QPageSize::Millimeter));
+    writer.setPageMargins(QMarginsF(0, 0, 0, 0));
+    QPainter painter(&writer);
+    if (!painter.isActive()) {
+        qWarning() << "PlotRenderer: cannot write PDF" << filePath;
+        return false;
+    }
+    paint(&painter, QSizeF(size));
+    return painter.end();
+}
+
+bool PlotRenderer::save(const QString &filePath, const QString &format, const QSize &size, int dpi) const
+{
+    if (size.isEmpty()) return false;
+    if (filePath.endsWith(".pdf", Qt::CaseInsensitive))
+        return renderPdf(filePath, size);
+    return saveImage(renderImage(size, dpi), filePath, format);
+}
+
+bool PlotRenderer::saveImage(const QImage &image, const QString &filePath, const QString &format)
+{
+    GB2_TRACE_SCOPE("export: encode");
+    const bool jpeg = format.compare("JPG", Qt::CaseInsensitive) == 0 ||
+                      format.compare("JPEG", Qt::CaseInsensitive) == 0;
+    const QImage out = jpeg ? image.convertToFormat(QImage::Format_RGB32) : image;
+    if (!out.save(filePath, format.toUtf8().constData(), jpeg ? 95 : -1)) {
+        qWarning() << "PlotRenderer: cannot write" << filePath;
+        return false;
+    }
+    return true;
+}
@@ -46,12 +46,16 @@ PlotSettings PlotSettingsDialog::getSettings() const
     settings.showHoverTooltip = m_showHoverTooltipCheckBox->isChecked();
     settings.multiPanelTimeSeries = m_multiPanelTSCheckBox->isChecked();
     settings.rememberLastCropFolder = m_rememberLastCropFolderCheckBox->isChecked();
+    settings.memoryBudgetMB = m_memoryBudgetSpinBox->value();
     settings.legendPosition = "outside-right";
     settings.plotMeanReps = m_plotMeanRepsCheckBox->isChecked();
     settings.showErrorBars = m_showErrorBarsCheckBox->isChecked();
     settings.errorBarType = m_errorBarTypeComboBox->currentData().toString();
     settings.showSnapshot = m_showSnapshotCheckBox->isChecked();
     settings.lineWidth = m_lineWidthSpinBox->value();
+    settings.rasterSeriesBudget = m_rasterSeriesBudgetSpinBox->value();
+    settings.rasterPointBudgetK = m_rasterPointBudgetSpinBox->value();
+    settings.ensembleRunThreshold = m_ensembleRunThresholdSpinBox->value();
     settings.markerSize = m_markerSizeSpinBox->value();
     settings.errorBarCapWidth  = m_errorBarCapWidthSpinBox->value();
     settings.errorBarLineWidth = m_errorBarLineWidthSpinBox->value();
@@ -95,6 +99,9 @@ PlotSettings PlotSettingsDialog::getSettings() const
         if (it.value()->isChecked())
             settings.scatterMetrics.insert(it.key());
     }
+    settings.scatterDensityThreshold = m_scatterDensityThresholdSpinBox->value();
+    settings.scatterDensityShape = m_scatterDensityShapeComboBox->currentData().toString();
+    settings.scatterDensityBins = m_scatterDensityBinsSpinBox->value();
 
     // Time series panel metrics — collect checked items
     settings.tsMetrics.clear();
@@ -102,6 +109,7 @@ PlotSettings PlotSettingsDialog::getSettings() const
         if (it.value()->isChecked())
             settings.tsMetrics.insert(it.key());
     }
+    settings.bootstrapResamples = m_bootstrapResamplesSpinBox->value();
 
     // Preserve treatment filter and available data unchanged
     settings.excludedSeriesKeys = m_settings.excludedSeriesKeys;
@@ -319,6 +327,19 @@ void PlotSettingsDialog::setupUI()
     m_rememberLastCropFolderCheckBox->setToolTip("Automatically re-select the last used crop folder when the application starts");
     layoutGroupLayout->addWidget(m_rememberLastCropFolderCheckBox);
 
+    QHBoxLayout *memoryBudgetLayout = new QHBoxLayout();
+    memoryBudgetLayout->addWidget(new QLabel("Memory budget for loaded data:"));
+    m_memoryBudgetSpinBox = new QSpinBox();
+    m_memoryBudgetSpinBox->setRange(0, 1024 * 1024);
+    m_memoryBudgetSpinBox->setSingleStep(256);
+    m_memoryBudgetSpinBox->setSuffix(" MB");
+    m_memoryBudgetSpinBox->setSpecialValueText("Unlimited");
+    m_memoryBudgetSpinBox->setValue(m_settings.memoryBudgetMB);
+    m_memoryBudgetSpinBox->setToolTip("Above this, plot caches are dropped and outfiles that would not fit are refused instead of loaded");
+    memoryBudgetLayout->addWidget(m_memoryBudgetSpinBox);
+    memoryBudgetLayout->addStretch();
+    layoutGroupLayout->addLayout(memoryBudgetLayout);
+
     appearanceLayout->addWidget(layoutGroup);
 
     // Legend settings group
@@ -385,6 +406,35 @@ void PlotSettingsDialog::setupUI()
     }
     appearanceLayout->addWidget(scatterMetricsGroup);
 
+    // Scatter density group
+    QGroupBox *scatterDensityGroup = new QGroupBox("Scatter Panel Density");
+    QGridLayout *scatterDensityLayout = new QGridLayout(scatterDensityGroup);
+    scatterDensityGroup->setToolTip("Bin very dense scatter panels into a colour-mapped density layer");
+
+    scatterDensityLayout->addWidget(new QLabel("Density Above (points):"), 0, 0);
+    m_scatterDensityThresholdSpinBox = new QSpinBox();
+    m_scatterDensityThresholdSpinBox->setRange(0, 10000000);
+    m_scatterDensityThresholdSpinBox->setSingleStep(1000);
+    m_scatterDensityThresholdSpinBox->setSpecialValueText("Never");
+    m_scatterDensityThresholdSpinBox->setValue(m_settings.scatterDensityThreshold);
+    scatterDensityLayout->addWidget(m_scatterDensityThresholdSpinBox, 0, 1);
+
+    scatterDensityLayout->addWidget(new QLabel("Bin Shape:"), 1, 0);
+    m_scatterDensityShapeComboBox = new QComboBox();
+    m_scatterDensityShapeComboBox->addItem("Hexagon", "hex");
+    m_scatterDensityShapeComboBox->addItem("Square", "square");
+    int densityShapeIndex = m_scatterDensityShapeComboBox->findData(m_settings.scatterDensityShape);
+    if (densityShapeIndex >= 0)
+        m_scatterDensityShapeComboBox->setCurrentIndex(densityShapeIndex);
+    scatterDensityLayout->addWidget(m_scatterDensityShapeComboBox, 1, 1);
+
+    scatterDensityLayout->addWidget(new QLabel("Bins Across Axis:"), 2, 0);
+    m_scatterDensityBinsSpinBox = new QSpinBox();
+    m_scatterDensityBinsSpinBox->setRange(5, 200);
+    m_scatterDensityBinsSpinBox->setValue(m_settings.scatterDensityBins);
+    scatterDensityLayout->addWidget(m_scatterDensityBinsSpinBox, 2, 1);
+    appearanceLayout->addWidget(scatterDensityGroup);
+
     // Time series panel metrics group (shown in multi-panel mode per variable)
     QGroupBox *tsMetricsGroup = new QGroupBox("Time Series Panel Metrics");
     QGridLayout *tsMetricsLayout = new QGridLayout(tsMetricsGroup);
@@ -402,6 +452,20 @@ void PlotSettingsDialog::setupUI()
     }
     appearanceLayout->addWidget(tsMetricsGroup);
 
+    // Confidence intervals group
+    QGroupBox *ciGroup = new QGroupBox("Metric Confidence Intervals");
+    QHBoxLayout *ciLayout = new QHBoxLayout(ciGroup);
+    ciLayout->addWidget(new QLabel("Bootstrap Resamples:"));
+    m_bootstrapResamplesSpinBox = new QSpinBox();
+    m_bootstrapResamplesSpinBox->setRange(0, 100000);
+    m_bootstrapResamplesSpinBox->setSingleStep(500);
+    m_bootstrapResamplesSpinBox->setSpecialValueText("Off");
+    m_bootstrapResamplesSpinBox->setValue(m_settings.bootstrapResamples);
+    m_bootstrapResamplesSpinBox->setToolTip("Resamples for the 95% bootstrap intervals of RMSE, d-stat and R²; fewer is faster, Off leaves the intervals out");
+    ciLayout->addWidget(m_bootstrapResamplesSpinBox);
+    ciLayout->addStretch();
+    appearanceLayout->addWidget(ciGroup);
+
     // Plot appearance group
     QGroupBox *plotGroup = new QGroupBox("Plot Appearance");
     QGridLayout *plotLayout = new QGridLayout(plotGroup);
@@ -458,6 +522,30 @@ void PlotSettingsDialog::setupUI()
     m_lineWidthSpinBox->setRange(1, 10);
     m_lineWidthSpinBox->setValue(m_settings.lineWidth);
     lineLayout->addWidget(m_lineWidthSpinBox, 0, 1);
+
+    lineLayout->addWidget(new QLabel("Raster Lines Above (series):"), 1, 0);
+    m_rasterSeriesBudgetSpinBox = new QSpinBox();
+    m_rasterSeriesBudgetSpinBox->setRange(0, 100000);
+    m_rasterSeriesBudgetSpinBox->setSpecialValueText("Never");
+    m_rasterSeriesBudgetSpinBox->setValue(m_settings.rasterSeriesBudget);
+    m_rasterSeriesBudgetSpinBox->setToolTip("Draw simulated lines as one image when more series than this are plotted");
+    lineLayout->addWidget(m_rasterSeriesBudgetSpinBox, 1, 1);
+
+    lineLayout->addWidget(new QLabel("Raster Lines Above (thousand points):"), 2, 0);
+    m_rasterPointBudgetSpinBox = new QSpinBox();
+    m_rasterPointBudgetSpinBox->setRange(0, 1000000);
+    m_rasterPointBudgetSpinBox->setSpecialValueText("Never");
+    m_rasterPointBudgetSpinBox->setValue(m_settings.rasterPointBudgetK);
+    m_rasterPointBudgetSpinBox->setToolTip("Draw simulated lines as one image when they hold more points than this");
+    lineLayout->addWidget(m_rasterPointBudgetSpinBox, 2, 1);
+
+    lineLayout->addWidget(new QLabel("Ensemble Bands Above (runs):"), 3, 0);
+    m_ensembleRunThresholdSpinBox = new QSpinBox();
+    m_ensembleRunThresholdSpinBox->setRange(0, 100000);
+    m_ensembleRunThresholdSpinBox->setSpecialValueText("Never");
+    m_ensembleRunThresholdSpinBox->setValue(m_settings.ensembleRunThreshold);
+    m_ensembleRunThresholdSpinBox->setToolTip("Summarise simulated runs as P5–P95 / P25–P75 bands and a median line when a treatment has more runs than this");
+    lineLayout->addWidget(m_ensembleRunThresholdSpinBox, 3, 1);
     
     linesMarkersLayout->addWidget(lineGroup);
     
@@ -644,6 +732,7 @@ void PlotSettingsDialog::onResetDefaults()
     m_showHoverTooltipCheckBox->setChecked(defaults.showHoverTooltip);
     m_multiPanelTSCheckBox->setChecked(defaults.multiPanelTimeSeries);
     m_rememberLastCropFolderCheckBox->setChecked(defaults.rememberLastCropFolder);
+    m_memoryBudgetSpinBox->setValue(defaults.memoryBudgetMB);
     m_showErrorBarsCheckBox->setChecked(defaults.showErrorBars);
     m_showSnapshotCheckBox->setChecked(defaults.showSnapshot);
     int defaultErrorBarIndex = m_errorBarTypeComboBox->findData(defaults.errorBarType);
@@ -651,6 +740,13 @@ void PlotSettingsDialog::onResetDefaults()
         m_errorBarTypeComboBox->setCurrentIndex(defaultErrorBarIndex);
     }
     m_lineWidthSpinBox->setValue(defaults.lineWidth);
+    m_rasterSeriesBudgetSpinBox->setValue(defaults.rasterSeriesBudget);
+    m_rasterPointBudgetSpinBox->setValue(defaults.rasterPointBudgetK);
+    m_ensembleRunThresholdSpinBox->setValue(defaults.ensembleRunThreshold);
+    m_scatterDensityThresholdSpinBox->setValue(defaults.scatterDensityThreshold);
+    m_scatterDensityShapeComboBox->setCurrentIndex(m_scatterDensityShapeComboBox->findData(defaults.scatterDensityShape));
+    m_scatterDensityBinsSpinBox->setValue(defaults.scatterDensityBins);
+    m_bootstrapResamplesSpinBox->setValue(defaults.bootstrapResamples);
     m_markerSizeSpinBox->setValue(defaults.markerSize);
     m_errorBarCapWidthSpinBox->setValue(defaults.errorBarCapWidth);
     m_errorBarLineWidthSpinBox->setValue(defaults.errorBarLineWidth);
@@ -4,8 +4,10 @@
 #include <QStandardPaths>
 #include <QVector>
 #include "PlotWidget.h"
+#include "PlotRenderer.h"
 #include "MetricsCalculator.h"
 #include "Config.h"
+#include "Trace.h"
 #include <cmath>
 #include <algorithm>
 #include <numeric>
@@ -43,11 +45,38 @@
 #include <QDrag>
 #include <QMimeData>
 #include <QBuffer>
+#include <QCryptographicHash>
+#include <QGraphicsScene>
 #include <algorithm>
 #include <cmath>
 
 // ErrorBarChartView implementation → see PlotWidget_ErrorBar.cpp
 
+namespace {
+// Takes a chart out of its view's scene for a batch of series and axis changes and puts
+// it back when done. Out of the scene, series, axis and legend-marker items update no
+// scene index and schedule no paints; the layout requests they post run once, after.
+// Nested batches are no-ops.
+class DetachedChart {
+public:
+    explicit DetachedChart(QChart *chart)
+        : m_chart(chart), m_scene(chart ? chart->scene() : nullptr)
+    {
+        if (m_scene) m_scene->removeItem(m_chart);
+    }
+    ~DetachedChart()
+    {
+        if (m_scene) m_scene->addItem(m_chart);
+    }
+    DetachedChart(const DetachedChart &) = delete;
+    DetachedChart &operator=(const DetachedChart &) = delete;
+
+private:
+    QChart *m_chart;
+    QGraphicsScene *m_scene;
+};
+} // namespace
+
 PlotWidget::PlotWidget(QWidget *parent)
     : QWidget(parent)
     , m_mainLayout(nullptr)
@@ -101,6 +130,14 @@ PlotWidget::PlotWidget(QWidget *parent)
     m_autoFitTimer->setSingleShot(true);
     m_autoFitTimer->setInterval(100);  // 100ms delay for auto-fit
     connect(m_autoFitTimer, &QTimer::timeout, this, &PlotWidget::autoFitAxes);
+    m_lodTimer = new QTimer(this);
+    m_lodTimer->setSingleShot(true);
+    m_lodTimer->setInterval(30);
+    connect(m_lodTimer, &QTimer::timeout, this, &PlotWidget::applyLevelOfDetail);
+    m_hoverTimer = new QTimer(this);
+    m_hoverTimer->setSingleShot(true);
+    m_hoverTimer->setInterval(16);  // one hover hit test per frame
+    connect(m_hoverTimer, &QTimer::timeout, this, &PlotWidget::processPendingHover);
     
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
 
@@ -448,6 +485,10 @@ void PlotWidget::setupChart()
     // Enable mouse tracking so MouseMove fires without a button held (needed for hover).
     m_chartView->setMouseTracking(true);
     m_chartView->viewport()->setMouseTracking(true);
+
+    // Re-decimate dense line series when the plot area is resized
+    connect(m_chart, &QChart::plotAreaChanged, this, &PlotWidget::scheduleLevelOfDetail);
+    connect(m_chart, &QChart::plotAreaChanged, this, &PlotWidget::invalidateHoverIndex);
     
     // Replace placeholder in left layout
     QLayoutItem* item = m_leftLayout->itemAt(0);
@@ -509,6 +550,7 @@ void PlotWidget::styleChart()
 
 void PlotWidget::setupAxes(const QString &xVar)
 {
+    GB2_TRACE_SCOPE("chart layout: axes");
     
     // Remove existing axes
     auto existingAxes = m_chart->axes();
@@ -636,7 +678,9 @@ void PlotWidget::autoFitAxes()
     
     for (auto s : series) {
         if (auto lineSeries = qobject_cast<QLineSeries*>(s)) {
-            auto points = lineSeries->points();
+            // Line series may hold a decimated, range-clipped copy — fit to the full data
+            auto pd = m_seriesToPlotData.value(s);
+            auto points = pd ? pd->points : lineSeries->points();
             for (const QPointF &point : points) {
                 minX = qMin(minX, point.x());
                 maxX = qMax(maxX, point.x());
@@ -653,6 +697,19 @@ void PlotWidget::autoFitAxes()
                 maxY = qMax(maxY, point.y());
                 hasData = true;
             }
+        } else if (qobject_cast<QAreaSeries*>(s)) {
+            // Ensemble band: both edges
+            auto pd = m_seriesToPlotData.value(s);
+            if (!pd) continue;
+            for (const QVector<QPointF> *edge : { &pd->points, &pd->lowerPoints }) {
+                for (const QPointF &point : *edge) {
+                    minX = qMin(minX, point.x());
+                    maxX = qMax(maxX, point.x());
+                    minY = qMin(minY, point.y());
+                    maxY = qMax(maxY, point.y());
+                    hasData = true;
+                }
+            }
         }
     }
     
@@ -1057,6 +1114,8 @@ void PlotWidget::resizeEvent(QResizeEvent *event)
         }
     }
 
+    scheduleLevelOfDetail();
+
     // Keep scatter panels square on window resize
     if (m_isScatterMode && m_scatterPanelContainer && m_scatterPanelContainer->isVisible())
         resizeScatterPanels();
@@ -1074,6 +1133,7 @@ void PlotWidget::plotTimeSeries(
     const QMap<QString, QMap<QString, QString>> &treatmentNames,
     const QMap<QString, QStringList> &yVarFileFilter)
 {
+    GB2_TRACE_SCOPE_ARG("plotTimeSeries", yVars.join(","));
     m_isScatterMode = false;
 
     // Restore legend panel (may have been hidden by scatter mode)
@@ -1091,6 +1151,9 @@ void PlotWidget::plotTimeSeries(
     }
 
     try {
+        // Park the current series before clear() drops them: a replot of the same data
+        // (treatment toggle, Plot button) reuses them through updatePlotWithScaling
+        if (!m_isBoxPlotMode) poolChartSeries();
         clear();  // also resets legend stack to page 0
 
         // Switch legend area to show the legend (page 1)
@@ -1098,6 +1161,7 @@ void PlotWidget::plotTimeSeries(
 
         m_simData = simData;
         m_obsData = obsData;
+        syncDataVersion();
         
         // Debug data assignment
         
@@ -1184,6 +1248,7 @@ void PlotWidget::plotTimeSeries(
 
         if (m_simData.rowCount == 0) {
             qWarning() << "PlotWidget: No simulated data available";
+            releaseSeriesPool();
             return;
         }
 
@@ -1204,6 +1269,7 @@ void PlotWidget::plotTimeSeries(
     } catch (const std::exception& e) {
         QString error = QString("Error in plotTimeSeries: %1").arg(e.what());
         qWarning() << error;
+        releaseSeriesPool();
         emit errorOccurred(error);
     }
 }
@@ -1234,93 +1300,38 @@ QMap<QString, QMap<QString, ScalingInfo>> PlotWidget::calculateScalingFactors(co
     QMap<QString, double> magnitudes;
     QMap<QString, double> maxValues;
     
-    // Collect statistics from both simulated and observed data
+    // Combine the cached column statistics of simulated and observed data
+    // (computed once per loaded column, not re-collected on every replot)
+    double targetMax = -std::numeric_limits<double>::infinity();
     for (const QString &var : yVars) {
-        QVector<double> values;
-        
-        // Collect values from simulated data
-        const DataColumn *simColumn = simData.getColumn(var);
-        if (simColumn) {
-            for (const QVariant &val : simColumn->data) {
-                if (!DataProcessor::isMissingValue(val)) {
-                    bool ok;
-                    double numVal = val.toDouble(&ok);
-                    if (ok) values.append(numVal);
-                }
-            }
-        }
+        ColumnStats stats;
+        if (const DataColumn *simColumn = simData.getColumn(var))
+            stats.merge(simColumn->stats());
+        if (const DataColumn *obsColumn = obsData.getColumn(var))
+            stats.merge(obsColumn->stats());
         
-        // Collect values from observed data
-        const DataColumn *obsColumn = obsData.getColumn(var);
-        if (obsColumn) {
-            for (const QVariant &val : obsColumn->data) {
-                if (!DataProcessor::isMissingValue(val)) {
-                    bool ok;
-                    double numVal = val.toDouble(&ok);
-                    if (ok) values.append(numVal);
-                }
-            }
-        }
-        
-        if (values.isEmpty()) {
+        if (stats.isEmpty()) {
             continue;
         }
-        
-        double minVal = *std::min_element(values.begin(), values.end());
-        double maxVal = *std::max_element(values.begin(), values.end());
+        targetMax = qMax(targetMax, stats.max);
         
         // Skip if constant values or very small range
-        if (qAbs(maxVal - minVal) < 1e-10) {
+        if (qAbs(stats.max - stats.min) < 1e-10) {
             continue;
         }
         
-        // Calculate magnitude (log10 of mean of absolute non-zero values)
-        QVector<double> absValues;
-        for (double val : values) {
-            if (qAbs(val) > 1e-10) {
-                absValues.append(qAbs(val));
-            }
-        }
-        
-        if (!absValues.isEmpty()) {
-            double meanAbs = std::accumulate(absValues.begin(), absValues.end(), 0.0) / absValues.size();
-            if (meanAbs > 0) {
-                magnitudes[var] = std::floor(std::log10(meanAbs));
-                maxValues[var] = maxVal;
-            } else {
-            }
-        } else {
+        // Magnitude = log10 of mean of absolute non-zero values
+        double magnitude = stats.magnitude();
+        if (std::isfinite(magnitude)) {
+            magnitudes[var] = magnitude;
+            maxValues[var] = stats.max;
         }
     }
     
-    // Find target maximum from all data
-    QVector<double> allMaxes;
-    for (const QString &var : yVars) {
-        const DataColumn *simColumn = simData.getColumn(var);
-        if (simColumn) {
-            for (const QVariant &val : simColumn->data) {
-                if (!DataProcessor::isMissingValue(val)) {
-                    bool ok;
-                    double numVal = val.toDouble(&ok);
-                    if (ok) allMaxes.append(numVal);
-                }
-            }
-        }
-        
-        const DataColumn *obsColumn = obsData.getColumn(var);
-        if (obsColumn) {
-            for (const QVariant &val : obsColumn->data) {
-                if (!DataProcessor::isMissingValue(val)) {
-                    bool ok;
-                    double numVal = val.toDouble(&ok);
-                    if (ok) allMaxes.append(numVal);
-                }
-            }
-        }
+    // Target maximum from all data
+    if (!std::isfinite(targetMax)) {
+        targetMax = std::numeric_limits<double>::infinity();
     }
-    
-    double targetMax = allMaxes.isEmpty() ? std::numeric_limits<double>::infinity() : 
-                      *std::max_element(allMaxes.begin(), allMaxes.end());
     double targetThreshold = targetMax * 1.1;
     
     // Calculate scaling factors
@@ -1425,23 +1436,12 @@ DataTable PlotWidget::applyScaling(const DataTable &data, const QStringList &yVa
         }
         
 
+        // Scaling detaches this column from the caller's table, which keeps the
+        // unscaled values; no <var>_original copy is needed
         DataColumn *column = scaledData.getColumn(var);
         if (!column) {
             continue;
         }
-
-        QString originalVarName = var + "_original";
-        if (!scaledData.getColumn(originalVarName)) {
-            DataColumn originalColumn(originalVarName);
-            originalColumn.data = column->data;
-            scaledData.addColumn(originalColumn);
-            
-            // Get column reference again after adding backup column
-            column = scaledData.getColumn(var);
-            if (!column) {
-                continue;
-            }
-        }
         
         int scaledCount = 0;
         double sampleOriginal = 0, sampleScaled = 0;
@@ -1470,6 +1470,7 @@ DataTable PlotWidget::applyScaling(const DataTable &data, const QStringList &yVa
                 }
             }
         }
+        column->invalidateStats();
         if (hasSample) {
         }
     }
@@ -1477,74 +1478,102 @@ DataTable PlotWidget::applyScaling(const DataTable &data, const QStringList &yVa
     return scaledData;
 }
 
-QVector<ErrorBarData> PlotWidget::aggregateReplicates(const QVector<QPointF> &points, const QString &xVar, double xTolerance)
+// Sort-once group-by of replicate observations, read in place from the points.
+// Points are bucketed by x rounded to tolerance, ordered by (bucket, original index)
+// and reduced with Welford's update in one linear pass, so the output is already
+// x-sorted. singleIndex (optional) receives, per bar, the source index of n==1 groups
+// (-1 otherwise) so callers can attach pre-computed SD/SE values without re-matching.
+void PlotWidget::groupReplicates(const QVector<QPointF> &points, double tolerance,
+                                 QVector<ErrorBarData> &errorBars, QVector<int> *singleIndex)
 {
-    QVector<ErrorBarData> errorBars;
-    if (points.isEmpty()) return errorBars;
-    
-    // Determine appropriate tolerance based on X variable type
-    double effectiveTolerance = xTolerance;
-    if (xVar == "DATE") {
-        // For DATE, group by same day (24 hours = 86400000 milliseconds)
-        effectiveTolerance = 86400000.0;  // 1 day in milliseconds
-    }
-    
-    // Group points by X value (with tolerance)
-    QMap<double, QVector<double>> groups;  // Map of rounded X -> list of Y values
-    
-    for (const QPointF &point : points) {
-        // Round X to nearest tolerance to group replicates
-        double roundedX = qRound(point.x() / effectiveTolerance) * effectiveTolerance;
-        groups[roundedX].append(point.y());
-    }
-    
-    // Calculate statistics for each group
-    for (auto it = groups.begin(); it != groups.end(); ++it) {
-        const QVector<double> &yValues = it.value();
-        if (yValues.isEmpty()) continue;
-        
-        double meanX = it.key();
-        
-        // Calculate mean Y
-        double sumY = 0.0;
-        for (double y : yValues) {
-            sumY += y;
-        }
-        double meanY = sumY / yValues.size();
-        
-        // Calculate standard deviation
-        double sumSquaredDiff = 0.0;
-        for (double y : yValues) {
-            double diff = y - meanY;
-            sumSquaredDiff += diff * diff;
+    const QPointF *p = points.constData();
+    const int count = points.size();
+    errorBars.clear();
+    if (singleIndex) singleIndex->clear();
+    if (count <= 0 || tolerance <= 0.0) return;
+
+    struct Keyed { qint64 bucket; int index; };
+    QVector<Keyed> keyed(count);
+    for (int i = 0; i < count; ++i)
+        keyed[i] = { qRound64(p[i].x() / tolerance), i };
+    std::sort(keyed.begin(), keyed.end(), [](const Keyed &a, const Keyed &b) {
+        return a.bucket != b.bucket ? a.bucket < b.bucket : a.index < b.index;
+    });
+
+    errorBars.reserve(count);
+    if (singleIndex) singleIndex->reserve(count);
+    int i = 0;
+    while (i < count) {
+        const qint64 bucket = keyed[i].bucket;
+        int n = 0;
+        double mean = 0.0, m2 = 0.0;
+        int first = keyed[i].index;
+        for (; i < count && keyed[i].bucket == bucket; ++i) {
+            const double y = p[keyed[i].index].y();
+            ++n;
+            const double delta = y - mean;
+            mean += delta / n;
+            m2 += delta * (y - mean);
         }
-        double variance = yValues.size() > 1 ? sumSquaredDiff / (yValues.size() - 1) : 0.0;
-        double sd = qSqrt(variance);
-        
+
         ErrorBarData errorBar;
-        errorBar.meanX = meanX;
-        errorBar.meanY = meanY;
-        errorBar.errorValue = sd;  // Will be converted to SE later if needed
-        errorBar.n = yValues.size();
-        
+        errorBar.meanX = bucket * tolerance;
+        errorBar.meanY = mean;
+        errorBar.errorValue = n > 1 ? qSqrt(m2 / (n - 1)) : 0.0;  // SD; converted to SE later if needed
+        errorBar.n = n;
         errorBars.append(errorBar);
+        if (singleIndex) singleIndex->append(n == 1 ? first : -1);
     }
-    
-    // Sort by X value
-    std::sort(errorBars.begin(), errorBars.end(), 
-              [](const ErrorBarData &a, const ErrorBarData &b) {
-                  return a.meanX < b.meanX;
-              });
-    
+}
+
+QVector<ErrorBarData> PlotWidget::aggregateReplicates(const QVector<QPointF> &points, const QString &xVar, double xTolerance)
+{
+    QVector<ErrorBarData> errorBars;
+    if (points.isEmpty()) return errorBars;
+
+    // For DATE, group by same day (24 hours = 86400000 milliseconds)
+    double effectiveTolerance = (xVar == "DATE") ? 86400000.0 : xTolerance;
+
+    groupReplicates(points, effectiveTolerance, errorBars, nullptr);
     return errorBars;
 }
 
+// Cached replicate grouping for one observed series. Entries are keyed by
+// x-variable + series identity, so switching DAS/DAP/DATE back and forth reuses
+// earlier groupings; the stored input points guard against stale data.
+const PlotWidget::ReplicateGroups &PlotWidget::replicateGroupsFor(const QString &seriesKey,
+                                                                  const QVector<QPointF> &points,
+                                                                  const QString &xVar)
+{
+    const QString cacheKey = xVar + "|" + seriesKey;
+    auto it = m_replicateCache.find(cacheKey);
+    if (it != m_replicateCache.end() && it->points == points)
+        return it.value();
+
+    if (m_replicateCache.size() >= MAX_REPLICATE_CACHE_ENTRIES)
+        m_replicateCache.clear();
+
+    ReplicateGroups groups;
+    groups.points = points;
+    double tolerance = (xVar == "DATE") ? 86400000.0 : 0.01;
+    groupReplicates(points, tolerance, groups.errorBars, &groups.singleIndex);
+    return m_replicateCache.insert(cacheKey, groups).value();
+}
+
 void PlotWidget::plotDatasets(const DataTable &simData, const DataTable &obsData,
                              const QString &xVar, const QStringList &yVars,
                              const QStringList &treatments, const QString &selectedExperiment,
                              const QMap<QString, QStringList> &yVarFileFilter)
 {
-    // Clear existing chart and set up appropriate axes
+    GB2_TRACE_SCOPE("plotDatasets");
+    // Series changes are batched off-scene and painted once the whole set is in place
+    DetachedChart batch(m_chart);
+    const bool suspendUpdates = updatesEnabled();
+    if (suspendUpdates) setUpdatesEnabled(false);
+
+    // Clear existing chart and set up appropriate axes; line/scatter series are kept
+    // aside for reuse by addSeriesToPlot
+    poolChartSeries();
     clearChart();
     setupAxes(xVar);
 
@@ -1561,16 +1590,84 @@ void PlotWidget::plotDatasets(const DataTable &simData, const DataTable &obsData
         }
     }
     
-    if (!m_chart) return;
+    if (!m_chart) {
+        if (suspendUpdates) setUpdatesEnabled(true);
+        return;
+    }
     
     // Clear all series (already done in clearChart(), but ensure it's cleared)
-    m_chart->removeAllSeries();
+    removeUnpooledSeries();
     
     // Clear error bars when replotting
     if (m_chartView) {
         m_chartView->setErrorBarData(QMap<QAbstractSeries*, QVector<ErrorBarData>>());
     }
     
+    // PlotData for this request: cached model when the same configuration was built
+    // before, otherwise a fresh build
+    QVector<PlotData> plotDataList = plotModelFor(simData, obsData, xVar, yVars, treatments,
+                                                  selectedExperiment, yVarFileFilter);
+
+    // Compute axis breaks (DATE x-axis only) — must happen before setupAxes so
+    // setupAxes can pick QValueAxis vs QDateTimeAxis based on whether breaks exist.
+    computeAxisBreaks(plotDataList);
+
+    // If breaks were found, re-run setupAxes now that m_axisBreaks is populated
+    // (the first call at the top of plotDatasets saw empty m_axisBreaks).
+    if (!m_axisBreaks.isEmpty()) {
+        // Remove axes created by the first setupAxes call
+        for (auto *axis : m_chart->axes())
+            m_chart->removeAxis(axis);
+        setupAxes(xVar);
+
+        // Remap all x-coordinates to virtual space. rawPoints and error-bar
+        // meanX must be remapped too so downstream obs/sim pairing (TS panel
+        // metrics, animation metrics) compares like-for-like coordinates.
+        for (PlotData &pd : plotDataList) {
+            for (QPointF &pt : pd.points)
+                pt.setX(remapX(pt.x()));
+            for (QPointF &pt : pd.rawPoints)
+                pt.setX(remapX(pt.x()));
+            for (QPointF &pt : pd.lowerPoints)
+                pt.setX(remapX(pt.x()));
+            for (ErrorBarData &eb : pd.errorBars)
+                eb.meanX = remapX(eb.meanX);
+        }
+    }
+
+    // Add series to chart
+    addSeriesToPlot(plotDataList);
+
+    // Initialise animation frames from the newly built plot data
+    if (!m_isScatterMode) initAnimFrames();
+    
+    // Update error bar data in chart view (ONLY for observed data series, never for simulated data)
+    // Always render if pre-computed SD/SE columns were found, regardless of showErrorBars setting
+    if (m_chartView) {
+        QMap<QAbstractSeries*, QVector<ErrorBarData>> errorBarMap;
+        for (const QSharedPointer<PlotData> &plotData : m_plotDataList) {
+            if (plotData && plotData->isObserved && plotData->series && !plotData->errorBars.isEmpty()) {
+                errorBarMap[plotData->series] = plotData->errorBars;
+            }
+        }
+        m_chartView->setErrorBarData(errorBarMap);
+    }
+    
+    // Update legend
+    updateLegend(plotDataList);
+
+    if (suspendUpdates) setUpdatesEnabled(true);
+}
+
+// Builds the PlotData of one plot request from the (scaled) tables: per-row keys, date
+// parsing, grouping by crop/experiment/treatment(/run), ensembles and error bars.
+// Points are in real x units; axis-break remapping happens afterwards.
+QVector<PlotData> PlotWidget::buildPlotModel(const DataTable &simData, const DataTable &obsData,
+                                             const QString &xVar, const QStringList &yVars,
+                                             const QStringList &treatments, const QString &selectedExperiment,
+                                             const QMap<QString, QStringList> &yVarFileFilter)
+{
+    GB2_TRACE_SCOPE("plot model build");
     // Clear treatment color map to ensure consistent color assignment
     m_treatmentColorMap.clear();
     
@@ -1800,6 +1897,11 @@ void PlotWidget::plotDatasets(const DataTable &simData, const DataTable &obsData
             }
         }
 
+        // Treatments with more runs than the ensemble threshold are summarised as
+        // percentile bands; their runs are collected here instead of each becoming a series
+        const int ensembleThreshold = simData.isObservedOnly ? 0 : m_plotSettings.ensembleRunThreshold;
+        QMap<QString, QVector<QVector<QPointF>>> ensembleRuns;
+
         // Create plot data for each experiment-treatment combination
         for (auto it = experimentTreatmentData.begin(); it != experimentTreatmentData.end(); ++it) {
             // Parse the crop-experiment-treatment-tname key
@@ -1819,6 +1921,12 @@ void PlotWidget::plotDatasets(const DataTable &simData, const DataTable &obsData
                     }
                 }
             }
+            QString baseKey = QString("%1__%2__%3").arg(crop).arg(experiment).arg(treatment);
+            if (ensembleThreshold > 0 && !runPart.isEmpty()
+                && baseKeyToRunCount.value(baseKey, 0) > ensembleThreshold) {
+                ensembleRuns[baseKey].append(it.value());
+                continue;
+            }
             
             PlotData plotData;
             plotData.crop = crop;
@@ -1836,7 +1944,6 @@ void PlotWidget::plotDatasets(const DataTable &simData, const DataTable &obsData
                 plotData.treatmentName = getTreatmentDisplayName(treatment, experiment, crop);
             }
             // Only append RUN if there are multiple runs under the same crop+experiment+treatment
-            QString baseKey = QString("%1__%2__%3").arg(crop).arg(experiment).arg(treatment);
             if (!runPart.isEmpty() && baseKeyToRunCount.value(baseKey, 0) > 1) {
                 plotData.treatmentName += QString(" (%1)").arg(runPart);
             }
@@ -1856,6 +1963,24 @@ void PlotWidget::plotDatasets(const DataTable &simData, const DataTable &obsData
 
             plotDataList.append(plotData);
         }
+
+        // One band set per ensemble treatment, named without a RUN suffix so it shares
+        // the legend row with the treatment's observed data
+        for (auto it = ensembleRuns.begin(); it != ensembleRuns.end(); ++it) {
+            QStringList keyParts = it.key().split("__");
+            PlotData base;
+            base.crop = keyParts[0];
+            base.experiment = keyParts[1];
+            base.treatment = keyParts[2];
+            base.treatmentName = getTreatmentDisplayName(base.treatment, base.experiment, base.crop);
+            base.variable = yVar;
+            base.color = getColorForTreatment(it.key(), colorIndex);
+            base.lineStyleIndex = yVars.indexOf(yVar);
+            base.symbolIndex = yVars.indexOf(yVar);
+            base.isObserved = false;
+            colorIndex++;
+            plotDataList += ensemblePlotData(base, summariseEnsemble(it.value()));
+        }
     }
     
     // Collect treatment keys from simulated data to filter observed data
@@ -2029,28 +2154,19 @@ void PlotWidget::plotDatasets(const DataTable &simData, const DataTable &obsData
                 if ((m_plotSettings.showErrorBars || hasPreComputedErr) && it.value().size() > 0) {
                     const QVector<double> &preValues  = experimentTreatmentSD.value(it.key());
                     const QVector<bool>   &preIsSE    = experimentTreatmentIsPreSE.value(it.key());
-                    QVector<ErrorBarData> errorBars = aggregateReplicates(it.value(), xVar);
-
-                    // For groups with n==1 and no computed SD, fill from SD_VAR or SE_VAR column.
-                    // Build a map from rounded X → pre-computed value so we can match regardless
-                    // of x-axis units (epoch ms for DATE, plain numeric for DAS/DAP etc.)
-                    double tol = (xVar == "DATE") ? 86400000.0 : 0.01;
-                    QMap<double, double> xToPreVal;
-                    QMap<double, bool>   xToIsSE;
-                    for (int pi = 0; pi < it.value().size() && pi < preValues.size(); ++pi) {
-                        if (!std::isnan(preValues[pi])) {
-                            double rx = qRound(it.value()[pi].x() / tol) * tol;
-                            xToPreVal[rx] = preValues[pi];
-                            xToIsSE[rx]   = (pi < preIsSE.size()) ? preIsSE[pi] : false;
-                        }
-                    }
-                    for (ErrorBarData &errorBar : errorBars) {
+                    const ReplicateGroups &groups = replicateGroupsFor(
+                        yVar + "|" + it.key(), it.value(), xVar);
+                    QVector<ErrorBarData> errorBars = groups.errorBars;
+
+                    // For groups with n==1 and no computed SD, fill from SD_VAR or SE_VAR column
+                    // using the source row the grouping recorded for that bar.
+                    for (int bi = 0; bi < errorBars.size() && bi < groups.singleIndex.size(); ++bi) {
+                        ErrorBarData &errorBar = errorBars[bi];
+                        const int pi = groups.singleIndex[bi];
+                        if (pi < 0 || pi >= preValues.size() || std::isnan(preValues[pi])) continue;
                         if (errorBar.n == 1 && qFuzzyIsNull(errorBar.errorValue)) {
-                            double rx = qRound(errorBar.meanX / tol) * tol;
-                            if (xToPreVal.contains(rx)) {
-                                errorBar.errorValue      = xToPreVal[rx];
-                                errorBar.preComputedIsSE = xToIsSE[rx];
-                            }
+                            errorBar.errorValue      = preValues[pi];
+                            errorBar.preComputedIsSE = (pi < preIsSE.size()) ? preIsSE[pi] : false;
                         }
                     }
 
@@ -2098,53 +2214,163 @@ void PlotWidget::plotDatasets(const DataTable &simData, const DataTable &obsData
             }
         }
     }
-    
 
-    // Compute axis breaks (DATE x-axis only) — must happen before setupAxes so
-    // setupAxes can pick QValueAxis vs QDateTimeAxis based on whether breaks exist.
-    computeAxisBreaks(plotDataList);
+    return plotDataList;
+}
 
-    // If breaks were found, re-run setupAxes now that m_axisBreaks is populated
-    // (the first call at the top of plotDatasets saw empty m_axisBreaks).
-    if (!m_axisBreaks.isEmpty()) {
-        // Remove axes created by the first setupAxes call
-        for (auto *axis : m_chart->axes())
-            m_chart->removeAxis(axis);
-        setupAxes(xVar);
+// Hash of everything buildPlotModel reads: table version and shape, scaling applied to
+// the y columns, x/y variables, treatment and file filters, treatment display names,
+// palette, excluded series and the grouping/aggregation settings
+QByteArray PlotWidget::plotModelKey(const DataTable &simData, const DataTable &obsData,
+                                    const QString &xVar, const QStringList &yVars,
+                                    const QStringList &treatments, const QString &selectedExperiment,
+                                    const QMap<QString, QStringList> &yVarFileFilter) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    auto add = [&hash](const QString &part) {
+        hash.addData(part.toUtf8() + '\x1f');
+    };
 
-        // Remap all x-coordinates to virtual space. rawPoints and error-bar
-        // meanX must be remapped too so downstream obs/sim pairing (TS panel
-        // metrics, animation metrics) compares like-for-like coordinates.
-        for (PlotData &pd : plotDataList) {
-            for (QPointF &pt : pd.points)
-                pt.setX(remapX(pt.x()));
-            for (QPointF &pt : pd.rawPoints)
-                pt.setX(remapX(pt.x()));
-            for (ErrorBarData &eb : pd.errorBars)
-                eb.meanX = remapX(eb.meanX);
-        }
+    add(QString::number(m_dataVersion));
+    for (const DataTable *table : { &simData, &obsData }) {
+        add(table->tableName);
+        add(QString::number(table->rowCount));
+        add(table->isObservedOnly ? "T" : "F");
+        add(table->columnNames.join(','));
     }
+    for (const QString &yVar : yVars) {
+        // applyScaling detaches every column it scales from m_simData/m_obsData
+        auto scaled = [&yVar](const DataTable &table, const DataTable &source) {
+            const DataColumn *column = table.getColumn(yVar);
+            const DataColumn *unscaled = source.getColumn(yVar);
+            return column && unscaled && column->data.constData() != unscaled->data.constData();
+        };
+        const ScalingInfo info = m_scaleFactors.value("default").value(yVar);
+        add(QString("%1:%2:%3:%4:%5").arg(yVar)
+                .arg(scaled(simData, m_simData) ? 1 : 0)
+                .arg(scaled(obsData, m_obsData) ? 1 : 0)
+                .arg(info.scaleFactor, 0, 'g', 17).arg(info.offset, 0, 'g', 17));
+    }
+    add(xVar);
+    add(treatments.join(','));
+    add(selectedExperiment);
+    for (auto it = m_treatmentNames.constBegin(); it != m_treatmentNames.constEnd(); ++it)
+        for (auto name = it.value().constBegin(); name != it.value().constEnd(); ++name)
+            add(it.key() + '|' + name.key() + '=' + name.value());
+    QStringList palette;
+    for (const QColor &color : m_plotColors) palette.append(color.name(QColor::HexArgb));
+    add(palette.join(','));
+    for (auto it = yVarFileFilter.constBegin(); it != yVarFileFilter.constEnd(); ++it)
+        add(it.key() + '=' + it.value().join(','));
+    QStringList excluded(m_plotSettings.excludedSeriesKeys.begin(), m_plotSettings.excludedSeriesKeys.end());
+    excluded.sort();
+    add(excluded.join(','));
+    add(QString("%1|%2|%3|%4|%5").arg(m_plotSettings.plotMeanReps).arg(m_plotSettings.showErrorBars)
+            .arg(m_plotSettings.errorBarType).arg(m_plotSettings.ensembleRunThreshold)
+            .arg(m_plotSettings.multiPanelTimeSeries));
+    return hash.result();
+}
 
-    // Add series to chart
-    addSeriesToPlot(plotDataList);
+// Memoized buildPlotModel. Also restores the treatment colour assignment the model was
+// built with. Least recently used models are dropped above PLOT_MODEL_CACHE_BYTES.
+QVector<PlotData> PlotWidget::plotModelFor(const DataTable &simData, const DataTable &obsData,
+                                           const QString &xVar, const QStringList &yVars,
+                                           const QStringList &treatments, const QString &selectedExperiment,
+                                           const QMap<QString, QStringList> &yVarFileFilter)
+{
+    const QByteArray key = plotModelKey(simData, obsData, xVar, yVars, treatments,
+                                        selectedExperiment, yVarFileFilter);
+    auto cached = m_plotModelCache.constFind(key);
+    if (cached != m_plotModelCache.constEnd()) {
+        m_plotModelOrder.removeOne(key);
+        m_plotModelOrder.append(key);
+        m_treatmentColorMap = cached->treatmentColorMap;
+        return cached->plotDataList;
+    }
+
+    PlotModel model;
+    model.plotDataList = buildPlotModel(simData, obsData, xVar, yVars, treatments,
+                                        selectedExperiment, yVarFileFilter);
+    model.treatmentColorMap = m_treatmentColorMap;
+    for (const PlotData &pd : model.plotDataList)
+        model.bytes += qint64(sizeof(PlotData))
+                     + qint64(pd.points.size() + pd.rawPoints.size() + pd.lowerPoints.size()) * qint64(sizeof(QPointF))
+                     + qint64(pd.errorBars.size()) * qint64(sizeof(ErrorBarData))
+                     + qint64(pd.matchedPairs.size()) * qint64(sizeof(PlotData::MatchedPair));
+    if (model.bytes > PLOT_MODEL_CACHE_BYTES)
+        return model.plotDataList;
+
+    while (!m_plotModelOrder.isEmpty() && m_plotModelBytes + model.bytes > PLOT_MODEL_CACHE_BYTES) {
+        m_plotModelBytes -= m_plotModelCache.take(m_plotModelOrder.takeFirst()).bytes;
+    }
+    m_plotModelBytes += model.bytes;
+    m_plotModelOrder.append(key);
+    return m_plotModelCache.insert(key, model)->plotDataList;
+}
 
-    // Initialise animation frames from the newly built plot data
-    if (!m_isScatterMode) initAnimFrames();
-    
-    // Update error bar data in chart view (ONLY for observed data series, never for simulated data)
-    // Always render if pre-computed SD/SE columns were found, regardless of showErrorBars setting
-    if (m_chartView) {
-        QMap<QAbstractSeries*, QVector<ErrorBarData>> errorBarMap;
-        for (const QSharedPointer<PlotData> &plotData : m_plotDataList) {
-            if (plotData && plotData->isObserved && plotData->series && !plotData->errorBars.isEmpty()) {
-                errorBarMap[plotData->series] = plotData->errorBars;
-            }
-        }
-        m_chartView->setErrorBarData(errorBarMap);
-    }
-    
-    // Update legend
-    updateLegend(plotDataList);
+void PlotWidget::clearPlotModelCache()
+{
+    m_plotModelCache.clear();
+    m_plotModelOrder.clear();
+    m_plotModelBytes = 0;
+    m_versionSimData = DataTable();
+    m_versionObsData = DataTable();
+    ++m_dataVersion;
+}
+
+// Starts a new data version, dropping the caches keyed on the old one, unless
+// m_simData/m_obsData still share every column buffer with the tables the current
+// version was taken for. A replot of the loaded tables (treatment toggle, Plot button)
+// thus keeps the PlotData memo and the box plot caches across clear().
+void PlotWidget::syncDataVersion()
+{
+    auto sameBuffers = [](const DataTable &a, const DataTable &b) {
+        if (a.rowCount != b.rowCount || a.columns.size() != b.columns.size()) return false;
+        for (int i = 0; i < a.columns.size(); ++i)
+            if (a.columns[i].data.constData() != b.columns[i].data.constData()) return false;
+        return true;
+    };
+    if (sameBuffers(m_simData, m_versionSimData) && sameBuffers(m_obsData, m_versionObsData))
+        return;
+    clearPlotModelCache();
+    m_versionSimData = m_simData;
+    m_versionObsData = m_obsData;
+}
+
+MemoryUsage PlotWidget::memoryUsage(QSet<const void *> *seen) const
+{
+    MemoryUsage usage;
+    QSet<const void *> localSeen;
+    if (!seen) seen = &localSeen;   // the version tables share the plotted buffers
+    for (const DataTable *table : { &m_simData, &m_obsData, &m_versionSimData, &m_versionObsData,
+                                    &m_snapshotSimData, &m_snapshotObsData })
+        usage += table->memoryUsage(seen);
+
+    usage.caches += m_plotModelBytes;
+    for (const BoxPlotVarCache &entry : m_boxPlotVarCache)
+        usage.caches += qint64(entry.stats.capacity()) * qint64(sizeof(ErrorBarChartView::BoxPlotStats));
+    usage.caches += qint64(m_boxPlotGrouping.rowGroup.capacity()) * qint64(sizeof(int))
+                   + qint64(m_boxPlotGrouping.rowMdatMissing.capacity()) * qint64(sizeof(bool))
+                   + m_boxPlotGrouping.groupColumn.memoryUsage(seen).total();
+    for (const ReplicateGroups &groups : m_replicateCache)
+        usage.caches += qint64(groups.points.capacity()) * qint64(sizeof(QPointF))
+                       + qint64(groups.errorBars.capacity()) * qint64(sizeof(ErrorBarData))
+                       + qint64(groups.singleIndex.capacity()) * qint64(sizeof(int));
+    for (auto it = m_dateCache.constBegin(); it != m_dateCache.constEnd(); ++it)
+        usage.caches += qint64(it.key().capacity()) * qint64(sizeof(QChar)) + 64;  // + map node
+    return usage;
+}
+
+void PlotWidget::releaseCaches()
+{
+    clearPlotModelCache();
+    m_boxPlotVarCache.clear();
+    m_boxPlotGrouping = BoxPlotGrouping();
+    m_replicateCache.clear();
+    m_dateCache.clear();
+    m_snapshotGhostCache.clear();
+    m_simData.releaseCaches();
+    m_obsData.releaseCaches();
 }
 
 QScatterSeries::MarkerShape PlotWidget::getMarkerShape(const QString &symbol) const
@@ -2205,6 +2431,7 @@ QString PlotWidget::getVariableGroup(const QString &variable)
 
 void PlotWidget::addSeriesToPlot(const QVector<PlotData> &plotDataList)
 {
+    GB2_TRACE_SCOPE("series creation");
     if (!m_chart) {
         return;
     }
@@ -2217,7 +2444,23 @@ void PlotWidget::addSeriesToPlot(const QVector<PlotData> &plotDataList)
     // Clear previous series mappings and plot data
     m_seriesToPlotData.clear();
     m_plotDataList.clear();
-    
+
+    // Above the configured series/point budget, simulated lines go to the chart
+    // view's raster layer instead of each being drawn as its own chart item
+    bool useRasterLayer = false;
+    if (m_chartView && m_currentPlotType != "Scatter") {
+        int simSeries = 0;
+        qint64 simPoints = 0;
+        for (const PlotData &plotData : plotDataList) {
+            if (plotData.isObserved || plotData.points.isEmpty()) continue;
+            ++simSeries;
+            simPoints += plotData.points.size();
+        }
+        useRasterLayer = (m_plotSettings.rasterSeriesBudget > 0 && simSeries > m_plotSettings.rasterSeriesBudget)
+                      || (m_plotSettings.rasterPointBudgetK > 0 && simPoints > qint64(m_plotSettings.rasterPointBudgetK) * 1000);
+    }
+    QVector<ErrorBarChartView::RasterLine> rasterLines;
+
     for (int i = 0; i < plotDataList.size(); ++i) {
         const PlotData &plotData = plotDataList[i]; // Use const reference
         if (plotData.points.isEmpty()) {
@@ -2233,9 +2476,15 @@ void PlotWidget::addSeriesToPlot(const QVector<PlotData> &plotDataList)
         
         QAbstractSeries* series = nullptr;
         
-        if (sharedPlotData->isObserved || m_currentPlotType == "Scatter") {
+        if (!sharedPlotData->lowerPoints.isEmpty()) {
+            // Ensemble percentile band: filled area between its two edges
+            series = createEnsembleBandSeries(sharedPlotData);
+        } else if (sharedPlotData->isObserved || m_currentPlotType == "Scatter") {
             // Use scatter series for observed data or scatter plot type
-            QScatterSeries *scatterSeries = new QScatterSeries();
+            bool pointsUnchanged = false;
+            QScatterSeries *scatterSeries = qobject_cast<QScatterSeries*>(
+                takePooledSeries(*sharedPlotData, true, &pointsUnchanged));
+            if (!scatterSeries) scatterSeries = new QScatterSeries();
             
             // Disable OpenGL to enable all marker shapes (QTBUG-59881)
             scatterSeries->setUseOpenGL(false);
@@ -2285,11 +2534,11 @@ void PlotWidget::addSeriesToPlot(const QVector<PlotData> &plotDataList)
                 scatterSeries->setMarkerShape(getMarkerShape(originalSymbol));
                 scatterSeries->setPen(symbolPen);
                 scatterSeries->setBrush(symbolBrush);
+                scatterSeries->setProperty("custom_shape", QVariant());
             }
             
-            for (const QPointF &point : sharedPlotData->points) {
-                scatterSeries->append(point);
-            }
+            if (!pointsUnchanged)
+                scatterSeries->replace(sharedPlotData->points);
             
             series = scatterSeries;
             
@@ -2300,7 +2549,10 @@ void PlotWidget::addSeriesToPlot(const QVector<PlotData> &plotDataList)
             
         } else {
             // Use line series for simulated data
-            QLineSeries *lineSeries = new QLineSeries();
+            bool pointsUnchanged = false;
+            QLineSeries *lineSeries = useRasterLayer ? nullptr : qobject_cast<QLineSeries*>(
+                takePooledSeries(*sharedPlotData, false, &pointsUnchanged));
+            if (!lineSeries) lineSeries = new QLineSeries();
             
             // Disable OpenGL to enable all line styles (QTBUG-59881)
             lineSeries->setUseOpenGL(false);
@@ -2368,10 +2620,21 @@ void PlotWidget::addSeriesToPlot(const QVector<PlotData> &plotDataList)
                     linePen.setDashPattern({5.0, 2.0, 2.0, 2.0});
                     break;
             }
+            if (sharedPlotData->ensembleRole == "Mean") {
+                // Ensemble mean: thin dotted companion to the median line
+                linePen.setStyle(Qt::DotLine);
+                linePen.setWidthF(1.5);
+            }
             lineSeries->setPen(linePen);
-            
-            for (const QPointF &point : sharedPlotData->points) {
-                lineSeries->append(point);
+
+            // Full-resolution points stay in PlotData for export, hover and metrics;
+            // the series only gets what the plot area can show — or nothing at all when
+            // the raster layer draws it
+            if (useRasterLayer) {
+                lineSeries->setProperty("raster_layer", true);
+                rasterLines.append({ lineSeries, sharedPlotData->points });
+            } else if (!pointsUnchanged) {
+                lineSeries->replace(levelOfDetailPoints(sharedPlotData->points, false));
             }
             
             series = lineSeries;
@@ -2385,7 +2648,8 @@ void PlotWidget::addSeriesToPlot(const QVector<PlotData> &plotDataList)
         if (series) {
             sharedPlotData->series = series;
             m_seriesToPlotData[series] = sharedPlotData;
-            m_chart->addSeries(series);
+            if (series->chart() != m_chart)
+                m_chart->addSeries(series);
 
             // Attach series to existing axes (don't create default axes)
             auto axes = m_chart->axes();
@@ -2402,15 +2666,40 @@ void PlotWidget::addSeriesToPlot(const QVector<PlotData> &plotDataList)
                 if (xAxis && yAxis) {
                     series->attachAxis(xAxis);
                     series->attachAxis(yAxis);
+                    if (auto *valueAxis = qobject_cast<QValueAxis*>(xAxis))
+                        connect(valueAxis, &QValueAxis::rangeChanged, this,
+                                &PlotWidget::scheduleLevelOfDetail, Qt::UniqueConnection);
+                    else if (auto *dateAxis = qobject_cast<QDateTimeAxis*>(xAxis))
+                        connect(dateAxis, &QDateTimeAxis::rangeChanged, this,
+                                &PlotWidget::scheduleLevelOfDetail, Qt::UniqueConnection);
+                    // Hover index is in pixels: any axis range change invalidates it
+                    for (QAbstractAxis *axis : { xAxis, yAxis }) {
+                        if (auto *valueAxis = qobject_cast<QValueAxis*>(axis))
+                            connect(valueAxis, &QValueAxis::rangeChanged, this,
+                                    &PlotWidget::invalidateHoverIndex, Qt::UniqueConnection);
+                        else if (auto *dateAxis = qobject_cast<QDateTimeAxis*>(axis))
+                            connect(dateAxis, &QDateTimeAxis::rangeChanged, this,
+                                    &PlotWidget::invalidateHoverIndex, Qt::UniqueConnection);
+                    }
                 }
             }
         }
     }
     
+    // Pooled series this plot did not reuse
+    releaseSeriesPool();
+
+    if (m_chartView)
+        m_chartView->setRasterLines(rasterLines);
+    linkEnsembleSeries(m_plotDataList);
+
     // Re-inject snapshot series if comparison mode is active
     if (m_snapshotActive && !m_snapshotDataList.isEmpty())
         injectSnapshotSeries(m_chart);
 
+    // Series set changed — hover index is rebuilt on the next query
+    invalidateHoverIndex();
+
     // Enable snapshot button now that there is data to snapshot
     if (m_snapshotBtn) m_snapshotBtn->setEnabled(true);
 
@@ -2426,8 +2715,248 @@ void PlotWidget::addSeriesToPlot(const QVector<PlotData> &plotDataList)
     enforceAxisColors();
 }
 
+// Identity of a plotted series across replots. treatmentName carries the RUN suffix
+// when a treatment has several runs.
+QString PlotWidget::seriesPoolKey(const PlotData &plotData)
+{
+    return QString("%1__%2__%3__%4__%5__%6")
+        .arg(plotData.variable, plotData.crop, plotData.experiment, plotData.treatment,
+             plotData.treatmentName, plotData.isObserved ? "obs" : "sim");
+}
+
+// Parks the main chart's line and scatter series before a replot. They stay on the
+// chart (axes are detached by clearChart) until addSeriesToPlot reuses or releases them.
+// Raster-layer lines and ensemble members are always rebuilt.
+void PlotWidget::poolChartSeries()
+{
+    m_seriesPool.clear();
+    if (!m_chart) return;
+    // A partially drawn animation frame leaves series holding a prefix: never "unchanged"
+    const bool animPartial = !m_animXValues.isEmpty() && m_animFrame < m_animXValues.size() - 1;
+    for (QAbstractSeries *series : m_chart->series()) {
+        auto pd = m_seriesToPlotData.value(series);
+        if (!pd || !pd->ensembleRole.isEmpty() || series->property("raster_layer").toBool())
+            continue;
+        if (!qobject_cast<QLineSeries*>(series) && !qobject_cast<QScatterSeries*>(series))
+            continue;
+        m_seriesPool[seriesPoolKey(*pd)].append({ series, animPartial ? QVector<QPointF>() : pd->points });
+    }
+}
+
+// Pooled series of the wanted kind for plotData, reset to its unhighlighted state, or
+// nullptr. pointsUnchanged tells the caller it can skip replace().
+QAbstractSeries *PlotWidget::takePooledSeries(const PlotData &plotData, bool scatter, bool *pointsUnchanged)
+{
+    *pointsUnchanged = false;
+    auto it = m_seriesPool.find(seriesPoolKey(plotData));
+    if (it == m_seriesPool.end()) return nullptr;
+
+    QVector<PooledSeries> &entries = it.value();
+    for (int i = 0; i < entries.size(); ++i) {
+        QAbstractSeries *series = entries[i].series.data();
+        if (!series || scatter != bool(qobject_cast<QScatterSeries*>(series))) continue;
+        *pointsUnchanged = entries[i].points == plotData.points;
+        entries.removeAt(i);
+        if (entries.isEmpty()) m_seriesPool.erase(it);
+
+        for (const char *name : { "originalPen", "originalSize", "originalBrush" })
+            series->setProperty(name, QVariant());
+        series->setVisible(true);
+        return series;
+    }
+    return nullptr;
+}
+
+// Removes and deletes whatever the replot did not reuse
+void PlotWidget::releaseSeriesPool()
+{
+    for (const QVector<PooledSeries> &entries : std::as_const(m_seriesPool)) {
+        for (const PooledSeries &entry : entries) {
+            if (!entry.series) continue;
+            if (m_chart && entry.series->chart() == m_chart)
+                m_chart->removeSeries(entry.series.data());
+            delete entry.series.data();
+        }
+    }
+    m_seriesPool.clear();
+}
+
+// removeAllSeries(), sparing series parked in the pool
+void PlotWidget::removeUnpooledSeries()
+{
+    if (!m_chart) return;
+    if (m_seriesPool.isEmpty()) {
+        m_chart->removeAllSeries();
+        return;
+    }
+    QSet<QAbstractSeries*> pooled;
+    for (const QVector<PooledSeries> &entries : std::as_const(m_seriesPool))
+        for (const PooledSeries &entry : entries)
+            if (entry.series) pooled.insert(entry.series.data());
+    for (QAbstractSeries *series : m_chart->series()) {
+        if (pooled.contains(series)) continue;
+        m_chart->removeSeries(series);
+        delete series;
+    }
+}
+
+// Per-pixel-column min/max envelope. For each column of [xMin, xMax] the first, lowest,
+// highest and last point are kept (in x order), so peaks and the drawn outline survive
+// exactly; one point either side of the range is kept so lines run to the plot edge.
+// Points must be x-sorted; anything else is returned unchanged.
+QVector<QPointF> PlotWidget::decimateMinMax(const QVector<QPointF> &points, double xMin, double xMax, int columns)
+{
+    const int n = points.size();
+    if (columns <= 0 || n <= columns * LOD_POINTS_PER_COLUMN || !(xMax > xMin))
+        return points;
+    if (!std::is_sorted(points.cbegin(), points.cend(),
+                        [](const QPointF &a, const QPointF &b) { return a.x() < b.x(); }))
+        return points;
+
+    auto first = std::lower_bound(points.cbegin(), points.cend(), xMin,
+                                  [](const QPointF &p, double x) { return p.x() < x; });
+    auto last = std::upper_bound(points.cbegin(), points.cend(), xMax,
+                                 [](double x, const QPointF &p) { return x < p.x(); });
+    const int begin = qMax(0, int(first - points.cbegin()) - 1);
+    const int end = qMin(n, int(last - points.cbegin()) + 1);
+    if (end - begin <= columns * LOD_POINTS_PER_COLUMN)
+        return points.mid(begin, end - begin);
+
+    const double scale = columns / (xMax - xMin);
+    QVector<QPointF> out;
+    out.reserve(columns * LOD_POINTS_PER_COLUMN + 2);
+
+    int bucket = std::numeric_limits<int>::min();
+    int firstIdx = -1, minIdx = -1, maxIdx = -1, lastIdx = -1;
+    auto flush = [&]() {
+        if (firstIdx < 0) return;
+        int idx[4] = { firstIdx, minIdx, maxIdx, lastIdx };
+        std::sort(idx, idx + 4);
+        for (int k = 0; k < 4; ++k)
+            if (k == 0 || idx[k] != idx[k - 1])
+                out.append(points[idx[k]]);
+    };
+    for (int i = begin; i < end; ++i) {
+        const QPointF &p = points[i];
+        int b = qBound(-1, int(std::floor((p.x() - xMin) * scale)), columns);
+        if (b != bucket) {
+            flush();
+            bucket = b;
+            firstIdx = minIdx = maxIdx = i;
+        } else {
+            if (p.y() < points[minIdx].y()) minIdx = i;
+            if (p.y() > points[maxIdx].y()) maxIdx = i;
+        }
+        lastIdx = i;
+    }
+    flush();
+    return out;
+}
+
+// Pixel columns of the main plot area, the resolution line series are decimated to
+int PlotWidget::levelOfDetailColumns() const
+{
+    int columns = 0;
+    if (m_chart) columns = qRound(m_chart->plotArea().width());
+    if (columns <= 0 && m_chartView) columns = m_chartView->width();
+    if (columns <= 0) columns = Config::WindowConfig::WIDTH;
+    return columns;
+}
+
+// Points to hand a line series: the whole series, or only the current x-axis range,
+// decimated to the plot-area width.
+QVector<QPointF> PlotWidget::levelOfDetailPoints(const QVector<QPointF> &points, bool visibleRangeOnly) const
+{
+    if (points.isEmpty()) return points;
+
+    const int columns = levelOfDetailColumns();
+
+    double xMin = std::numeric_limits<double>::max();
+    double xMax = std::numeric_limits<double>::lowest();
+    bool haveRange = false;
+    if (visibleRangeOnly && m_chart) {
+        for (QAbstractAxis *axis : m_chart->axes(Qt::Horizontal)) {
+            if (auto *valueAxis = qobject_cast<QValueAxis*>(axis)) {
+                xMin = valueAxis->min();
+                xMax = valueAxis->max();
+                haveRange = true;
+            } else if (auto *dateAxis = qobject_cast<QDateTimeAxis*>(axis)) {
+                xMin = dateAxis->min().toMSecsSinceEpoch();
+                xMax = dateAxis->max().toMSecsSinceEpoch();
+                haveRange = true;
+            }
+            if (haveRange) break;
+        }
+    }
+    if (!haveRange) {
+        for (const QPointF &p : points) {
+            xMin = qMin(xMin, p.x());
+            xMax = qMax(xMax, p.x());
+        }
+    }
+    return decimateMinMax(points, xMin, xMax, columns);
+}
+
+void PlotWidget::scheduleLevelOfDetail()
+{
+    if (m_lodTimer) m_lodTimer->start();
+}
+
+// Re-decimate dense simulated series from full-resolution PlotData::points for the
+// visible x range (after zoom, pan, auto-fit or resize).
+void PlotWidget::applyLevelOfDetail()
+{
+    if (!m_chart || m_isScatterMode || m_isBoxPlotMode) return;
+
+    // Keep a partially drawn animation frame: only show data up to its cutoff
+    bool animPartial = !m_animXValues.isEmpty() && m_animFrame < m_animXValues.size() - 1;
+    double cutoff = animPartial ? m_animXValues[m_animFrame] : 0.0;
+
+    for (const auto &pd : m_plotDataList) {
+        if (!pd || pd->isObserved || !pd->series) continue;
+        QLineSeries *ls = qobject_cast<QLineSeries*>(pd->series.data());
+        if (!ls || ls->chart() != m_chart || ls->property("raster_layer").toBool()) continue;
+
+        QVector<QPointF> source;
+        if (animPartial) {
+            for (const QPointF &pt : pd->points)
+                if (pt.x() <= cutoff) source.append(pt);
+        } else {
+            source = pd->points;
+        }
+
+        QVector<QPointF> lod = levelOfDetailPoints(source, true);
+        // Skip series that are sparse enough to be drawn in full and already are
+        if (lod.size() == source.size() && ls->count() == source.size()) continue;
+        ls->replace(lod);
+        for (AnimTrack &track : m_animTracks)
+            if (track.series == ls) track.shownPoints = -1;
+    }
+}
+
+void PlotWidget::processPendingHover()
+{
+    if (!m_chartView || !m_chart) return;
+    const QPoint vpos = m_pendingHoverPos;
+    QAbstractSeries* hit = findSeriesNearPoint(vpos);
+    if (hit != m_hoveredSeries) {
+        if (m_hoveredSeries) highlightLegendRowForSeries(m_hoveredSeries, false);
+        m_hoveredSeries = hit;
+        if (m_hoveredSeries) highlightLegendRowForSeries(m_hoveredSeries, true);
+    }
+    if (m_plotSettings.showHoverTooltip) {
+        if (hit) {
+            QPointF nearestPt = findNearestDataPoint(hit, vpos);
+            showHoverTooltip(hit, nearestPt, vpos);
+        } else {
+            hideHoverTooltip();
+        }
+    }
+}
+
 void PlotWidget::updateLegend(const QVector<PlotData> &plotDataList)
 {
+    GB2_TRACE_SCOPE("chart layout: legend");
     
     clearLegend();
     
@@ -2448,6 +2977,11 @@ void PlotWidget::updateLegend(const QVector<PlotData> &plotDataList)
         if (!m_isScatterMode && plotData->treatment.isEmpty()) {
             continue;
         }
+
+        // Ensemble bands and mean are represented by their median line
+        if (!plotData->ensembleRole.isEmpty() && plotData->ensembleRole != "P50") {
+            continue;
+        }
         
         if (!legendEntries[category].contains(plotData->variable)) {
             legendEntries[category][plotData->variable] = QVector<QSharedPointer<PlotData>>();
@@ -2465,6 +2999,7 @@ void PlotWidget::updateLegend(const QVector<PlotData> &plotDataList)
 
 void PlotWidget::calculateMetrics()
 {
+    GB2_TRACE_SCOPE("metrics");
     
     if (m_simData.rowCount == 0 || m_obsData.rowCount == 0) {
         return;
@@ -2477,176 +3012,22 @@ void PlotWidget::calculateMetrics()
     // Pool all obs/sim pairs per variable (across treatments) for correct pooled d-stat
     QMap<QString, QVector<double>> pooledObs, pooledSim;
 
-    // Calculate metrics for each Y variable and treatment combination
+    // Calculate metrics for each Y variable and treatment+experiment+crop(+run) group
     for (const QString &yVar : m_currentYVars) {
+        const QVector<ObsSimGroup> groups = DataProcessor::matchObsSim(m_simData, m_obsData, yVar);
 
-        const DataColumn *simYColumn = m_simData.getColumn(yVar);
-        const DataColumn *obsYColumn = m_obsData.getColumn(yVar);
-        const DataColumn *simTrtColumn = m_simData.getColumn("TRT");
-        const DataColumn *obsTrtColumn = m_obsData.getColumn("TRT");
-        
-        if (!simYColumn || !obsYColumn || !simTrtColumn || !obsTrtColumn) {
-            continue;
-        }
-        
-        // Get required columns for matching
-        const DataColumn *simDateColumn = m_simData.getColumn("DATE");
-        const DataColumn *obsDateColumn = m_obsData.getColumn("DATE");
-        const DataColumn *simExpColumn = m_simData.getColumn("EXPERIMENT");
-        const DataColumn *obsExpColumn = m_obsData.getColumn("EXPERIMENT");
-        const DataColumn *simCropColumn = m_simData.getColumn("CROP");
-        const DataColumn *obsCropColumn = m_obsData.getColumn("CROP");
-        const DataColumn *simRunColumn = m_simData.getColumn("RUN");
-        
-        if (!simDateColumn || !obsDateColumn) {
-            continue;
-        }
-        
-        // Create key for matching: treatment_experiment_crop_date. If Sequence (SQ), ignore TRT.
-        auto createMatchKey = [](const QString& trt, const QString& exp, const QString& crop, const QString& date) {
-            if (crop == "SQ") {
-                return QString("SQ_ALL_%1_%2").arg(exp, date);
-            }
-            return QString("%1_%2_%3_%4").arg(trt, exp, crop, date);
-        };
-        
-        // Collect simulated data with match keys, split by RUN if present
-        // Map: baseKey (trt_exp_crop_date or SQ_ALL_exp_date) -> (runId -> sim value)
-        QMap<QString, QMap<QString, double>> simDataByBaseKeyToRuns;
-        // Keep track of which actual sim TRT corresponds to the matchKey for SQ
-        QMap<QString, QString> matchKeyToSimTrt;
-        
-        for (int row = 0; row < m_simData.rowCount; ++row) {
-            if (row >= simYColumn->data.size() || row >= simTrtColumn->data.size() || row >= simDateColumn->data.size()) continue;
-            
-            QString trt = simTrtColumn->data[row].toString();
-            QString date = simDateColumn->data[row].toString();
-            QString exp = simExpColumn && row < simExpColumn->data.size() ? simExpColumn->data[row].toString() : "";
-            QString crop = simCropColumn && row < simCropColumn->data.size() ? simCropColumn->data[row].toString() : "";
-            QString runId;
-            if (simRunColumn && row < simRunColumn->data.size()) {
-                QString rv = simRunColumn->data[row].toString();
-                if (!rv.isEmpty()) {
-                    runId = QString("RUN%1").arg(rv);
-                }
-            }
-            QVariant yVal = simYColumn->data[row];
-            
-            if (!DataProcessor::isMissingValue(yVal)) {
-                QString baseKey = createMatchKey(trt, exp, crop, date);
-                auto &runMap = simDataByBaseKeyToRuns[baseKey];
-                runMap[runId] = yVal.toDouble(); // empty runId means no RUN column
-                
-                // Store the actual simulated TRT for this match key (useful for sequences to recover the sim TRT)
-                if (crop == "SQ") {
-                    matchKeyToSimTrt[baseKey] = trt;
-                }
-            }
-        }
-
-        int nSimKeys = simDataByBaseKeyToRuns.size();
-        QStringList sampleSimKeys = simDataByBaseKeyToRuns.keys().mid(0, 5);
-        
-        // Collect observed data with match keys and create matched pairs grouped by treatment+variable+experiment+crop(+run)
-        QMap<QString, QVector<double>> simByTreatmentVarExpCrop;
-        QMap<QString, QVector<double>> obsByTreatmentVarExpCrop;
-        QMap<QString, QString> treatmentVarExpCropToExp; // experiment per group
-        QMap<QString, QString> treatmentVarExpCropToCrop; // crop per group
-        QMap<QString, QString> treatmentVarExpCropToTrt; // treatment per group
-        QMap<QString, QString> treatmentVarExpCropToRun; // runId per group (may be empty)
-        // Track run counts per base (no-run) group for labeling decisions
-        QMap<QString, QSet<QString>> baseGroupToRuns;
-        
-        int matchedPairs = 0;
-        int obsRowsWithVal = 0;
-        int obsRowsMatched = 0;
-        int obsRowsNoSim = 0;
-        QStringList sampleNoSimKeys;
-        for (int row = 0; row < m_obsData.rowCount; ++row) {
-            if (row >= obsYColumn->data.size() || row >= obsTrtColumn->data.size() || row >= obsDateColumn->data.size()) continue;
-            
-            QString obsTrt = obsTrtColumn->data[row].toString();
-            QString date = obsDateColumn->data[row].toString();
-            QString exp = obsExpColumn && row < obsExpColumn->data.size() ? obsExpColumn->data[row].toString() : "";
-            QString crop = obsCropColumn && row < obsCropColumn->data.size() ? obsCropColumn->data[row].toString() : "";
-            QVariant obsVal = obsYColumn->data[row];
-            
-            if (!DataProcessor::isMissingValue(obsVal)) {
-                obsRowsWithVal++;
-                QString matchKey = createMatchKey(obsTrt, exp, crop, date);
-                
-                // Only add if we have matching simulated data for the same key
-                if (simDataByBaseKeyToRuns.contains(matchKey)) {
-                    obsRowsMatched++;
-                    const auto &runMap = simDataByBaseKeyToRuns[matchKey];
-                    
-                    // For sequence, observed TRT is "1", but we want to group by the actual Sim TRT
-                    // so it appears in the metrics table under the correct Simulated treatment
-                    QString effectiveTrt = (crop == "SQ" && matchKeyToSimTrt.contains(matchKey)) ? matchKeyToSimTrt[matchKey] : obsTrt;
-                    
-                    QString baseGroupKey = QString("%1_%2_%3_%4").arg(effectiveTrt, yVar, exp, crop);
-                    // Convert date string to numeric x for animation cutoff comparison
-                    double xVal = 0.0;
-                    {
-                        QDateTime dt = QDateTime::fromString(date, "yyyy-MM-dd");
-                        if (dt.isValid()) xVal = static_cast<double>(dt.toMSecsSinceEpoch());
-                        else              xVal = date.toDouble(); // DAS/DAP
-                    }
+        for (const ObsSimGroup &group : groups) {
+            const QString &trt = group.treatment;
+            const QString &experimentName = group.experiment;
+            const QString &cropName = group.crop;
+            const QString &runId = group.runId;
 
-                    if (runMap.isEmpty()) {
-                        // No run separation (runMap should not be empty — handled below — but kept as fallback)
-                        QString groupKey = baseGroupKey;
-                        simByTreatmentVarExpCrop[groupKey].append(0.0);
-                        simByTreatmentVarExpCrop[groupKey].back() = 0.0;
-                        obsByTreatmentVarExpCrop[groupKey].append(obsVal.toDouble());
-                        treatmentVarExpCropToExp[groupKey] = exp;
-                        treatmentVarExpCropToCrop[groupKey] = crop;
-                        treatmentVarExpCropToTrt[groupKey] = effectiveTrt;
-                        matchedPairs++;
-                    } else {
-                        for (auto itRun = runMap.constBegin(); itRun != runMap.constEnd(); ++itRun) {
-                            QString runId = itRun.key();
-                            double simVal = itRun.value();
-                            QString groupKey = runId.isEmpty() ? baseGroupKey : QString("%1_%2").arg(baseGroupKey, runId);
-                            simByTreatmentVarExpCrop[groupKey].append(simVal);
-                            obsByTreatmentVarExpCrop[groupKey].append(obsVal.toDouble());
-                            treatmentVarExpCropToExp[groupKey] = exp;
-                            treatmentVarExpCropToCrop[groupKey] = crop;
-                            treatmentVarExpCropToTrt[groupKey] = effectiveTrt;
-                            treatmentVarExpCropToRun[groupKey] = runId;
-                            baseGroupToRuns[baseGroupKey].insert(runId);
-
-                            // Store raw pairs keyed by animKey; treatment filter applied in metrics loop
-                            QString animKey = QString("%1::%2::%3::%4::%5").arg(yVar, effectiveTrt, exp, crop, runId);
-                            m_animMatchedPairs[animKey].append({xVal, obsVal.toDouble(), simVal});
-
-                            matchedPairs++;
-                        }
-                    }
-                } else {
-                    obsRowsNoSim++;
-                    if (sampleNoSimKeys.size() < 5) sampleNoSimKeys << matchKey;
-                }
-            }
-        }
+            // Store raw pairs keyed by animKey; treatment filter applied below
+            const QString animKey = QString("%1::%2::%3::%4::%5").arg(yVar, trt, experimentName, cropName, runId);
+            QVector<AnimPair> &animPairs = m_animMatchedPairs[animKey];
+            for (int i = 0; i < group.obs.size(); ++i)
+                animPairs.append({group.x[i], group.obs[i], group.sim[i]});
 
-        if (!simByTreatmentVarExpCrop.isEmpty()) {
-            auto gk = simByTreatmentVarExpCrop.keys();
-        }
-        
-        // Calculate metrics for each treatment+variable+experiment+crop(+run) combination
-        for (auto it = simByTreatmentVarExpCrop.begin(); it != simByTreatmentVarExpCrop.end(); ++it) {
-            QString groupKey = it.key();
-            QStringList keyParts = groupKey.split("_");
-            
-            if (keyParts.size() < 4) continue;
-            
-            QString trt = treatmentVarExpCropToTrt[groupKey];
-            QString variable = keyParts[1]; // Should be yVar
-            QString experimentName = treatmentVarExpCropToExp[groupKey];
-            QString cropName = treatmentVarExpCropToCrop[groupKey];
-            QString runId = treatmentVarExpCropToRun.value(groupKey);
-            
             // Check if this treatment should be processed (empty = show all)
             if (!m_currentTreatments.isEmpty() && !m_currentTreatments.contains("All")
                 && !m_currentTreatments.contains(trt)
@@ -2654,47 +3035,41 @@ void PlotWidget::calculateMetrics()
                 continue;
             }
             // Per-variable filter
-            if (m_plotSettings.excludedSeriesKeys.contains(variable + "::" + experimentName + "::" + trt)) {
+            if (m_plotSettings.excludedSeriesKeys.contains(yVar + "::" + experimentName + "::" + trt)) {
                 continue;
             }
 
             // Mark this anim key as passing filters
-            m_animValidKeys.insert(QString("%1::%2::%3::%4::%5").arg(variable, trt, experimentName, cropName, runId));
+            m_animValidKeys.insert(animKey);
 
-            QVector<double> simValues = it.value();
-            QVector<double> obsValues = obsByTreatmentVarExpCrop[groupKey];
-
-            if (simValues.isEmpty() || obsValues.isEmpty()) {
+            if (group.sim.isEmpty() || group.obs.isEmpty()) {
                 continue;
             }
 
             // Pool for overall pooled d-stat
-            pooledObs[variable].append(obsValues);
-            pooledSim[variable].append(simValues);
+            pooledObs[yVar].append(group.obs);
+            pooledSim[yVar].append(group.sim);
 
-            // Use MetricsCalculator
-            QVariantMap result = MetricsCalculator::calculateMetrics(simValues, obsValues, trt.toInt());
+            QVariantMap result = MetricsCalculator::calculateMetrics(group.sim, group.obs, trt.toInt(),
+                                                                     m_plotSettings.bootstrapResamples);
             
             if (!result.isEmpty()) {
-                result["Variable"] = variable;
+                result["Variable"] = yVar;
                 // Get variable display name from CDE file
-                QPair<QString, QString> varInfo = DataProcessor::getVariableInfo(variable);
-                QString varDisplayName = varInfo.first.isEmpty() ? variable : varInfo.first;
-                result["VariableName"] = varDisplayName;
+                QPair<QString, QString> varInfo = DataProcessor::getVariableInfo(yVar);
+                result["VariableName"] = varInfo.first.isEmpty() ? yVar : varInfo.first;
                 
                 result["Treatment"] = trt;
-                // Build TreatmentName and append run only if multiple runs exist for this base group
+                // Append the run to the treatment name only if the group has several runs
                 QString treatmentName = getTreatmentDisplayName(trt, experimentName, cropName);
-                QString baseGroupKey = QString("%1_%2_%3_%4").arg(trt, variable, experimentName, cropName);
-                if (!runId.isEmpty() && baseGroupToRuns.value(baseGroupKey).size() > 1) {
+                if (!runId.isEmpty() && group.multiRun) {
                     treatmentName += QString(" (%1)").arg(runId);
                 }
                 result["TreatmentName"] = treatmentName;
                 result["Experiment"] = experimentName;
                 result["Crop"] = cropName;
                 // Get crop display name from crop code
-                QString cropDisplayName = getCropNameFromCode(cropName);
-                result["CropName"] = cropDisplayName;
+                result["CropName"] = getCropNameFromCode(cropName);
                 if (!runId.isEmpty()) {
                     result["Run"] = runId;
                 }
@@ -2705,61 +3080,18 @@ void PlotWidget::calculateMetrics()
     }
     
     
-    // Sort metrics by Treatment (numerically), then by Variable, Experiment, and Crop
+    // Pairs and treatment filters are final now — refresh the animation prefix index
+    rebuildAnimMetricsIndex();
+
     if (!metrics.isEmpty()) {
-        std::sort(metrics.begin(), metrics.end(), [](const QMap<QString, QVariant>& a, const QMap<QString, QVariant>& b) {
-            // Extract Treatment values and convert to integers for numerical sorting
-            QString trtA = a.value("Treatment").toString();
-            QString trtB = b.value("Treatment").toString();
-            
-            bool okA, okB;
-            int trtNumA = trtA.toInt(&okA);
-            int trtNumB = trtB.toInt(&okB);
-            
-            // If both are valid integers, sort numerically
-            if (okA && okB) {
-                if (trtNumA != trtNumB) {
-                    return trtNumA < trtNumB;
-                }
-            } else {
-                // If not both integers, sort as strings
-                if (trtA != trtB) {
-                    return trtA < trtB;
-                }
-            }
-            
-            // If treatments are equal, sort by Variable
-            QString varA = a.value("Variable").toString();
-            QString varB = b.value("Variable").toString();
-            if (varA != varB) {
-                return varA < varB;
-            }
-            
-            // If variables are equal, sort by Experiment
-            QString expA = a.value("Experiment").toString();
-            QString expB = b.value("Experiment").toString();
-            if (expA != expB) {
-                return expA < expB;
-            }
-            
-            // If experiments are equal, sort by Crop
-            QString cropA = a.value("Crop").toString();
-            QString cropB = b.value("Crop").toString();
-            return cropA < cropB;
-        });
-        
-        // Store pooled d-stat per variable so overlay and stats table can use it
-        for (auto &m : metrics) {
-            QString var = m.value("Variable").toString();
-            if (pooledObs.contains(var) && !pooledObs[var].isEmpty()) {
-                double pd = MetricsCalculator::dStat(pooledObs[var], pooledSim[var]);
-                m["PooledDStat"] = pd;
-            }
-        }
+        // Sort by Treatment, Variable, Experiment and Crop; add the pooled d-stat (and
+        // pooled bootstrap CIs) per variable so overlay and stats table can use it
+        MetricsCalculator::sortMetricRows(metrics);
+        MetricsCalculator::addPooledMetrics(metrics, pooledObs, pooledSim,
+                                            m_plotSettings.bootstrapResamples);
 
         m_lastTSMetrics = metrics;
         emit metricsCalculated(metrics);
-    } else {
     }
 }
 
@@ -2799,6 +3131,7 @@ QString PlotWidget::getTreatmentNameFromData(const QString &treatment, const QSt
 void PlotWidget::setData(const DataTable &data)
 {
     m_simData = data;
+    syncDataVersion();
 }
 
 void PlotWidget::updatePlot(const QString &xVariable, const QString &yVariable, 
@@ -2819,13 +3152,15 @@ void PlotWidget::clearChart()
     // raw QAbstractSeries* keys; once removeAllSeries() frees those objects, any
     // paint event would qobject_cast a dangling pointer and crash. This must
     // cover the multi-panel views too, not just m_chartView.
-    if (m_chartView)
+    if (m_chartView) {
         m_chartView->setErrorBarData(QMap<QAbstractSeries*, QVector<ErrorBarData>>());
+        m_chartView->clearRasterLines();
+    }
     for (ErrorBarChartView *v : m_tsPanelViews)
         if (v) v->setErrorBarData(QMap<QAbstractSeries*, QVector<ErrorBarData>>());
 
     if (m_chart) {
-        m_chart->removeAllSeries();
+        removeUnpooledSeries();
 
         // Remove all existing axes to prevent accumulation
         auto existingAxes = m_chart->axes();
@@ -2836,6 +3171,7 @@ void PlotWidget::clearChart()
     clearLegend();
     m_scalingLabel->clear();
     m_plotDataList.clear();
+    invalidateHoverIndex();
     m_lastTSMetrics.clear();
     if (m_tsMetricsOverlay) { delete m_tsMetricsOverlay; m_tsMetricsOverlay = nullptr; }
 
@@ -2859,9 +3195,12 @@ void PlotWidget::clear()
     m_simData.clear();
     m_obsData.clear();
     m_scaleFactors.clear();
+    // The PlotData memo is kept: syncDataVersion() drops it once other tables are plotted
     
     // Clear date cache when starting new plot
     m_dateCache.clear();
+    // m_replicateCache is kept: entries are validated against their input points,
+    // and surviving clear() is what lets an x-variable switch reuse them
     m_autoFitPending = false;
     if (m_autoFitTimer) {
         m_autoFitTimer->stop();
@@ -2936,6 +3275,7 @@ bool PlotWidget::parseDateCached(const QString &dateStr, double &timestamp, bool
 
 void PlotWidget::computeAxisBreaks(const QVector<PlotData> &plotDataList)
 {
+    GB2_TRACE_SCOPE("chart layout: axis breaks");
     m_axisBreaks.clear();
     m_axisSegments.clear();
     m_virtualAxisMax = 0.0;
@@ -3077,19 +3417,26 @@ QString PlotWidget::getPlotCSV() const
     // Columns: xVar | crop | experiment | treatment | var1_SIM | var1_OBS | var2_SIM | ...
     // We collect unique variables from sim and obs series separately
     QStringList simVars, obsVars;
+    QSet<QString> ensembleVars;
     for (const auto &pd : m_plotDataList) {
         if (pd->isObserved) {
             if (!obsVars.contains(pd->variable)) obsVars << pd->variable;
         } else {
             if (!simVars.contains(pd->variable)) simVars << pd->variable;
+            if (!pd->ensembleRole.isEmpty()) ensembleVars.insert(pd->variable);
         }
     }
+    // Ensemble treatments: <var> holds the median, band edges and mean follow it
+    const QStringList ensembleSuffixes = { "_P5", "_P25", "_P75", "_P95", "_MEAN" };
 
     // Build header
     QStringList header;
     header << m_currentXVar << "CROP" << "EXPERIMENT" << "TREATMENT";
     for (const QString &v : simVars) {
         header << v;
+        if (ensembleVars.contains(v))
+            for (const QString &suffix : ensembleSuffixes)
+                header << v + suffix;
         if (obsVars.contains(v))
             header << v + "_OBS";
     }
@@ -3113,10 +3460,20 @@ QString PlotWidget::getPlotCSV() const
     // Index: (crop|exp|trt|var|isObs) -> QMap<double x, double y>
     QMap<QString, QMap<double,double>> index;
     for (const auto &pd : m_plotDataList) {
-        QString key = pd->crop + "|" + pd->experiment + "|" + pd->treatment
-                      + "|" + pd->variable + "|" + (pd->isObserved ? "1" : "0");
+        QString prefix = pd->crop + "|" + pd->experiment + "|" + pd->treatment + "|";
+        QString isObs = pd->isObserved ? "1" : "0";
+        QString upperVar = pd->variable, lowerVar;
+        if (pd->ensembleRole == "P5-P95") { upperVar += "_P95"; lowerVar = pd->variable + "_P5"; }
+        else if (pd->ensembleRole == "P25-P75") { upperVar += "_P75"; lowerVar = pd->variable + "_P25"; }
+        else if (pd->ensembleRole == "Mean") upperVar += "_MEAN";
+        QString key = prefix + upperVar + "|" + isObs;
         for (const QPointF &pt : pd->points)
             index[key][pt.x()] = pt.y();
+        if (!lowerVar.isEmpty()) {
+            QString lowerKey = prefix + lowerVar + "|" + isObs;
+            for (const QPointF &pt : pd->lowerPoints)
+                index[lowerKey][pt.x()] = pt.y();
+        }
     }
 
     QString csv;
@@ -3149,6 +3506,13 @@ QString PlotWidget::getPlotCSV() const
                 QString sk = crop+"|"+exp+"|"+trt+"|"+v+"|0";
                 row << (index.contains(sk) && index[sk].contains(x)
                         ? QString::number(index[sk][x]) : "");
+                if (ensembleVars.contains(v)) {
+                    for (const QString &suffix : ensembleSuffixes) {
+                        QString ek = crop+"|"+exp+"|"+trt+"|"+v+suffix+"|0";
+                        row << (index.contains(ek) && index[ek].contains(x)
+                                ? QString::number(index[ek][x]) : "");
+                    }
+                }
                 if (obsVars.contains(v)) {
                     QString ok = crop+"|"+exp+"|"+trt+"|"+v+"|1";
                     row << (index.contains(ok) && index[ok].contains(x)
@@ -3186,21 +3550,35 @@ QString PlotWidget::getPlotRCode() const
     // Fixed metadata columns
     QStringList idCols = { xVar, "CROP", "EXPERIMENT", "TREATMENT" };
 
-    // Separate simulated vs observed variables
-    QStringList simVars, obsVars;
+    // Separate simulated vs observed variables; ensemble band columns (<var>_P5 ... _MEAN
+    // next to their <var> median column) are drawn as ribbons, not lines
+    const QStringList ensembleSuffixes = { "_P5", "_P25", "_P75", "_P95", "_MEAN" };
+    QStringList simVars, obsVars, ensembleVars;
     for (const QString &col : header) {
         if (idCols.contains(col)) continue;
+        bool isBand = false;
+        for (const QString &suffix : ensembleSuffixes) {
+            if (col.endsWith(suffix) && header.contains(col.chopped(suffix.size()))) {
+                if (suffix == "_P5") ensembleVars << col.chopped(suffix.size());
+                isBand = true;
+                break;
+            }
+        }
+        if (isBand) continue;
         if (col.endsWith("_OBS"))
             obsVars << col;
         else
             simVars << col;
     }
 
-    // Collect unique treatment display names from plotDataList
-    QMap<QString, QString> trtDisplayNames; // treatment id -> display name
+    // Collect unique treatment display names from plotDataList, keyed like the CSV rows
+    // (CROP|EXPERIMENT|TREATMENT): the same TRT number names different treatments in
+    // different experiments
+    QMap<QString, QString> trtDisplayNames; // "crop|experiment|treatment" -> display name
     for (const auto &pd : m_plotDataList) {
-        if (!pd->treatmentName.isEmpty() && !trtDisplayNames.contains(pd->treatment))
-            trtDisplayNames[pd->treatment] = pd->treatmentName;
+        const QString key = pd->crop + "|" + pd->experiment + "|" + pd->treatment;
+        if (!pd->treatmentName.isEmpty() && !trtDisplayNames.contains(key))
+            trtDisplayNames[key] = pd->treatmentName;
     }
 
     // Escape CSV for embedding in R read.csv(text=...)
@@ -3224,14 +3602,16 @@ QString PlotWidget::getPlotRCode() const
     if (!trtDisplayNames.isEmpty()) {
         QStringList entries;
         for (auto it = trtDisplayNames.constBegin(); it != trtDisplayNames.constEnd(); ++it) {
+            QString safeKey = it.key();
+            safeKey.replace("\\", "\\\\").replace("\"", "\\\"");
             QString safe = it.value();
             safe.replace("\\", "\\\\").replace("\"", "\\\"");
-            entries << QString("  \"%1\" = \"%2\"").arg(it.key(), safe);
+            entries << QString("  \"%1\" = \"%2\"").arg(safeKey, safe);
         }
         trtMapBlock = QString(
             "trt_labels <- c(\n%1\n)\n"
-            "long$TreatmentLabel <- trt_labels[as.character(long$TREATMENT)]\n"
-            "long$TreatmentLabel[is.na(long$TreatmentLabel)] <- as.character(long$TREATMENT[is.na(long$TreatmentLabel)])\n"
+            "long$TreatmentLabel <- unname(trt_labels[trt_key(long)])\n"
+            "long$TreatmentLabel[is.na(long$TreatmentLabel)] <- long$TREATMENT[is.na(long$TreatmentLabel)]\n"
         ).arg(entries.join(",\n"));
     } else {
         trtMapBlock = "long$TreatmentLabel <- long$TREATMENT\n";
@@ -3250,6 +3630,37 @@ QString PlotWidget::getPlotRCode() const
         obsColsR = "c(" + q.join(", ") + ")";
     }
 
+    // Ensemble ribbons: P5–P95 and P25–P75 bands plus a dotted mean under the median line
+    QString ensembleBlock, ensembleLayers;
+    if (!ensembleVars.isEmpty()) {
+        QStringList q;
+        for (const QString &v : ensembleVars) q << QString("\"%1\"").arg(v);
+        ensembleBlock =
+            "ens_vars <- c(" + q.join(", ") + ")\n"
+            "bands <- bind_rows(lapply(ens_vars, function(v) {\n"
+            "  data.frame(df[id_cols], Variable = v,\n"
+            "             P5  = df[[paste0(v, \"_P5\")]],  P25 = df[[paste0(v, \"_P25\")]],\n"
+            "             P75 = df[[paste0(v, \"_P75\")]], P95 = df[[paste0(v, \"_P95\")]],\n"
+            "             MEAN = df[[paste0(v, \"_MEAN\")]], check.names = FALSE)\n"
+            "})) %>% filter(!is.na(P5))\n"
+            "bands$TreatmentLabel <- long$TreatmentLabel[match(trt_key(bands), trt_key(long))]\n"
+            "if (exists(\"scale_restore\")) {\n"
+            "  for (vname in intersect(names(scale_restore), ens_vars)) {\n"
+            "    mask <- bands$Variable == vname\n"
+            "    bands[mask, c(\"P5\", \"P25\", \"P75\", \"P95\", \"MEAN\")] <-\n"
+            "      bands[mask, c(\"P5\", \"P25\", \"P75\", \"P95\", \"MEAN\")] * scale_restore[[vname]]\n"
+            "  }\n"
+            "}\n\n";
+        ensembleLayers =
+            "  geom_ribbon(data = bands, aes(x = .data[[xvar]], ymin = P5, ymax = P95, fill = TreatmentLabel),\n"
+            "              inherit.aes = FALSE, alpha = 0.18, show.legend = FALSE) +\n"
+            "  geom_ribbon(data = bands, aes(x = .data[[xvar]], ymin = P25, ymax = P75, fill = TreatmentLabel),\n"
+            "              inherit.aes = FALSE, alpha = 0.32, show.legend = FALSE) +\n"
+            "  geom_line(data = bands, aes(x = .data[[xvar]], y = MEAN, color = TreatmentLabel),\n"
+            "            inherit.aes = FALSE, linetype = \"dotted\", linewidth = 0.5, show.legend = FALSE) +\n"
+            "  scale_fill_manual(values = trt_colors, guide = \"none\") +\n";
+    }
+
     // Y facet vs single panel
     bool multiVar = m_currentYVars.size() > 1;
 
@@ -3311,7 +3722,13 @@ QString PlotWidget::getPlotRCode() const
         "library(dplyr)\n\n"
         "raw_csv <- \"%1\"\n\n"
         "df <- read.csv(text = raw_csv, stringsAsFactors = FALSE, check.names = FALSE,\n"
-        "               na.strings = c(\"\", \"NA\", \"-99\", \"-99.0\"))\n\n"
+        "               na.strings = c(\"\", \"NA\", \"-99\", \"-99.0\"),\n"
+        "               colClasses = c(CROP = \"character\", EXPERIMENT = \"character\",\n"
+        "                              TREATMENT = \"character\"))\n\n"
+        "# Rows belong to a treatment by crop, experiment and TRT together, as in the CSV\n"
+        "trt_key <- function(d) paste(ifelse(is.na(d$CROP), \"\", d$CROP),\n"
+        "                             ifelse(is.na(d$EXPERIMENT), \"\", d$EXPERIMENT),\n"
+        "                             d$TREATMENT, sep = \"|\")\n\n"
         "xvar     <- \"%2\"\n"
         "id_cols  <- c(xvar, \"CROP\", \"EXPERIMENT\", \"TREATMENT\")\n"
         "sim_cols <- %3\n"
@@ -3338,6 +3755,7 @@ QString PlotWidget::getPlotRCode() const
         "%6"  // trtMapBlock
         "\n"
         "%10" // inverseScaleBlock
+        "%13" // ensembleBlock
         "trt_levels <- unique(long$TreatmentLabel)\n"
         "n_trt      <- length(trt_levels)\n\n"
         "cb_palette <- c(\"#0072B2\", \"#D55E00\", \"#009E73\", \"#E69F00\",\n"
@@ -3375,6 +3793,7 @@ QString PlotWidget::getPlotRCode() const
         "p <- ggplot(long, aes(x = .data[[xvar]], y = Value,\n"
         "                       color    = TreatmentLabel,\n"
         "                       linetype = TreatmentLabel)) +\n"
+        "%14" // ensembleLayers
         "  geom_line(data   = subset(long, Type == \"Simulated\"),\n"
         "            linewidth = 0.75, show.legend = TRUE) +\n"
         "  geom_point(data  = subset(long, Type == \"Observed\"),\n"
@@ -3412,7 +3831,9 @@ QString PlotWidget::getPlotRCode() const
     .arg(yLabel)              // %9
     .arg(inverseScaleBlock)   // %10
     .arg(varLabelsBlock.isEmpty() ? "" : varLabelsBlock + "\n") // %11
-    .arg(QString::number(heightMm)); // %12
+    .arg(QString::number(heightMm)) // %12
+    .arg(ensembleBlock)       // %13
+    .arg(ensembleLayers);     // %14
 
     return code;
 }
@@ -3480,9 +3901,73 @@ static void overlayLegend(QPainter *p, QWidget *legendWidget, const QString &pos
     legendWidget->setMaximumWidth(savedMaxW);
 }
 
-void PlotWidget::exportPlot(const QString &filePath, const QString &format, int dpi)
+PlotRenderModel PlotWidget::renderModel() const
 {
-    if (!this) return;
+    PlotRenderModel model;
+    model.settings = m_plotSettings;
+    model.showLegend = m_showLegend;
+    if (!m_chart) return model;
+    model.title = m_chart->title();
+
+    // Series hidden from the legend stay hidden in the export
+    for (const QSharedPointer<PlotData> &pd : m_plotDataList) {
+        if (!pd || (pd->series && !pd->series->isVisible())) continue;
+        PlotData copy = *pd;
+        copy.series = nullptr;
+        model.plotData.append(copy);
+    }
+
+    auto captureAxis = [](QAbstractAxis *axis, PlotRenderAxis &out) {
+        if (!axis) return;
+        out.title = axis->titleText();
+        if (auto *dateAxis = qobject_cast<QDateTimeAxis*>(axis)) {
+            out.isDate = true;
+            out.min = dateAxis->min().toMSecsSinceEpoch();
+            out.max = dateAxis->max().toMSecsSinceEpoch();
+            out.tickCount = dateAxis->tickCount();
+            out.labelFormat = dateAxis->format();
+        } else if (auto *valueAxis = qobject_cast<QValueAxis*>(axis)) {
+            out.min = valueAxis->min();
+            out.max = valueAxis->max();
+            out.tickCount = valueAxis->tickCount();
+            out.minorTickCount = valueAxis->minorTickCount();
+            out.labelFormat = valueAxis->labelFormat();
+        }
+    };
+    const QList<QAbstractAxis*> hAxes = m_chart->axes(Qt::Horizontal);
+    const QList<QAbstractAxis*> vAxes = m_chart->axes(Qt::Vertical);
+    captureAxis(hAxes.isEmpty() ? nullptr : hAxes.first(), model.xAxis);
+    captureAxis(vAxes.isEmpty() ? nullptr : vAxes.first(), model.yAxis);
+    return model;
+}
+
+bool PlotWidget::canRenderOffscreen() const
+{
+    bool isMultiPanel = m_plotSettings.multiPanelTimeSeries && m_currentYVars.size() >= 2;
+    return !m_isScatterMode && !m_isBoxPlotMode && !isMultiPanel && m_axisBreaks.isEmpty()
+           && !m_plotDataList.isEmpty();
+}
+
+bool PlotWidget::exportPlot(const QString &filePath, const QString &format, int dpi, bool quiet)
+{
+    if (!this) return false;
+    GB2_TRACE_SCOPE_ARG("export", QFileInfo(filePath).fileName());
+    auto reportFailure = [quiet](const QString &message) {
+        if (!quiet) QMessageBox::critical(nullptr, "Export Failed", message);
+    };
+
+    // The single time-series chart is re-laid out offscreen from the plot model:
+    // no show(), no event pumping, and the same output whether or not the window is up
+    if (canRenderOffscreen()) {
+        QSize size = m_chartView && m_chartView->isVisible() ? this->size() : QSize();
+        if (size.isEmpty())
+            size = QSize(Config::WindowConfig::WIDTH, Config::WindowConfig::HEIGHT);
+        PlotRenderer renderer(renderModel());
+        const bool saved = renderer.save(filePath, format, size, dpi);
+        if (!saved)
+            reportFailure(QString("Could not save plot to:\n%1\n\nCheck the path is writable.").arg(filePath));
+        return saved;
+    }
 
     this->show();
     this->update();
@@ -3519,9 +4004,8 @@ void PlotWidget::exportPlot(const QString &filePath, const QString &format, int
             if (m_legendStack) m_legendStack->setVisible(legendStackWasVisible);
             if (m_bottomContainer) m_bottomContainer->setVisible(bottomWasVisible);
             if (m_bottomStatusWidget) m_bottomStatusWidget->setVisible(statusWasVisible);
-            QMessageBox::critical(nullptr, "Export Failed",
-                QString("Cannot write to:\n%1\n\n%2").arg(filePath, testFile.errorString()));
-            return;
+            reportFailure(QString("Cannot write to:\n%1\n\n%2").arg(filePath, testFile.errorString()));
+            return false;
         }
         testFile.close();
         testFile.remove();
@@ -3592,8 +4076,8 @@ void PlotWidget::exportPlot(const QString &filePath, const QString &format, int
     if (m_bottomStatusWidget) m_bottomStatusWidget->setVisible(statusWasVisible);
 
     if (!ok)
-        QMessageBox::critical(nullptr, "Export Failed",
-            QString("Could not save plot to:\n%1\n\nCheck the path is writable.").arg(filePath));
+        reportFailure(QString("Could not save plot to:\n%1\n\nCheck the path is writable.").arg(filePath));
+    return ok;
 }
 
 // Composite legend widget onto a pixmap at the position specified in m_plotSettings.legendPosition
@@ -3741,6 +4225,7 @@ QPixmap PlotWidget::cropToContent(const QPixmap &source)
 void PlotWidget::exportPlotComposite(const QString &filePath, const QString &format, int width, int height, int dpi)
 {
     if (!m_chartView || !m_legendWidget) return;
+    GB2_TRACE_SCOPE_ARG("export", QFileInfo(filePath).fileName());
 
     // Resize to target dimensions before rendering so the source pixmap is full resolution,
     // not captured from the small default window size and then upscaled.
@@ -3765,7 +4250,8 @@ void PlotWidget::exportPlotComposite(const QString &filePath, const QString &for
     m_chartView->render(&chartPainter);
     chartPainter.end();
 
-    // Draw axis border lines, error bars, and box plots on top (bypassed when using render() directly)
+    // Draw axis border lines, error bars, and box plots on top (bypassed when using render() directly;
+    // the raster layer is a scene item, so render() already drew it beneath the series)
     chartPainter.begin(&chartPixmap);
     m_chartView->paintAxisBorder(&chartPainter, m_chartView->viewport()->pos());
     m_chartView->paintErrorBars(&chartPainter, m_chartView->viewport()->pos());
@@ -4116,9 +4602,16 @@ void PlotWidget::updatePlotWithScaling()
 
     // Update the plot with scaled data
     
-    // Clear the chart first to ensure fresh plotting
+    // Clear the chart first to ensure fresh plotting; the time-series path reuses
+    // unchanged series from the pool. All chart changes are batched off-scene.
+    const bool pooling = !m_isScatterMode && !m_isBoxPlotMode;
+    DetachedChart batch(m_chart);
+    const bool suspendUpdates = updatesEnabled();
+    if (suspendUpdates) setUpdatesEnabled(false);
     if (m_chart) {
-        m_chart->removeAllSeries();
+        if (pooling) poolChartSeries();
+        else releaseSeriesPool();
+        removeUnpooledSeries();
         // Also remove axes so box plot â†” line plot switching doesn't stack old axes
         for (auto *axis : m_chart->axes())
             m_chart->removeAxis(axis);
@@ -4135,6 +4628,8 @@ void PlotWidget::updatePlotWithScaling()
     } else {
         plotDatasets(scaledSimData, scaledObsData, m_currentXVar, m_currentYVars, m_currentTreatments, m_selectedExperiment, m_yVarFileFilter);
     }
+    // Nothing stays parked once a plot path has run (a no-op after addSeriesToPlot)
+    releaseSeriesPool();
 
     // Update the scaling label (hidden in multi-panel mode — no scaling applied)
     if (isMultiPanel) {
@@ -4146,6 +4641,8 @@ void PlotWidget::updatePlotWithScaling()
     // Switch between single-chart and multi-panel layout based on settings
     if (!m_isScatterMode && !m_isBoxPlotMode)
         plotTimeSeriesMultiPanel();
+
+    if (suspendUpdates) setUpdatesEnabled(true);
 }
 
 void PlotWidget::onPlotSettingsChanged()
@@ -4388,21 +4885,11 @@ bool PlotWidget::eventFilter(QObject* obj, QEvent* event)
                 }
             }
 
-            // Always use viewport coordinates for hit-testing
-            QAbstractSeries* hit = findSeriesNearPoint(vpos);
-            if (hit != m_hoveredSeries) {
-                if (m_hoveredSeries) highlightLegendRowForSeries(m_hoveredSeries, false);
-                m_hoveredSeries = hit;
-                if (m_hoveredSeries) highlightLegendRowForSeries(m_hoveredSeries, true);
-            }
-            if (m_plotSettings.showHoverTooltip) {
-                if (hit) {
-                    QPointF nearestPt = findNearestDataPoint(hit, vpos);
-                    showHoverTooltip(hit, nearestPt, vpos);
-                } else {
-                    hideHoverTooltip();
-                }
-            }
+            // Always use viewport coordinates for hit-testing; only the latest position
+            // is tested, at most once per frame
+            m_pendingHoverPos = vpos;
+            if (m_hoverTimer && !m_hoverTimer->isActive())
+                m_hoverTimer->start();
         }
     }
     
@@ -4993,6 +5480,7 @@ void PlotWidget::setupAnimControls()
 void PlotWidget::initAnimFrames()
 {
     m_animXValues.clear();
+    m_animTracks.clear();
     m_animFrame   = 0;
     m_animPlaying = false;
 
@@ -5025,6 +5513,63 @@ void PlotWidget::initAnimFrames()
     m_animResetButton->setEnabled(true);
     m_animFrame = last;
     updateAnimLabel(last);
+
+    buildAnimTracks();
+    rebuildAnimMetricsIndex();
+}
+
+// Per-series cutoff indices for every frame. Points (and error bars) are x-sorted, so
+// the points visible at frame f are a prefix whose length one walk over the frame
+// x values yields.
+void PlotWidget::buildAnimTracks()
+{
+    m_animTracks.clear();
+    const int frames = m_animXValues.size();
+    if (frames == 0) return;
+
+    auto prefixCounts = [&](const QVector<QPointF> &points) {
+        QVector<int> counts(frames);
+        int k = 0;
+        for (int f = 0; f < frames; ++f) {
+            while (k < points.size() && points[k].x() <= m_animXValues[f]) ++k;
+            counts[f] = k;
+        }
+        return counts;
+    };
+    auto byX = [](const QPointF &a, const QPointF &b) { return a.x() < b.x(); };
+
+    m_animTracks.reserve(m_plotDataList.size());
+    for (const auto &pd : m_plotDataList) {
+        if (!pd || !pd->series) continue;
+        AnimTrack track;
+        track.plotData = pd;
+        track.series = pd->series;
+
+        const bool lowerMatches = pd->lowerPoints.isEmpty()
+            || (pd->lowerPoints.size() == pd->points.size()
+                && std::is_sorted(pd->lowerPoints.cbegin(), pd->lowerPoints.cend(), byX));
+        if (lowerMatches && std::is_sorted(pd->points.cbegin(), pd->points.cend(), byX))
+            track.pointPrefix = prefixCounts(pd->points);
+
+        if (pd->isObserved && !pd->errorBars.isEmpty()) {
+            QChart *chart = pd->series->chart();
+            if (m_chartView && m_chartView->chart() == chart)
+                track.errorBarView = m_chartView;
+            else {
+                for (ErrorBarChartView *v : m_tsPanelViews)
+                    if (v && v->chart() == chart) { track.errorBarView = v; break; }
+            }
+            if (track.errorBarView) {
+                track.errorBarPrefix.resize(frames);
+                int k = 0;
+                for (int f = 0; f < frames; ++f) {
+                    while (k < pd->errorBars.size() && pd->errorBars[k].meanX <= m_animXValues[f]) ++k;
+                    track.errorBarPrefix[f] = k;
+                }
+            }
+        }
+        m_animTracks.append(track);
+    }
 }
 
 // Build overlay HTML table from cached per-treatment metrics (Overall rows only)
@@ -5084,34 +5629,183 @@ QString PlotWidget::buildTSOverlayHtml(
            + rows.join("") + "</table></body></html>";
 }
 
-// Compute metrics text for a variable using pre-matched raw pairs up to cutoff x
-QStringList PlotWidget::computeAnimMetricsForVar(
-    const QString &varCode,
-    double cutoff,
-    const QSet<QString> &selectedMetrics) const
+namespace {
+// Fenwick tree over sorted interval ends, summing the count, obs + sim and obs * sim of
+// the pairs inserted so far
+struct AnimPairSums {
+    QVector<double> count, sum, product;
+    explicit AnimPairSums(int size) : count(size + 1, 0.0), sum(size + 1, 0.0), product(size + 1, 0.0) {}
+    void add(int pos, double pairSum, double pairProduct)
+    {
+        for (++pos; pos < count.size(); pos += pos & -pos) {
+            count[pos] += 1.0;
+            sum[pos] += pairSum;
+            product[pos] += pairProduct;
+        }
+    }
+    // Totals over positions [0, end)
+    void total(int end, double &c, double &s, double &p) const
+    {
+        c = s = p = 0.0;
+        for (; end > 0; end -= end & -end) {
+            c += count[end];
+            s += sum[end];
+            p += product[end];
+        }
+    }
+};
+} // namespace
+
+// Pool the valid anim pairs per variable, sort by x and build prefix accumulators.
+// Called after calculateMetrics() (pairs/filters change) and initAnimFrames() (frames change).
+void PlotWidget::rebuildAnimMetricsIndex()
 {
-    // Pool all pairs first, then compute stats once (pooled d-stat matches stats table Overall row)
-    QVector<double> allObs, allSim;
+    m_animMetricsIndex.clear();
+
+    struct XPair { double x, obs, sim; };
+    QHash<QString, QVector<XPair>> pooled;
     for (auto it = m_animMatchedPairs.constBegin(); it != m_animMatchedPairs.constEnd(); ++it) {
-        if (!it.key().startsWith(varCode + "::")) continue;
         if (!m_animValidKeys.contains(it.key())) continue;
-        for (const AnimPair &p : it.value()) {
-            if (p.x > cutoff) continue;
-            if (std::isfinite(p.obs) && std::isfinite(p.sim)) {
-                allObs << p.obs;
-                allSim << p.sim;
+        const QString varCode = it.key().section("::", 0, 0);
+        QVector<XPair> &dst = pooled[varCode];
+        for (const AnimPair &p : it.value())
+            if (std::isfinite(p.obs) && std::isfinite(p.sim))
+                dst.append({p.x, p.obs, p.sim});
+    }
+
+    for (auto it = pooled.begin(); it != pooled.end(); ++it) {
+        QVector<XPair> &pairs = it.value();
+        if (pairs.isEmpty()) continue;
+        std::stable_sort(pairs.begin(), pairs.end(),
+                         [](const XPair &a, const XPair &b) { return a.x < b.x; });
+
+        const int n = pairs.size();
+        AnimMetricsIndex idx;
+        idx.x.resize(n); idx.obs.resize(n); idx.sim.resize(n);
+        idx.sumObs.resize(n + 1);
+        idx.sumSqErr.resize(n + 1);
+        idx.sumObs[0] = 0.0;
+        idx.sumSqErr[0] = 0.0;
+        for (int i = 0; i < n; ++i) {
+            const XPair &p = pairs[i];
+            idx.x[i] = p.x; idx.obs[i] = p.obs; idx.sim[i] = p.sim;
+            const double diff = p.obs - p.sim;
+            idx.sumObs[i + 1]   = idx.sumObs[i] + p.obs;
+            idx.sumSqErr[i + 1] = idx.sumSqErr[i] + diff * diff;
+        }
+
+        // Frame -> prefix length, one merge-style sweep over the sorted frame cutoffs
+        idx.frameCount.resize(m_animXValues.size());
+        int k = 0;
+        for (int f = 0; f < m_animXValues.size(); ++f) {
+            while (k < n && idx.x[k] <= m_animXValues[f]) ++k;
+            idx.frameCount[f] = k;
+        }
+
+        // d-stat per frame, in O(log n) each. Around the prefix's observed mean m its
+        // denominator sum (|o - m| + |s - m|)^2 is sum (o - m)^2 + (s - m)^2 + 2|(o - m)(s - m)|.
+        // The squares expand into prefix sums. The product is a polynomial in m too, but
+        // negative exactly for pairs with min(o, s) < m < max(o, s): those are the pairs
+        // with a low end below m minus those with a high end at or below m, counted by two
+        // Fenwick trees as the sweep inserts pairs in x order.
+        QVector<double> sumObsSq(n + 1, 0.0), sumSim(n + 1, 0.0), sumSimSq(n + 1, 0.0),
+                        sumObsSim(n + 1, 0.0), lows(n), highs(n);
+        for (int i = 0; i < n; ++i) {
+            sumObsSq[i + 1]  = sumObsSq[i] + idx.obs[i] * idx.obs[i];
+            sumSim[i + 1]    = sumSim[i] + idx.sim[i];
+            sumSimSq[i + 1]  = sumSimSq[i] + idx.sim[i] * idx.sim[i];
+            sumObsSim[i + 1] = sumObsSim[i] + idx.obs[i] * idx.sim[i];
+            lows[i]  = std::min(idx.obs[i], idx.sim[i]);
+            highs[i] = std::max(idx.obs[i], idx.sim[i]);
+        }
+        std::sort(lows.begin(), lows.end());
+        std::sort(highs.begin(), highs.end());
+
+        AnimPairSums byLow(n), byHigh(n);
+        idx.frameDStat.resize(m_animXValues.size());
+        int inserted = 0;
+        int lastCount = -1;
+        double lastDStat = 0.0;
+        for (int f = 0; f < idx.frameCount.size(); ++f) {
+            const int count = idx.frameCount[f];
+            if (count != lastCount) {
+                for (; inserted < count; ++inserted) {
+                    const double o = idx.obs[inserted], s = idx.sim[inserted];
+                    const int lowPos  = int(std::lower_bound(lows.begin(), lows.end(), std::min(o, s)) - lows.begin());
+                    const int highPos = int(std::lower_bound(highs.begin(), highs.end(), std::max(o, s)) - highs.begin());
+                    byLow.add(lowPos, o + s, o * s);
+                    byHigh.add(highPos, o + s, o * s);
+                }
+                lastDStat = 0.0;
+                if (count > 0) {
+                    const double m = idx.sumObs[count] / count;
+                    // sum of (o - m)(s - m) over pairs with the given totals
+                    auto products = [m](double c, double sum, double product) {
+                        return product - m * sum + m * m * c;
+                    };
+                    double lowC, lowS, lowP, highC, highS, highP;
+                    byLow.total(int(std::lower_bound(lows.begin(), lows.end(), m) - lows.begin()),
+                                lowC, lowS, lowP);
+                    byHigh.total(int(std::upper_bound(highs.begin(), highs.end(), m) - highs.begin()),
+                                 highC, highS, highP);
+                    const double all = products(count, idx.sumObs[count] + sumSim[count], sumObsSim[count]);
+                    const double straddling = products(lowC - highC, lowS - highS, lowP - highP);
+                    const double denominator =
+                        (sumObsSq[count] - 2.0 * m * idx.sumObs[count] + count * m * m)
+                        + (sumSimSq[count] - 2.0 * m * sumSim[count] + count * m * m)
+                        + 2.0 * (all - 2.0 * straddling);
+                    // Exactly 0 when every o = s = m; cancellation may leave a trace of it
+                    if (denominator > 1e-12 * (sumObsSq[count] + sumSimSq[count]))
+                        lastDStat = 1.0 - idx.sumSqErr[count] / denominator;
+                }
+                lastCount = count;
             }
+            idx.frameDStat[f] = lastDStat;
         }
+
+        m_animMetricsIndex.insert(it.key(), idx);
     }
+}
 
-    if (allObs.isEmpty()) return {};
+// Metrics text for a variable over all valid pairs up to the frame's cutoff x.
+// N/RMSE/NRMSE come straight from the prefix sums, d-stat from the per-frame values
+// rebuildAnimMetricsIndex() computed.
+QStringList PlotWidget::computeAnimMetricsForVar(
+    const QString &varCode,
+    int frame,
+    const QSet<QString> &selectedMetrics) const
+{
+    auto it = m_animMetricsIndex.constFind(varCode);
+    if (it == m_animMetricsIndex.constEnd()) return {};
+    const AnimMetricsIndex &idx = it.value();
 
-    int    n       = allObs.size();
-    double obsSum  = 0; for (double v : allObs) obsSum += v;
-    double obsMean = obsSum / n;
-    double rmse    = MetricsCalculator::rmse(allObs, allSim);
+    int n = 0;
+    const bool indexed = frame >= 0 && frame < idx.frameCount.size();
+    if (indexed) {
+        n = idx.frameCount[frame];
+    } else if (frame >= 0 && frame < m_animXValues.size()) {
+        n = int(std::upper_bound(idx.x.begin(), idx.x.end(), m_animXValues[frame]) - idx.x.begin());
+    }
+    if (n <= 0) return {};
+
+    double obsMean = idx.sumObs[n] / n;
+    double rmse    = std::sqrt(idx.sumSqErr[n] / n);
     double nrmse   = (obsMean > 0) ? (rmse / obsMean) * 100.0 : 0.0;
-    double dStat   = MetricsCalculator::dStat(allObs, allSim);
+
+    double dStat = 0.0;
+    if (selectedMetrics.contains("d-stat")) {
+        if (indexed) {
+            dStat = idx.frameDStat[frame];
+        } else {
+            // Frames changed without a rebuild: same formulation as MetricsCalculator::dStat
+            double denominator = 0.0;
+            for (int i = 0; i < n; ++i) {
+                double term = std::abs(idx.obs[i] - obsMean) + std::abs(idx.sim[i] - obsMean);
+                denominator += term * term;
+            }
+            dStat = (denominator == 0.0) ? 0.0 : 1.0 - idx.sumSqErr[n] / denominator;
+        }
+    }
 
     QStringList parts;
     if (selectedMetrics.contains("N"))     parts << QString("N = %1").arg(n);
@@ -5121,61 +5815,84 @@ QStringList PlotWidget::computeAnimMetricsForVar(
     return parts;
 }
 
+// Moves an x-sorted series from showing points[0, shown) to points[0, target): a frame
+// step appends or removes only the points in between. Falls back to a full replace
+// when the series was changed elsewhere (level-of-detail pass, replot).
+static void stepSeries(QXYSeries *xy, const QVector<QPointF> &points, int &shown, int target)
+{
+    if (shown < 0 || xy->count() != shown)
+        xy->replace(points.mid(0, target));
+    else if (target > shown)
+        xy->append(QList<QPointF>(points.cbegin() + shown, points.cbegin() + target));
+    else if (target < shown)
+        xy->removePoints(target, shown - target);
+    shown = target;
+}
+
 void PlotWidget::applyAnimFrame(int frame)
 {
     if (m_animXValues.isEmpty() || frame < 0 || frame >= m_animXValues.size()) return;
 
-    double cutoff = m_animXValues[frame];
-
-    // Collect filtered error bars per view so we can update them in one pass
-    QMap<ErrorBarChartView*, QMap<QAbstractSeries*, QVector<ErrorBarData>>> viewErrorBars;
-    if (m_chartView && m_chartView->isVisible())
-        viewErrorBars[m_chartView] = {};
-    for (ErrorBarChartView *v : m_tsPanelViews)
-        if (v && v->isVisible())
-            viewErrorBars[v] = {};
-
-    for (const auto &pd : m_plotDataList) {
-        if (!pd || !pd->series) continue;
-
-        // For the series itself always filter pd->points (mean points for error bar series,
-        // raw points for non-aggregated observed). rawPoints is only used for error bar metrics.
-        QVector<QPointF> filtered;
-        for (const QPointF &pt : pd->points)
-            if (pt.x() <= cutoff) filtered.append(pt);
-
-        if (QLineSeries *ls = qobject_cast<QLineSeries*>(pd->series.data()))
-            ls->replace(filtered);
-        else if (QScatterSeries *ss = qobject_cast<QScatterSeries*>(pd->series.data()))
-            ss->replace(filtered);
-
-        // Filter error bars for this observed series
-        if (pd->isObserved && !pd->errorBars.isEmpty()) {
-            QChart *chart = pd->series->chart();
-            if (chart) {
-                ErrorBarChartView *target = nullptr;
-                if (m_chartView && m_chartView->chart() == chart)
-                    target = m_chartView;
-                else {
-                    for (ErrorBarChartView *v : m_tsPanelViews)
-                        if (v && v->chart() == chart) { target = v; break; }
-                }
-                if (target && viewErrorBars.contains(target)) {
-                    QVector<ErrorBarData> filteredEB;
-                    for (const auto &eb : pd->errorBars)
-                        if (eb.meanX <= cutoff) filteredEB.append(eb);
-                    viewErrorBars[target][pd->series.data()] = filteredEB;
-                }
+    // Series may have been recreated (TS panels) since the tracks were built
+    bool stale = m_animTracks.isEmpty() && !m_plotDataList.isEmpty();
+    for (const AnimTrack &track : m_animTracks)
+        if (!track.plotData || track.series != track.plotData->series) { stale = true; break; }
+    if (stale) buildAnimTracks();
+
+    const double cutoff = m_animXValues[frame];
+    const int denseLine = levelOfDetailColumns() * LOD_POINTS_PER_COLUMN;
+
+    for (AnimTrack &track : m_animTracks) {
+        const QSharedPointer<PlotData> &pd = track.plotData;
+        if (!pd || !track.series) continue;
+        QAbstractSeries *series = track.series.data();
+
+        if (track.pointPrefix.isEmpty()) {
+            // Unsorted points: filter by cutoff and replace
+            QVector<QPointF> filtered;
+            for (const QPointF &pt : pd->points)
+                if (pt.x() <= cutoff) filtered.append(pt);
+
+            if (series->property("raster_layer").toBool()) {
+                if (m_chartView) m_chartView->setRasterLinePoints(series, filtered);
+            } else if (QLineSeries *ls = qobject_cast<QLineSeries*>(series))
+                ls->replace(pd->isObserved ? filtered : levelOfDetailPoints(filtered, true));
+            else if (QScatterSeries *ss = qobject_cast<QScatterSeries*>(series))
+                ss->replace(filtered);
+            else if (QAreaSeries *as = qobject_cast<QAreaSeries*>(series)) {
+                QVector<QPointF> lower;
+                for (const QPointF &pt : pd->lowerPoints)
+                    if (pt.x() <= cutoff) lower.append(pt);
+                as->upperSeries()->replace(filtered);
+                as->lowerSeries()->replace(lower);
+            }
+        } else {
+            const int target = track.pointPrefix[frame];
+            if (series->property("raster_layer").toBool()) {
+                if (target != track.shownPoints && m_chartView)
+                    m_chartView->setRasterLinePoints(series, pd->points.mid(0, target));
+                track.shownPoints = target;
+            } else if (QAreaSeries *as = qobject_cast<QAreaSeries*>(series)) {
+                // Both edges share x values, so one prefix covers upper and lower
+                int shownLower = track.shownPoints;
+                stepSeries(as->upperSeries(), pd->points, track.shownPoints, target);
+                stepSeries(as->lowerSeries(), pd->lowerPoints, shownLower, target);
+            } else if (!pd->isObserved && target > denseLine && qobject_cast<QLineSeries*>(series)) {
+                // Too dense to draw in full: decimate the revealed prefix
+                QVector<QPointF> lod = levelOfDetailPoints(pd->points.mid(0, target), true);
+                static_cast<QLineSeries*>(series)->replace(lod);
+                track.shownPoints = lod.size() == target ? target : -1;
+            } else if (QXYSeries *xy = qobject_cast<QXYSeries*>(series)) {
+                stepSeries(xy, pd->points, track.shownPoints, target);
             }
         }
-    }
 
-    // Push filtered error bars to their views
-    for (auto it = viewErrorBars.begin(); it != viewErrorBars.end(); ++it)
-        it.key()->setErrorBarData(it.value());
+        if (track.errorBarView && !track.errorBarPrefix.isEmpty())
+            track.errorBarView->setErrorBarPrefix(series, track.errorBarPrefix[frame]);
+    }
 
     // Update metrics overlays progressively (stats for data up to current cutoff)
-    if (!m_plotSettings.tsMetrics.isEmpty() && !m_animMatchedPairs.isEmpty()) {
+    if (!m_plotSettings.tsMetrics.isEmpty() && !m_animMetricsIndex.isEmpty()) {
         QStringList varOrder;
         for (const auto &pd : m_plotDataList)
             if (!varOrder.contains(pd->variable)) varOrder.append(pd->variable);
@@ -5186,7 +5903,7 @@ void PlotWidget::applyAnimFrame(int frame)
             if (!m_tsPanelOverlays.contains(varCode)) continue;
             QLabel *lbl = m_tsPanelOverlays[varCode];
             if (!lbl) continue;
-            QStringList parts = computeAnimMetricsForVar(varCode, cutoff, metricSet);
+            QStringList parts = computeAnimMetricsForVar(varCode, frame, metricSet);
             if (!parts.isEmpty()) {
                 lbl->setText(parts.join("\n"));
                 lbl->adjustSize();
@@ -5200,7 +5917,7 @@ void PlotWidget::applyAnimFrame(int frame)
         if (m_tsMetricsOverlay) {
             QStringList rows;
             for (const QString &varCode : varOrder) {
-                QStringList parts = computeAnimMetricsForVar(varCode, cutoff, metricSet);
+                QStringList parts = computeAnimMetricsForVar(varCode, frame, metricSet);
                 if (parts.isEmpty()) continue;
                 QPair<QString,QString> vi = DataProcessor::getVariableInfo(varCode);
                 QString varLabel = vi.first.isEmpty() ? varCode : vi.first;
@@ -5359,7 +6076,8 @@ void PlotWidget::injectSnapshotSeries(QChart *chart)
     QVector<QSharedPointer<PlotData>> ghosts = buildSnapshotSeriesForCurrentX();
 
     for (const QSharedPointer<PlotData> &snapPD : ghosts) {
-        if (!snapPD || snapPD->points.isEmpty()) continue;
+        // Ensemble bands are not ghosted; the median line stands in for them
+        if (!snapPD || snapPD->points.isEmpty() || !snapPD->lowerPoints.isEmpty()) continue;
 
         QColor c = snapPD->color;
         c.setAlphaF(0.5);
@@ -5451,6 +6169,9 @@ QVector<QSharedPointer<PlotData>> PlotWidget::buildSnapshotSeriesForCurrentX()
     if (m_snapshotDataList.isEmpty()) return out;
 
     const QString xVar = m_currentXVar;
+    // The frozen tables never change, so ghosts are built once per x-variable
+    auto cached = m_snapshotGhostCache.constFind(xVar);
+    if (cached != m_snapshotGhostCache.constEnd()) return cached.value();
 
     auto buildPoints = [&](const DataTable &tbl, const QString &experiment,
                            const QString &treatment, const QString &variable) {
@@ -5489,6 +6210,7 @@ QVector<QSharedPointer<PlotData>> PlotWidget::buildSnapshotSeriesForCurrentX()
         ghost->series    = nullptr;
         out.append(ghost);
     }
+    m_snapshotGhostCache.insert(xVar, out);
     return out;
 }
 
@@ -5505,6 +6227,7 @@ void PlotWidget::takeSnapshot()
     m_snapshotTreatments = m_currentTreatments;
     m_snapshotExperiment = m_selectedExperiment;
     m_snapshotActive     = true;
+    m_snapshotGhostCache.clear();
 
     injectSnapshotSeries(m_chart);
 
@@ -5524,6 +6247,7 @@ void PlotWidget::clearSnapshot()
     m_snapshotTreatments.clear();
     m_snapshotExperiment.clear();
     m_snapshotActive = false;
+    m_snapshotGhostCache.clear();
 
     // Remove snapshot series — they are any series NOT tracked in m_seriesToPlotData
     if (m_chart) {
@@ -1,5 +1,6 @@
 #include "PlotWidget.h"
 #include "DataProcessor.h"
+#include "Parallel.h"
 #include <QtCharts/QValueAxis>
 #include <QtCharts/QScatterSeries>
 #include <QLabel>
@@ -9,12 +10,67 @@
 #include <cmath>
 #include <algorithm>
 #include <limits>
+#include <vector>
 
-void PlotWidget::plotOsuBoxPlot(const DataTable &simData, const QStringList &yVars,
-                                 const QStringList &treatments, const QString &selectedExperiment)
+namespace {
+
+// Work (values summarised) above which groups are spread over worker threads
+constexpr int BOX_PLOT_PARALLEL_MIN_VALUES = 50000;
+
+// Five-number summary of one group by successive nth_element selection: only the
+// ranks the linear-interpolated quantiles need are placed, each selection working
+// on the range above the previous rank. Reorders [first, last).
+void summariseGroup(double *first, double *last, ErrorBarChartView::BoxPlotStats &bp)
 {
-    if (!m_chart || yVars.isEmpty()) return;
+    const int n = static_cast<int>(last - first);
+    bp.n = n;
+    if (n == 0) {
+        bp.q0 = bp.q1 = bp.q2 = bp.q3 = bp.q4 = 0.0;
+        return;
+    }
+
+    const double ps[3] = { 0.25, 0.50, 0.75 };
+    int ranks[8];
+    int nRanks = 0;
+    ranks[nRanks++] = 0;
+    for (double p : ps) {
+        int lo = static_cast<int>(p * (n - 1));
+        ranks[nRanks++] = lo;
+        ranks[nRanks++] = std::min(lo + 1, n - 1);
+    }
+    ranks[nRanks++] = n - 1;
+    std::sort(ranks, ranks + nRanks);
+    nRanks = static_cast<int>(std::unique(ranks, ranks + nRanks) - ranks);
+
+    int from = 0;
+    for (int i = 0; i < nRanks; ++i) {
+        std::nth_element(first + from, first + ranks[i], last);
+        from = ranks[i] + 1;
+    }
 
+    auto quantile = [&](double p) -> double {
+        double pos = p * (n - 1);
+        int lo = static_cast<int>(pos);
+        int hi = lo + 1;
+        if (hi >= n) return first[n - 1];
+        return first[lo] + (pos - lo) * (first[hi] - first[lo]);
+    };
+    bp.q0 = first[0];
+    bp.q1 = quantile(0.25);
+    bp.q2 = quantile(0.50);
+    bp.q3 = quantile(0.75);
+    bp.q4 = first[n - 1];
+}
+
+} // namespace
+
+// Row → group assignment for the current filter. Depends only on the key columns and
+// the treatment/experiment filter, so it is shared by all variables and survives replots
+// of the same data (m_dataVersion) that change styling, scaling or the variable list.
+const PlotWidget::BoxPlotGrouping &PlotWidget::boxPlotGroupingFor(const DataTable &simData,
+                                                                  const QStringList &treatments,
+                                                                  const QString &selectedExperiment)
+{
     const DataColumn *trtColumn  = simData.getColumn("TRT");
     const DataColumn *expColumn  = simData.getColumn("EXPERIMENT");
     const DataColumn *tnameCol   = simData.getColumn("TNAME");
@@ -22,6 +78,18 @@ void PlotWidget::plotOsuBoxPlot(const DataTable &simData, const QStringList &yVa
     const DataColumn *mdatCol    = simData.getColumn("MDAT");
     const DataColumn *rseqColumn = simData.getColumn("R#");  // sequence slot (rotation position)
 
+    const QString filterKey = treatments.join('\x1f') + '\x1e' + selectedExperiment;
+    if (m_boxPlotGrouping.dataVersion == m_dataVersion && m_boxPlotGrouping.filterKey == filterKey
+        && m_boxPlotGrouping.rowGroup.size() == simData.rowCount)
+        return m_boxPlotGrouping;
+
+    m_boxPlotVarCache.clear();
+    BoxPlotGrouping g;
+    g.dataVersion = m_dataVersion;
+    g.filterKey = filterKey;
+    g.rowGroup.fill(-1, simData.rowCount);
+    g.rowMdatMissing.fill(false, simData.rowCount);
+
     // Detect sequence OSU: all TRT values are identical but R# has multiple unique values
     bool isSequenceMode = false;
     if (trtColumn && rseqColumn) {
@@ -30,6 +98,7 @@ void PlotWidget::plotOsuBoxPlot(const DataTable &simData, const QStringList &yVa
         for (const QVariant &v : rseqColumn->data) uniqueRseq.insert(v.toString().trimmed());
         isSequenceMode = (uniqueTrts.size() == 1) && (uniqueRseq.size() > 1);
     }
+    g.isSequenceMode = isSequenceMode;
 
     // In sequence mode, treatments list uses "R#::<slot>" keys — extract allowed slots
     QSet<QString> allowedRseqSlots;
@@ -40,7 +109,10 @@ void PlotWidget::plotOsuBoxPlot(const DataTable &simData, const QStringList &yVa
             if (t.startsWith("R#::")) allowedRseqSlots.insert(t.mid(4));
     }
 
-    if (!trtColumn) { qWarning() << "PlotOsuBoxPlot: missing TRT column"; return; }
+    if (!trtColumn) {
+        m_boxPlotGrouping = g;
+        return m_boxPlotGrouping;
+    }
 
     // Determine if multiple experiments or multiple crops are present
     QSet<QString> expSet, cropSet;
@@ -58,17 +130,195 @@ void PlotWidget::plotOsuBoxPlot(const DataTable &simData, const QStringList &yVa
     bool multiExp  = expSet.size() > 1;
     bool multiCrop = cropSet.size() > 1;
 
-    // Quantile helper
-    auto quantile = [](QVector<double> &sorted, double p) -> double {
-        int n = sorted.size();
-        if (n == 0) return 0.0;
-        if (n == 1) return sorted[0];
-        double pos = p * (n - 1);
-        int lo = static_cast<int>(pos);
-        int hi = lo + 1;
-        if (hi >= n) return sorted[n - 1];
-        return sorted[lo] + (pos - lo) * (sorted[hi] - sorted[lo]);
-    };
+    QHash<QString, int> keyIndex;
+    for (int row = 0; row < simData.rowCount; ++row) {
+        if (row >= trtColumn->data.size()) continue;
+
+        QString trt = trtColumn->data[row].toString();
+        QString experiment = selectedExperiment;
+        if (expColumn && row < expColumn->data.size()) {
+            QString e = expColumn->data[row].toString();
+            if (!e.isEmpty()) experiment = e;
+        }
+        QString crop = "XX";
+        if (cropColumn && row < cropColumn->data.size()) {
+            QString c = cropColumn->data[row].toString();
+            if (!c.isEmpty()) crop = c;
+        }
+
+        QString rseq;
+        if (rseqColumn && row < rseqColumn->data.size())
+            rseq = rseqColumn->data[row].toString().trimmed();
+
+        // Filter rows
+        if (isSequenceMode) {
+            if (filterByRseq && !allowedRseqSlots.contains(rseq)) continue;
+        } else {
+            if (!treatments.isEmpty() && !treatments.contains("All")
+                && !treatments.contains(trt)
+                && !treatments.contains(experiment + "::" + trt))
+                continue;
+        }
+
+        QString key;
+        if (isSequenceMode) {
+            key = "R#::" + rseq;
+        } else if (multiCrop) {
+            key = crop + "::" + rseq + "::" + experiment + "::" + trt;
+        } else if (multiExp) {
+            key = experiment + "::" + trt;
+        } else {
+            key = trt;
+        }
+
+        auto it = keyIndex.constFind(key);
+        if (it == keyIndex.constEnd()) {
+            QString tname;
+            if (tnameCol && row < tnameCol->data.size())
+                tname = tnameCol->data[row].toString().trimmed();
+            QString label;
+            if (isSequenceMode) {
+                // Label: "Crop (slot)" e.g. "Bean" or "BN·1"
+                label = tname.isEmpty() ? crop : tname;
+            } else if (multiCrop) {
+                label = tname.isEmpty() ? crop : tname;
+            } else if (multiExp) {
+                label = tname.isEmpty() ? QString("%1·%2").arg(trt, experiment)
+                                        : QString("%1·%2").arg(trt, tname);
+            } else {
+                label = tname.isEmpty() ? trt : QString("%1-%2").arg(trt, tname);
+            }
+            it = keyIndex.insert(key, g.groupKeys.size());
+            g.groupKeys.append(key);
+            g.groupLabels.append(label);
+        }
+        g.rowGroup[row] = it.value();
+        g.rowMdatMissing[row] = mdatCol && row < mdatCol->data.size()
+                                && DataProcessor::isMissingValue(mdatCol->data[row]);
+        g.anyMdatMissing = g.anyMdatMissing || g.rowMdatMissing[row];
+    }
+
+    g.groupColumn.name = "BOXPLOT_GROUP";
+    g.groupColumn.data.resize(simData.rowCount);
+    for (int row = 0; row < simData.rowCount; ++row)
+        if (g.rowGroup[row] >= 0) g.groupColumn.data[row] = g.rowGroup[row];
+
+    m_boxPlotGrouping = g;
+    return m_boxPlotGrouping;
+}
+
+// Five-number summaries of one variable for every group of m_boxPlotGrouping. Without
+// crop-failure rows to drop they are read from the grouped quantile sketches of the
+// loaded column, which stay cached on it. Otherwise values are bucketed into one
+// contiguous buffer (counting sort by group), then each group's slice is summarised by
+// selection; large inputs spread groups over worker threads. Cached per variable name
+// for the data version and the scaling applied to the column.
+const QVector<ErrorBarChartView::BoxPlotStats> &PlotWidget::boxPlotStatsFor(const DataTable &simData,
+                                                                            const QString &yVar)
+{
+    const DataColumn *yColumn = simData.getColumn(yVar);
+
+    QString scaleKey;
+    if (m_scaleFactors.contains("default") && m_scaleFactors["default"].contains(yVar)) {
+        const ScalingInfo &info = m_scaleFactors["default"][yVar];
+        scaleKey = QString::number(info.scaleFactor, 'g', 17) + "," + QString::number(info.offset, 'g', 17);
+    }
+
+    auto cached = m_boxPlotVarCache.constFind(yVar);
+    if (cached != m_boxPlotVarCache.constEnd() && cached->dataVersion == m_dataVersion
+        && cached->scaleKey == scaleKey)
+        return cached->stats;
+
+    const BoxPlotGrouping &g = m_boxPlotGrouping;
+    const int nGroups = g.groupKeys.size();
+
+    // The plotted column is a scaled copy; the loaded one keeps its stats across replots.
+    // Scaling multiplies by a positive factor (zeros stay zero), so it maps the quantiles.
+    const DataColumn *loadedColumn = m_simData.getColumn(yVar);
+    double scale = 1.0, offset = 0.0;
+    if (m_scaleFactors.contains("default") && m_scaleFactors["default"].contains(yVar)) {
+        const ScalingInfo &info = m_scaleFactors["default"][yVar];
+        if (qAbs(info.scaleFactor - 1.0) >= 0.001 || qAbs(info.offset) >= 0.001) {
+            scale = info.scaleFactor;
+            offset = info.offset;
+        }
+    }
+    if (!g.anyMdatMissing && loadedColumn && scale > 0.0 && offset == 0.0
+        && loadedColumn->data.size() == yColumn->data.size()
+        && g.groupColumn.data.size() == yColumn->data.size()) {
+        const QHash<QString, ColumnStats> &groups = loadedColumn->groupStats(g.groupColumn, true);
+        QVector<ErrorBarChartView::BoxPlotStats> stats(nGroups);
+        for (int gi = 0; gi < nGroups; ++gi) {
+            ErrorBarChartView::BoxPlotStats &bp = stats[gi];
+            const ColumnStats gs = groups.value(QString::number(gi));
+            bp.n = gs.count;
+            if (gs.isEmpty()) {
+                bp.q0 = bp.q1 = bp.q2 = bp.q3 = bp.q4 = 0.0;
+                continue;
+            }
+            bp.q0 = gs.min * scale;
+            bp.q1 = gs.quantile(0.25) * scale;
+            bp.q2 = gs.quantile(0.50) * scale;
+            bp.q3 = gs.quantile(0.75) * scale;
+            bp.q4 = gs.max * scale;
+        }
+        BoxPlotVarCache entry;
+        entry.dataVersion = m_dataVersion;
+        entry.scaleKey = scaleKey;
+        entry.stats = stats;
+        return m_boxPlotVarCache.insert(yVar, entry)->stats;
+    }
+
+    const int nRows = qMin(g.rowGroup.size(), yColumn->data.size());
+
+    // Pass 1: parse once into a typed buffer, counting values per group
+    QVector<double> rowValue(nRows, std::numeric_limits<double>::quiet_NaN());
+    QVector<int> offsets(nGroups + 1, 0);
+    for (int row = 0; row < nRows; ++row) {
+        int gi = g.rowGroup[row];
+        if (gi < 0) continue;
+        QVariant yVal = yColumn->data[row];
+        if (DataProcessor::isMissingValue(yVal)) continue;
+        bool ok;
+        double y = yVal.toDouble(&ok);
+        if (!ok) continue;
+        // Skip crop-failure rows (y==0 and MDAT missing)
+        if (qFuzzyIsNull(y) && g.rowMdatMissing[row]) continue;
+        rowValue[row] = y;
+        ++offsets[gi + 1];
+    }
+    for (int gi = 0; gi < nGroups; ++gi)
+        offsets[gi + 1] += offsets[gi];
+
+    // Pass 2: scatter into contiguous per-group slices (row order within a group kept)
+    QVector<double> values(offsets[nGroups]);
+    QVector<int> fill = offsets;
+    for (int row = 0; row < nRows; ++row) {
+        int gi = g.rowGroup[row];
+        if (gi < 0 || std::isnan(rowValue[row])) continue;
+        values[fill[gi]++] = rowValue[row];
+    }
+
+    QVector<ErrorBarChartView::BoxPlotStats> stats(nGroups);
+    double *buf = values.data();
+    const int *bounds = offsets.constData();
+    ErrorBarChartView::BoxPlotStats *out = stats.data();
+    Parallel::forEach(nGroups, Parallel::threadCount(values.size(), BOX_PLOT_PARALLEL_MIN_VALUES),
+                      [&](int gi) { summariseGroup(buf + bounds[gi], buf + bounds[gi + 1], out[gi]); });
+
+    BoxPlotVarCache entry;
+    entry.dataVersion = m_dataVersion;
+    entry.scaleKey = scaleKey;
+    entry.stats = stats;
+    return m_boxPlotVarCache.insert(yVar, entry)->stats;
+}
+
+void PlotWidget::plotOsuBoxPlot(const DataTable &simData, const QStringList &yVars,
+                                 const QStringList &treatments, const QString &selectedExperiment)
+{
+    if (!m_chart || yVars.isEmpty()) return;
+
+    if (!simData.getColumn("TRT")) { qWarning() << "PlotOsuBoxPlot: missing TRT column"; return; }
 
     // Distinct colors per variable
     const QVector<QColor> varColors = {
@@ -80,106 +330,34 @@ void PlotWidget::plotOsuBoxPlot(const DataTable &simData, const QStringList &yVa
         QColor(180, 160,  40, 180),   // olive
     };
 
-    // Collect per-variable stats and shared category keys
-    struct BoxStats { double q0, q1, q2, q3, q4; };
-    // perVarStats[vi] = vector of BoxStats (one per trtKey)
-    QVector<QVector<BoxStats>> perVarStats;
-    QStringList trtKeys;
-    QMap<QString, QString> keyToLabel;
-    double globalMin =  std::numeric_limits<double>::max();
-    double globalMax = -std::numeric_limits<double>::max();
-
     // Filter yVars to those present in data
     QStringList validYVars;
     for (const QString &yv : yVars)
         if (simData.getColumn(yv)) validYVars.append(yv);
     if (validYVars.isEmpty()) return;
 
-    for (int vi = 0; vi < validYVars.size(); ++vi) {
-        const QString &yVar = validYVars[vi];
-        const DataColumn *yColumn = simData.getColumn(yVar);
-
-        QMap<QString, QVector<double>> trtValues;
-
-        for (int row = 0; row < simData.rowCount; ++row) {
-            if (row >= trtColumn->data.size()) continue;
-
-            QString trt = trtColumn->data[row].toString();
-            QString experiment = selectedExperiment;
-            if (expColumn && row < expColumn->data.size()) {
-                QString e = expColumn->data[row].toString();
-                if (!e.isEmpty()) experiment = e;
-            }
-            QString crop = "XX";
-            if (cropColumn && row < cropColumn->data.size()) {
-                QString c = cropColumn->data[row].toString();
-                if (!c.isEmpty()) crop = c;
-            }
-
-            QString rseq;
-            if (rseqColumn && row < rseqColumn->data.size())
-                rseq = rseqColumn->data[row].toString().trimmed();
-
-            // Filter rows
-            if (isSequenceMode) {
-                if (filterByRseq && !allowedRseqSlots.contains(rseq)) continue;
-            } else {
-                if (!treatments.isEmpty() && !treatments.contains("All")
-                    && !treatments.contains(trt)
-                    && !treatments.contains(experiment + "::" + trt))
-                    continue;
-            }
+    const BoxPlotGrouping &grouping = boxPlotGroupingFor(simData, treatments, selectedExperiment);
 
-            if (row >= yColumn->data.size()) continue;
-            QVariant yVal = yColumn->data[row];
-            if (DataProcessor::isMissingValue(yVal)) continue;
-            bool ok;
-            double y = yVal.toDouble(&ok);
-            if (!ok) continue;
-
-            // Skip crop-failure rows (y==0 and MDAT missing)
-            if (qFuzzyIsNull(y) && mdatCol && row < mdatCol->data.size()
-                && DataProcessor::isMissingValue(mdatCol->data[row]))
-                continue;
-
-            QString key;
-            if (isSequenceMode) {
-                key = "R#::" + rseq;
-            } else if (multiCrop) {
-                key = crop + "::" + rseq + "::" + experiment + "::" + trt;
-            } else if (multiExp) {
-                key = experiment + "::" + trt;
-            } else {
-                key = trt;
-            }
+    // perVarStats[vi] = stats per group index; trtKeys/groupOrder follow the first
+    // variable that has any values
+    QVector<QVector<ErrorBarChartView::BoxPlotStats>> perVarStats;
+    QStringList trtKeys;
+    QVector<int> groupOrder;
+    QMap<QString, QString> keyToLabel;
+    double globalMin =  std::numeric_limits<double>::max();
+    double globalMax = -std::numeric_limits<double>::max();
 
-            trtValues[key].append(y);
-
-            if (!keyToLabel.contains(key)) {
-                QString tname;
-                if (tnameCol && row < tnameCol->data.size())
-                    tname = tnameCol->data[row].toString().trimmed();
-                if (isSequenceMode) {
-                    // Label: "Crop (slot)" e.g. "Bean" or "BN·1"
-                    keyToLabel[key] = tname.isEmpty() ? crop : tname;
-                } else if (multiCrop) {
-                    keyToLabel[key] = tname.isEmpty() ? crop : tname;
-                } else if (multiExp) {
-                    keyToLabel[key] = tname.isEmpty() ? QString("%1·%2").arg(trt, experiment)
-                                                      : QString("%1·%2").arg(trt, tname);
-                } else {
-                    keyToLabel[key] = tname.isEmpty() ? trt : QString("%1-%2").arg(trt, tname);
-                }
-            }
-        }
+    for (const QString &yVar : validYVars) {
+        const QVector<ErrorBarChartView::BoxPlotStats> &vstats = boxPlotStatsFor(simData, yVar);
 
-        if (trtValues.isEmpty()) continue;
+        if (groupOrder.isEmpty()) {
+            for (int gi = 0; gi < vstats.size(); ++gi)
+                if (vstats[gi].n > 0) groupOrder.append(gi);
+            if (groupOrder.isEmpty()) continue;
 
-        // Build sorted key list from first valid variable
-        if (trtKeys.isEmpty()) {
-            trtKeys = trtValues.keys();
-            std::sort(trtKeys.begin(), trtKeys.end(), [&](const QString &a, const QString &b) {
-                QStringList pa = a.split("::"), pb = b.split("::");
+            // Build sorted key list from first valid variable
+            std::sort(groupOrder.begin(), groupOrder.end(), [&](int ga, int gb) {
+                QStringList pa = grouping.groupKeys[ga].split("::"), pb = grouping.groupKeys[gb].split("::");
                 int n = qMax(pa.size(), pb.size());
                 for (int i = 0; i < n; ++i) {
                     QString sa = (i < pa.size()) ? pa[i] : QString();
@@ -191,41 +369,41 @@ void PlotWidget::plotOsuBoxPlot(const DataTable &simData, const QStringList &yVa
                 }
                 return false;
             });
-        }
+            for (int gi : groupOrder) {
+                trtKeys.append(grouping.groupKeys[gi]);
+                keyToLabel[grouping.groupKeys[gi]] = grouping.groupLabels[gi];
+            }
 
-        // In sequence mode, suffix duplicate crop names with their slot number
-        if (isSequenceMode && vi == 0) {
-            QMap<QString, int> labelCount;
-            for (const QString &k : trtKeys)
-                labelCount[keyToLabel.value(k)]++;
-            for (const QString &k : trtKeys) {
-                if (labelCount.value(keyToLabel.value(k)) > 1) {
-                    // Extract slot number from key "R#::<n>"
-                    QString slot = k.startsWith("R#::") ? k.mid(4) : k;
-                    keyToLabel[k] = QString("%1 (%2)").arg(keyToLabel.value(k), slot);
+            // In sequence mode, suffix duplicate crop names with their slot number
+            if (grouping.isSequenceMode) {
+                QMap<QString, int> labelCount;
+                for (const QString &k : trtKeys)
+                    labelCount[keyToLabel.value(k)]++;
+                for (const QString &k : trtKeys) {
+                    if (labelCount.value(keyToLabel.value(k)) > 1) {
+                        // Extract slot number from key "R#::<n>"
+                        QString slot = k.startsWith("R#::") ? k.mid(4) : k;
+                        keyToLabel[k] = QString("%1 (%2)").arg(keyToLabel.value(k), slot);
+                    }
                 }
             }
+        } else {
+            bool any = false;
+            for (const auto &bp : vstats)
+                if (bp.n > 0) { any = true; break; }
+            if (!any) continue;
         }
 
-        QVector<BoxStats> vstats;
-        for (const QString &k : trtKeys) {
-            QVector<double> vals = trtValues.value(k);
-            std::sort(vals.begin(), vals.end());
-            if (vals.isEmpty()) {
-                vstats.append({0,0,0,0,0});
-                continue;
-            }
-            BoxStats s;
-            s.q0 = vals.first();
-            s.q1 = quantile(vals, 0.25);
-            s.q2 = quantile(vals, 0.50);
-            s.q3 = quantile(vals, 0.75);
-            s.q4 = vals.last();
-            vstats.append(s);
-            globalMin = std::min(globalMin, s.q0);
-            globalMax = std::max(globalMax, s.q4);
+        QVector<ErrorBarChartView::BoxPlotStats> ordered;
+        ordered.reserve(groupOrder.size());
+        for (int gi : groupOrder) {
+            const auto &bp = vstats[gi];
+            ordered.append(bp);
+            if (bp.n == 0) continue;
+            globalMin = std::min(globalMin, bp.q0);
+            globalMax = std::max(globalMax, bp.q4);
         }
-        perVarStats.append(vstats);
+        perVarStats.append(ordered);
     }
 
     if (trtKeys.isEmpty() || perVarStats.isEmpty()) return;
@@ -322,6 +500,7 @@ void PlotWidget::plotOsuBoxPlot(const DataTable &simData, const QStringList &yVa
             const auto &s = perVarStats[vi][ci];
             bp.q0       = s.q0;  bp.q1 = s.q1;  bp.q2 = s.q2;
             bp.q3       = s.q3;  bp.q4 = s.q4;
+            bp.n        = s.n;
             bp.label    = (vi == 0) ? categories[ci] : QString();
             bp.color    = varColors[vi % varColors.size()];
             bp.varIndex = vi;
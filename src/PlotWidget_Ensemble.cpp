@@ -0,0 +1,175 @@
+#include "PlotWidget.h"
+#include "Parallel.h"
+#include <QtCharts/QAreaSeries>
+#include <QtCharts/QLineSeries>
+#include <QDebug>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// P5/P25/P50/P75/P95 and mean of one x slice by successive nth_element selection —
+// the same linear-interpolated quantiles as the box plot. Reorders [first, last).
+void summariseSlice(double *first, double *last, PlotWidget::EnsembleStats &st)
+{
+    const int n = static_cast<int>(last - first);
+
+    double sum = 0.0;
+    for (const double *v = first; v != last; ++v) sum += *v;
+    st.mean = sum / n;
+
+    const double ps[5] = { 0.05, 0.25, 0.50, 0.75, 0.95 };
+    int ranks[10];
+    int nRanks = 0;
+    for (double p : ps) {
+        int lo = static_cast<int>(p * (n - 1));
+        ranks[nRanks++] = lo;
+        ranks[nRanks++] = std::min(lo + 1, n - 1);
+    }
+    std::sort(ranks, ranks + nRanks);
+    nRanks = static_cast<int>(std::unique(ranks, ranks + nRanks) - ranks);
+
+    int from = 0;
+    for (int i = 0; i < nRanks; ++i) {
+        std::nth_element(first + from, first + ranks[i], last);
+        from = ranks[i] + 1;
+    }
+
+    auto quantile = [&](double p) -> double {
+        double pos = p * (n - 1);
+        int lo = static_cast<int>(pos);
+        int hi = lo + 1;
+        if (hi >= n) return first[n - 1];
+        return first[lo] + (pos - lo) * (first[hi] - first[lo]);
+    };
+    st.p5  = quantile(0.05);
+    st.p25 = quantile(0.25);
+    st.p50 = quantile(0.50);
+    st.p75 = quantile(0.75);
+    st.p95 = quantile(0.95);
+}
+
+} // namespace
+
+// Pools every run and summarises the values found at each distinct x. Runs of one
+// treatment share their output dates, so equal x values group exactly.
+QVector<PlotWidget::EnsembleStats> PlotWidget::summariseEnsemble(const QVector<QVector<QPointF>> &runs)
+{
+    qsizetype total = 0;
+    for (const QVector<QPointF> &run : runs) total += run.size();
+
+    std::vector<QPointF> pooled;
+    pooled.reserve(total);
+    for (const QVector<QPointF> &run : runs)
+        for (const QPointF &pt : run)
+            if (std::isfinite(pt.x()) && std::isfinite(pt.y()))
+                pooled.push_back(pt);
+    if (pooled.empty()) return {};
+
+    std::sort(pooled.begin(), pooled.end(),
+              [](const QPointF &a, const QPointF &b) { return a.x() < b.x(); });
+
+    // One contiguous y buffer with slice offsets per distinct x
+    const int n = static_cast<int>(pooled.size());
+    std::vector<double> values(n);
+    QVector<int> offsets;
+    offsets.append(0);
+    for (int i = 0; i < n; ++i) {
+        values[i] = pooled[i].y();
+        if (i > 0 && pooled[i].x() != pooled[i - 1].x())
+            offsets.append(i);
+    }
+    offsets.append(n);
+
+    const int nSlices = offsets.size() - 1;
+    QVector<EnsembleStats> stats(nSlices);
+    for (int si = 0; si < nSlices; ++si)
+        stats[si].x = pooled[offsets[si]].x();
+
+    double *buf = values.data();
+    const int *bounds = offsets.constData();
+    EnsembleStats *out = stats.data();
+    Parallel::forEach(nSlices, Parallel::threadCount(n, ENSEMBLE_PARALLEL_MIN_POINTS),
+                      [&](int si) { summariseSlice(buf + bounds[si], buf + bounds[si + 1], out[si]); });
+    return stats;
+}
+
+// Outer band, inner band, mean line and median line for one treatment. The median comes
+// last so it is the series the legend row, hover and highlight pick for the treatment.
+QVector<PlotData> PlotWidget::ensemblePlotData(const PlotData &base, const QVector<EnsembleStats> &stats)
+{
+    PlotData outer = base, inner = base, mean = base, median = base;
+    outer.ensembleRole = "P5-P95";
+    inner.ensembleRole = "P25-P75";
+    mean.ensembleRole = "Mean";
+    median.ensembleRole = "P50";
+    for (PlotData *pd : { &outer, &inner, &mean, &median }) {
+        pd->points.clear();
+        pd->points.reserve(stats.size());
+    }
+    outer.lowerPoints.reserve(stats.size());
+    inner.lowerPoints.reserve(stats.size());
+
+    for (const EnsembleStats &st : stats) {
+        outer.points.append(QPointF(st.x, st.p95));
+        outer.lowerPoints.append(QPointF(st.x, st.p5));
+        inner.points.append(QPointF(st.x, st.p75));
+        inner.lowerPoints.append(QPointF(st.x, st.p25));
+        mean.points.append(QPointF(st.x, st.mean));
+        median.points.append(QPointF(st.x, st.p50));
+    }
+    return { outer, inner, mean, median };
+}
+
+// Translucent fill between the band edges, no outline. The edge series are owned by
+// the area series.
+QAbstractSeries *PlotWidget::createEnsembleBandSeries(const QSharedPointer<PlotData> &plotData) const
+{
+    QLineSeries *upper = new QLineSeries();
+    QLineSeries *lower = new QLineSeries();
+    upper->replace(plotData->points);
+    lower->replace(plotData->lowerPoints);
+
+    QAreaSeries *area = new QAreaSeries(upper, lower);
+    upper->setParent(area);
+    lower->setParent(area);
+    area->setUseOpenGL(false);
+    area->setName(QString("%1 - %2 (%3)")
+                  .arg(plotData->treatmentName, plotData->variable, plotData->ensembleRole));
+
+    QColor fill = plotData->color;
+    fill.setAlphaF(plotData->ensembleRole == "P5-P95" ? 0.18 : 0.32);
+    area->setPen(Qt::NoPen);
+    area->setBrush(fill);
+
+    // Baseline for highlight/reset
+    plotData->pen = QPen(Qt::NoPen);
+    plotData->brush = QBrush(fill);
+    plotData->symbol = "";
+    return area;
+}
+
+// Bands and the mean line follow the visibility of their median line, which is the
+// series the legend row toggles.
+void PlotWidget::linkEnsembleSeries(const QVector<QSharedPointer<PlotData>> &plotDataList)
+{
+    auto groupKey = [](const PlotData &pd) {
+        return QString("%1__%2__%3__%4").arg(pd.crop, pd.experiment, pd.treatment, pd.variable);
+    };
+
+    QHash<QString, QAbstractSeries*> medians;
+    for (const auto &pd : plotDataList)
+        if (pd && pd->series && pd->ensembleRole == "P50")
+            medians.insert(groupKey(*pd), pd->series.data());
+
+    for (const auto &pd : plotDataList) {
+        if (!pd || !pd->series || pd->ensembleRole.isEmpty() || pd->ensembleRole == "P50") continue;
+        QAbstractSeries *median = medians.value(groupKey(*pd));
+        if (!median) continue;
+        QAbstractSeries *member = pd->series.data();
+        member->setProperty("ensemble_median", QVariant::fromValue<QObject*>(median));
+        connect(median, &QAbstractSeries::visibleChanged, member,
+                [median, member]() { member->setVisible(median->isVisible()); });
+    }
+}
@@ -1,10 +1,56 @@
 #include "PlotWidget.h"
+#include "Parallel.h"
+#include <QGraphicsItem>
 #include <QPainter>
 #include <QPainterPath>
+#include <QLinearGradient>
 #include <QDebug>
 #include <QDateTime>
 #include <QtCharts/QDateTimeAxis>
 #include <cmath>
+#include <vector>
+
+namespace {
+
+// Scene item that paints the view's raster layer. Qt Charts stacks grid lines at z 2,
+// axes at 3 and every series at 4 (ChartPresenter::ZValues), so this sits above the
+// grid and beneath the observed markers.
+class RasterLayerItem : public QGraphicsItem
+{
+public:
+    static constexpr qreal Z_VALUE = 3.5;
+
+    RasterLayerItem(ErrorBarChartView *view, QChart *chart)
+        : QGraphicsItem(chart), m_view(view), m_chart(chart)
+    {
+        setZValue(Z_VALUE);
+        setAcceptedMouseButtons(Qt::NoButton);
+        setAcceptHoverEvents(false);
+        m_rect = chart->plotArea();
+    }
+
+    void setRect(const QRectF &rect)
+    {
+        if (rect == m_rect) return;
+        prepareGeometryChange();
+        m_rect = rect;
+    }
+
+    QRectF boundingRect() const override { return m_rect; }
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *) override
+    {
+        // The image is in chart coordinates; this item's parent is the chart
+        if (m_view->chart() == m_chart) m_view->paintRasterLayer(painter);
+    }
+
+private:
+    ErrorBarChartView *m_view;
+    QChart *m_chart;
+    QRectF m_rect;
+};
+
+} // namespace
 
 ErrorBarChartView::ErrorBarChartView(QChart *chart, QWidget *parent)
     : QChartView(chart, parent)
@@ -14,9 +60,257 @@ ErrorBarChartView::ErrorBarChartView(QChart *chart, QWidget *parent)
 void ErrorBarChartView::setErrorBarData(const QMap<QAbstractSeries*, QVector<ErrorBarData>> &errorBars)
 {
     m_errorBars = errorBars;
+    m_errorBarPrefix.clear();
     update();
 }
 
+void ErrorBarChartView::setErrorBarPrefix(QAbstractSeries *series, int count)
+{
+    if (m_errorBarPrefix.value(series, -1) == count) return;
+    if (count < 0) m_errorBarPrefix.remove(series);
+    else           m_errorBarPrefix.insert(series, count);
+    viewport()->update();
+}
+
+void ErrorBarChartView::setRasterLines(const QVector<RasterLine> &lines)
+{
+    for (const RasterLine &line : m_rasterLines)
+        if (line.series) disconnect(line.series, nullptr, this, nullptr);
+
+    m_rasterLines = lines;
+    if (!m_rasterLines.isEmpty() && chart() && m_rasterItemChart != chart()) {
+        auto *item = new RasterLayerItem(this, chart());
+        connect(chart(), &QChart::plotAreaChanged, this,
+                [item](const QRectF &plotArea) { item->setRect(plotArea); });
+        m_rasterItem = item;
+        m_rasterItemChart = chart();
+    }
+    for (const RasterLine &line : m_rasterLines) {
+        if (!line.series) continue;
+        connect(line.series, &QAbstractSeries::visibleChanged, this, &ErrorBarChartView::invalidateRasterLayer);
+        if (auto *ls = qobject_cast<QLineSeries*>(line.series.data()))
+            connect(ls, &QLineSeries::penChanged, this, &ErrorBarChartView::invalidateRasterLayer);
+    }
+    invalidateRasterLayer();
+}
+
+void ErrorBarChartView::setRasterLinePoints(QAbstractSeries *series, const QVector<QPointF> &points)
+{
+    for (RasterLine &line : m_rasterLines) {
+        if (line.series == series) {
+            line.points = points;
+            invalidateRasterLayer();
+            return;
+        }
+    }
+}
+
+void ErrorBarChartView::clearRasterLines()
+{
+    setRasterLines({});
+    m_rasterImage = QImage();
+}
+
+void ErrorBarChartView::invalidateRasterLayer()
+{
+    m_rasterDirty = true;
+    if (m_rasterItem && m_rasterItemChart == chart()) m_rasterItem->update();
+    viewport()->update();
+}
+
+// Everything the raster image depends on besides lines/pens/visibility: viewport size,
+// plot area and the data→pixel mapping of the first line (all lines share the axes)
+QString ErrorBarChartView::rasterSignature() const
+{
+    if (!chart() || m_rasterLines.isEmpty()) return QString();
+    QAbstractSeries *ref = nullptr;
+    for (const RasterLine &line : m_rasterLines)
+        if (line.series) { ref = line.series; break; }
+    if (!ref) return QString();
+    QRectF pa = chart()->plotArea();
+    QPointF o  = chart()->mapToPosition(QPointF(0.0, 0.0), ref);
+    QPointF ux = chart()->mapToPosition(QPointF(1.0, 0.0), ref) - o;
+    QPointF uy = chart()->mapToPosition(QPointF(0.0, 1.0), ref) - o;
+    return QString("%1,%2,%3,%4|%5,%6|%7,%8|%9,%10|%11x%12@%13")
+        .arg(pa.x()).arg(pa.y()).arg(pa.width()).arg(pa.height())
+        .arg(o.x(), 0, 'g', 17).arg(o.y(), 0, 'g', 17)
+        .arg(ux.x(), 0, 'g', 17).arg(ux.y(), 0, 'g', 17)
+        .arg(uy.x(), 0, 'g', 17).arg(uy.y(), 0, 'g', 17)
+        .arg(viewport()->width()).arg(viewport()->height()).arg(devicePixelRatioF());
+}
+
+// Draw every visible raster line into one transparent, viewport-sized image clipped to
+// the plot area. Lines are split into contiguous chunks painted on worker threads into
+// their own images, then composited in order (source-over is associative, so the
+// result matches painting them one after another).
+void ErrorBarChartView::renderRasterLayer()
+{
+    m_rasterDirty = false;
+    m_rasterSignature = rasterSignature();
+    const qreal dpr = devicePixelRatioF();
+    const QSize size = viewport()->size() * dpr;
+    if (m_rasterSignature.isEmpty() || size.isEmpty()) {
+        m_rasterImage = QImage();
+        return;
+    }
+
+    // Collect what the workers need on this thread; series accessors stay on the GUI thread
+    struct Job { QPen pen; const QPointF *points; int count; };
+    std::vector<Job> jobs;
+    jobs.reserve(m_rasterLines.size());
+    QPointF o, ux, uy;
+    bool haveMapping = false;
+    for (const RasterLine &line : m_rasterLines) {
+        if (!line.series || !line.series->isVisible() || line.points.size() < 2) continue;
+        auto *ls = qobject_cast<QLineSeries*>(line.series.data());
+        if (!ls) continue;
+        if (!haveMapping) {
+            o  = chart()->mapToPosition(QPointF(0.0, 0.0), ls);
+            ux = chart()->mapToPosition(QPointF(1.0, 0.0), ls) - o;
+            uy = chart()->mapToPosition(QPointF(0.0, 1.0), ls) - o;
+            haveMapping = true;
+        }
+        jobs.push_back({ ls->pen(), line.points.constData(), int(line.points.size()) });
+    }
+
+    const QRectF clip = chart()->plotArea();
+    auto paintRange = [&](QImage &image, int from, int to) {
+        image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(dpr);
+        image.fill(Qt::transparent);
+        QPainter p(&image);
+        p.setRenderHint(QPainter::Antialiasing, true);
+        p.setClipRect(clip);
+        QPolygonF poly;
+        for (int j = from; j < to; ++j) {
+            const Job &job = jobs[j];
+            poly.resize(job.count);
+            for (int i = 0; i < job.count; ++i)
+                poly[i] = o + job.points[i].x() * ux + job.points[i].y() * uy;
+            p.setPen(job.pen);
+            p.drawPolyline(poly);
+        }
+    };
+
+    const int nJobs = int(jobs.size());
+    const int nThreads = Parallel::threadCount(nJobs, RASTER_PARALLEL_MIN_LINES, 8);
+    if (nThreads <= 1) {
+        paintRange(m_rasterImage, 0, nJobs);
+        return;
+    }
+
+    std::vector<QImage> layers(nThreads);
+    Parallel::forChunks(nJobs, nThreads, [&](int begin, int end, int t) { paintRange(layers[t], begin, end); });
+
+    m_rasterImage = layers[0];
+    QPainter p(&m_rasterImage);
+    for (int t = 1; t < nThreads; ++t)
+        p.drawImage(QPointF(0, 0), layers[t]);
+}
+
+void ErrorBarChartView::paintRasterLayer(QPainter *painter, const QPoint &viewportOffset)
+{
+    if (!painter || m_rasterLines.isEmpty() || !chart()) return;
+    if (m_rasterDirty || m_rasterSignature != rasterSignature())
+        renderRasterLayer();
+    if (m_rasterImage.isNull()) return;
+    painter->drawImage(QPointF(viewportOffset), m_rasterImage);
+}
+
+void ErrorBarChartView::setDensityBins(const DensityBins &bins, QAbstractSeries *mappingSeries)
+{
+    m_densityBins = bins;
+    m_densitySeries = mappingSeries;
+    viewport()->update();
+}
+
+void ErrorBarChartView::clearDensityBins()
+{
+    m_densityBins = DensityBins();
+    m_densitySeries = nullptr;
+    viewport()->update();
+}
+
+// Viridis-like ramp, t in [0, 1]
+static QColor densityColour(double t)
+{
+    static const QColor stops[] = {
+        QColor(68, 1, 84), QColor(59, 82, 139), QColor(33, 145, 140),
+        QColor(94, 201, 98), QColor(253, 231, 37)
+    };
+    constexpr int last = int(sizeof(stops) / sizeof(stops[0])) - 1;
+    t = qBound(0.0, t, 1.0) * last;
+    int i = qMin(int(t), last - 1);
+    double f = t - i;
+    const QColor &a = stops[i], &b = stops[i + 1];
+    return QColor::fromRgbF(a.redF()   + f * (b.redF()   - a.redF()),
+                            a.greenF() + f * (b.greenF() - a.greenF()),
+                            a.blueF()  + f * (b.blueF()  - a.blueF()));
+}
+
+void ErrorBarChartView::paintDensityLayer(QPainter *painter, const QPoint &viewportOffset)
+{
+    if (!painter || m_densityBins.counts.isEmpty() || !m_densitySeries || !chart()) return;
+
+    // Data→pixel mapping is affine on value axes: origin plus one unit step per axis
+    QAbstractSeries *ref = m_densitySeries.data();
+    const QPointF o0 = chart()->mapToPosition(QPointF(0.0, 0.0), ref);
+    const QPointF ux = chart()->mapToPosition(QPointF(1.0, 0.0), ref) - o0;
+    const QPointF uy = chart()->mapToPosition(QPointF(0.0, 1.0), ref) - o0;
+    const QPointF o  = o0 + QPointF(viewportOffset);
+
+    // Bin outline in pixels relative to its centre
+    const double w = m_densityBins.binWidth;
+    const double h = m_densityBins.binHeight;
+    QVector<QPointF> outline;
+    if (m_densityBins.hexagonal) {
+        const double r = h / 3.0;
+        outline = { {0.0, r}, {w / 2, r / 2}, {w / 2, -r / 2}, {0.0, -r}, {-w / 2, -r / 2}, {-w / 2, r / 2} };
+    } else {
+        outline = { {-w / 2, -h / 2}, {w / 2, -h / 2}, {w / 2, h / 2}, {-w / 2, h / 2} };
+    }
+    QPolygonF shape;
+    for (const QPointF &d : outline)
+        shape << d.x() * ux + d.y() * uy;
+
+    const QRectF plotArea = chart()->plotArea().translated(viewportOffset);
+    painter->save();
+    painter->setClipRect(plotArea);
+    painter->setRenderHint(QPainter::Antialiasing, false);  // no seams between bins
+    painter->setPen(Qt::NoPen);
+
+    const double logMax = std::log1p(double(qMax(1, m_densityBins.maxCount)));
+    QPolygonF cell(shape.size());
+    for (int i = 0; i < m_densityBins.counts.size(); ++i) {
+        const int count = m_densityBins.counts[i];
+        if (count <= 0) continue;
+        const QPointF &c = m_densityBins.centres[i];
+        const QPointF centre = o + c.x() * ux + c.y() * uy;
+        for (int k = 0; k < shape.size(); ++k)
+            cell[k] = centre + shape[k];
+        painter->setBrush(densityColour(logMax > 0 ? std::log1p(double(count)) / logMax : 1.0));
+        painter->drawPolygon(cell);
+    }
+
+    // Colour key along the bottom-right of the plot area: 1 … max points per bin
+    painter->setClipping(false);
+    const QRectF bar(plotArea.right() - 96, plotArea.bottom() - 22, 80, 6);
+    QLinearGradient grad(bar.topLeft(), bar.topRight());
+    for (int k = 0; k <= 4; ++k)
+        grad.setColorAt(k / 4.0, densityColour(k / 4.0));
+    painter->fillRect(bar, grad);
+    painter->setPen(QColor(60, 60, 60));
+    painter->setRenderHint(QPainter::TextAntialiasing, true);
+    QFont f = painter->font();
+    f.setPointSizeF(7);
+    painter->setFont(f);
+    const QRectF labels(bar.left(), bar.bottom() + 1, bar.width(), 12);
+    painter->drawText(labels, Qt::AlignLeft | Qt::AlignTop, "1");
+    painter->drawText(labels, Qt::AlignRight | Qt::AlignTop, QString::number(m_densityBins.maxCount));
+    painter->drawText(labels, Qt::AlignHCenter | Qt::AlignTop, "n/bin");
+    painter->restore();
+}
+
 void ErrorBarChartView::setBoxPlotData(const QVector<BoxPlotStats> &stats, double yMin, double yMax)
 {
     m_boxStats = stats;
@@ -204,7 +498,10 @@ void ErrorBarChartView::paintErrorBars(QPainter *painter, const QPoint &viewport
             continue;
         }
 
-        for (const ErrorBarData &errorBar : errorBars) {
+        const int prefix = m_errorBarPrefix.value(series, -1);
+        const int shown = prefix < 0 ? errorBars.size() : qMin(prefix, int(errorBars.size()));
+        for (int bi = 0; bi < shown; ++bi) {
+            const ErrorBarData &errorBar = errorBars[bi];
             double xRatio = (errorBar.meanX - xMin) / (xMax - xMin);
             double yRatio = (errorBar.meanY - yMin) / (yMax - yMin);
 
@@ -244,6 +541,10 @@ void ErrorBarChartView::paintEvent(QPaintEvent *event)
 
     QPainter painter(this->viewport());
 
+    // Dense simulated lines are painted beneath the series by the raster item (see
+    // setRasterLines). Binned scatter density (see setDensityBins)
+    paintDensityLayer(&painter);
+
     // Draw axis border lines in the user-chosen color (Qt theme always draws them gray)
     paintAxisBorder(&painter);
 
@@ -9,6 +9,8 @@
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QScatterSeries>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 
 void PlotWidget::clearLegend()
 {
@@ -730,50 +732,159 @@ void PlotWidget::selectLegendRowForSeries(QAbstractSeries* series)
         createToggleHandler(row);
 }
 
+void PlotWidget::invalidateHoverIndex()
+{
+    m_hoverIndex.valid = false;
+}
+
+// Build the hover grid for the main chart. Each series' data→pixel mapping is affine,
+// so it is taken from two mapToPosition() calls instead of one per point. Line series
+// register each segment in every cell its bounding box touches; scatter series register
+// points. Anything outside the plot area (plus one cell) is left out.
+void PlotWidget::ensureHoverIndex() const
+{
+    if (m_hoverIndex.valid && m_chart && m_chart->series().size() == m_hoverIndex.seriesCount) return;
+
+    HoverIndex &idx = m_hoverIndex;
+    idx.tracks.clear();
+    idx.entries.clear();
+    idx.cellStart.clear();
+    idx.cols = idx.rows = 0;
+    idx.valid = true;
+    if (!m_chart) return;
+    idx.seriesCount = m_chart->series().size();
+
+    const double lineThreshold    = 20.0;  // lines are thin, needs generous hit area
+    const double scatterThreshold = 14.0;
+
+    QRectF plotArea = m_chart->plotArea();
+    if (plotArea.isEmpty()) return;
+    idx.cellSize = 24.0;  // >= every hit radius, so a 3x3 neighbourhood covers a query
+    idx.extent = plotArea.adjusted(-idx.cellSize, -idx.cellSize, idx.cellSize, idx.cellSize);
+    idx.cols = qMax(1, int(std::ceil(idx.extent.width()  / idx.cellSize)));
+    idx.rows = qMax(1, int(std::ceil(idx.extent.height() / idx.cellSize)));
+
+    for (QAbstractSeries* series : m_chart->series()) {
+        HoverIndex::Track track;
+        track.series = series;
+        auto pd = m_seriesToPlotData.value(series);
+        if (auto* ls = qobject_cast<QLineSeries*>(series)) {
+            track.isLine = true;
+            track.threshold = lineThreshold;
+            track.data = pd ? pd->points : ls->points();
+        } else if (auto* ss = qobject_cast<QScatterSeries*>(series)) {
+            track.threshold = scatterThreshold + ss->markerSize() / 2.0;
+            track.data = pd ? pd->points : ss->points();
+        } else {
+            continue;
+        }
+        if (track.data.isEmpty()) continue;
+
+        QPointF o  = m_chart->mapToPosition(QPointF(0.0, 0.0), series);
+        QPointF ux = m_chart->mapToPosition(QPointF(1.0, 0.0), series) - o;
+        QPointF uy = m_chart->mapToPosition(QPointF(0.0, 1.0), series) - o;
+        track.pixels.resize(track.data.size());
+        for (int i = 0; i < track.data.size(); ++i) {
+            const QPointF &d = track.data[i];
+            track.pixels[i] = o + d.x() * ux + d.y() * uy;
+        }
+        idx.tracks.append(track);
+    }
+
+    // Visit the cells an entry covers (point, or segment bounding box), clipped to the grid
+    auto forCells = [&](const QPointF &a, const QPointF &b, auto &&fn) {
+        int c0 = int(std::floor((qMin(a.x(), b.x()) - idx.extent.left()) / idx.cellSize));
+        int c1 = int(std::floor((qMax(a.x(), b.x()) - idx.extent.left()) / idx.cellSize));
+        int r0 = int(std::floor((qMin(a.y(), b.y()) - idx.extent.top())  / idx.cellSize));
+        int r1 = int(std::floor((qMax(a.y(), b.y()) - idx.extent.top())  / idx.cellSize));
+        if (c1 < 0 || r1 < 0 || c0 >= idx.cols || r0 >= idx.rows) return;
+        c0 = qMax(c0, 0); r0 = qMax(r0, 0);
+        c1 = qMin(c1, idx.cols - 1); r1 = qMin(r1, idx.rows - 1);
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c)
+                fn(r * idx.cols + c);
+    };
+    auto forEntries = [&](auto &&fn) {
+        for (int t = 0; t < idx.tracks.size(); ++t) {
+            const HoverIndex::Track &track = idx.tracks[t];
+            const QVector<QPointF> &px = track.pixels;
+            if (track.isLine && px.size() > 1) {
+                for (int i = 0; i + 1 < px.size(); ++i)
+                    forCells(px[i], px[i + 1], [&](int cell) { fn(cell, t, i); });
+            } else {
+                for (int i = 0; i < px.size(); ++i)
+                    forCells(px[i], px[i], [&](int cell) { fn(cell, t, i); });
+            }
+        }
+    };
+
+    // Two passes: count per cell, then fill (compressed sparse rows)
+    const int nCells = idx.cols * idx.rows;
+    idx.cellStart.fill(0, nCells + 1);
+    forEntries([&](int cell, int, int) { ++idx.cellStart[cell + 1]; });
+    for (int c = 0; c < nCells; ++c)
+        idx.cellStart[c + 1] += idx.cellStart[c];
+    idx.entries.resize(idx.cellStart[nCells]);
+    QVector<int> fill = idx.cellStart;
+    forEntries([&](int cell, int t, int i) { idx.entries[fill[cell]++] = { t, i }; });
+}
+
+namespace {
+
+double distanceToSegment(const QPointF &p, const QPointF &a, const QPointF &b)
+{
+    QPointF ab = b - a;
+    QPointF ap = p - a;
+    double lenSq = ab.x()*ab.x() + ab.y()*ab.y();
+    double t = (lenSq > 0) ? qBound(0.0, (ap.x()*ab.x() + ap.y()*ab.y()) / lenSq, 1.0) : 0.0;
+    return QLineF(p, a + t * ab).length();
+}
+
+} // namespace
+
 QAbstractSeries* PlotWidget::findSeriesNearPoint(const QPoint& viewPos) const
 {
     // viewPos is in QChartView viewport coordinates.
     // QGraphicsView::mapToScene() expects viewport coordinates directly — no
     // intermediate widget mapping needed.
-    // mapToPosition() returns coordinates in QChart's local item space, which is the
-    // same space as mapFromScene(), so the comparison is valid.
+    // The index holds mapToPosition() coordinates, i.e. QChart's local item space,
+    // which is the same space as mapFromScene(), so the comparison is valid.
     QPointF scenePos = m_chartView->mapToScene(viewPos);
     QPointF chartPos = m_chart->mapFromScene(scenePos);
 
-    const double lineThreshold    = 20.0;  // lines are thin, needs generous hit area
-    const double scatterThreshold = 14.0;
+    ensureHoverIndex();
+    const HoverIndex &idx = m_hoverIndex;
+    if (idx.cols == 0) return nullptr;
 
-    QAbstractSeries* nearest = nullptr;
-    double minDist = std::numeric_limits<double>::max();
+    // While an animation frame is partially drawn, ignore data past its cutoff
+    bool animPartial = !m_animXValues.isEmpty() && m_animFrame < m_animXValues.size() - 1;
+    double cutoff = animPartial ? m_animXValues[m_animFrame] : 0.0;
 
-    for (QAbstractSeries* series : m_chart->series()) {
-        if (!series->isVisible()) continue;
+    int c = int(std::floor((chartPos.x() - idx.extent.left()) / idx.cellSize));
+    int r = int(std::floor((chartPos.y() - idx.extent.top())  / idx.cellSize));
 
-        if (auto* ls = qobject_cast<QLineSeries*>(series)) {
-            const auto pts = ls->points();
-            for (int i = 0; i + 1 < pts.size(); ++i) {
-                QPointF a = m_chart->mapToPosition(pts[i],   series);
-                QPointF b = m_chart->mapToPosition(pts[i+1], series);
-                // Distance from chartPos to segment AB
-                QPointF ab = b - a;
-                QPointF ap = chartPos - a;
-                double lenSq = ab.x()*ab.x() + ab.y()*ab.y();
-                double t = (lenSq > 0) ? qBound(0.0, (ap.x()*ab.x() + ap.y()*ab.y()) / lenSq, 1.0) : 0.0;
-                QPointF proj = a + t * ab;
-                double dist = QLineF(chartPos, proj).length();
-                if (dist < lineThreshold && dist < minDist) {
-                    minDist = dist;
-                    nearest = series;
+    QAbstractSeries* nearest = nullptr;
+    double minDist = std::numeric_limits<double>::max();
+    for (int rr = qMax(0, r - 1); rr <= qMin(idx.rows - 1, r + 1); ++rr) {
+        for (int cc = qMax(0, c - 1); cc <= qMin(idx.cols - 1, c + 1); ++cc) {
+            const int cell = rr * idx.cols + cc;
+            for (int e = idx.cellStart[cell]; e < idx.cellStart[cell + 1]; ++e) {
+                const HoverIndex::Entry &entry = idx.entries[e];
+                const HoverIndex::Track &track = idx.tracks[entry.track];
+                if (!track.series || !track.series->isVisible()) continue;
+
+                double dist;
+                if (track.isLine && entry.index + 1 < track.pixels.size()) {
+                    if (animPartial && track.data[entry.index + 1].x() > cutoff) continue;
+                    dist = distanceToSegment(chartPos, track.pixels[entry.index],
+                                             track.pixels[entry.index + 1]);
+                } else {
+                    if (animPartial && track.data[entry.index].x() > cutoff) continue;
+                    dist = QLineF(chartPos, track.pixels[entry.index]).length();
                 }
-            }
-        } else if (auto* ss = qobject_cast<QScatterSeries*>(series)) {
-            double threshold = scatterThreshold + ss->markerSize() / 2.0;
-            for (const QPointF& pt : ss->points()) {
-                QPointF mapped = m_chart->mapToPosition(pt, series);
-                double dist = QLineF(chartPos, mapped).length();
-                if (dist < threshold && dist < minDist) {
+                if (dist < track.threshold && dist < minDist) {
                     minDist = dist;
-                    nearest = series;
+                    nearest = track.series;
                 }
             }
         }
@@ -790,31 +901,52 @@ QPointF PlotWidget::findNearestDataPoint(QAbstractSeries* series, const QPoint&
     QPointF scenePos = m_chartView->mapToScene(viewPos);
     QPointF chartPos = m_chart->mapFromScene(scenePos);
 
-    // Chart series points (may use virtual x in axis-break mode)
-    QVector<QPointF> chartPoints;
-    if (auto* ls = qobject_cast<QLineSeries*>(series))
-        chartPoints = ls->points();
-    else if (auto* ss = qobject_cast<QScatterSeries*>(series))
-        chartPoints = ss->points();
+    ensureHoverIndex();
+    const HoverIndex &idx = m_hoverIndex;
+    if (idx.cols == 0) return {};
 
-    if (chartPoints.isEmpty()) return {};
+    bool animPartial = !m_animXValues.isEmpty() && m_animFrame < m_animXValues.size() - 1;
+    double cutoff = animPartial ? m_animXValues[m_animFrame] : 0.0;
 
-    // Original data points from PlotData (real x values even in axis-break mode)
-    QVector<QPointF> originalPoints;
-    auto pd = m_seriesToPlotData.value(series);
-    if (pd) originalPoints = pd->points;
+    int c = int(std::floor((chartPos.x() - idx.extent.left()) / idx.cellSize));
+    int r = int(std::floor((chartPos.y() - idx.extent.top())  / idx.cellSize));
 
+    // Scan rings of cells outward from the cursor; once the best hit is closer than
+    // the next ring can possibly be, stop. Points of line tracks are found through the
+    // segments that start or end at them.
+    const HoverIndex::Track *bestTrack = nullptr;
+    int bestIdx = -1;
     double minDist = std::numeric_limits<double>::max();
-    int nearestIdx = 0;
-    for (int i = 0; i < chartPoints.size(); ++i) {
-        QPointF mapped = m_chart->mapToPosition(chartPoints[i], series);
-        double dist = QLineF(chartPos, mapped).length();
-        if (dist < minDist) { minDist = dist; nearestIdx = i; }
+    const int maxRing = qMax(idx.cols, idx.rows);
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        for (int rr = r - ring; rr <= r + ring; ++rr) {
+            if (rr < 0 || rr >= idx.rows) continue;
+            const bool edgeRow = (rr == r - ring || rr == r + ring);
+            for (int cc = c - ring; cc <= c + ring; cc += (edgeRow ? 1 : 2 * ring)) {
+                if (cc >= 0 && cc < idx.cols) {
+                    const int cell = rr * idx.cols + cc;
+                    for (int e = idx.cellStart[cell]; e < idx.cellStart[cell + 1]; ++e) {
+                        const HoverIndex::Entry &entry = idx.entries[e];
+                        const HoverIndex::Track &track = idx.tracks[entry.track];
+                        if (!track.series || track.series != series) continue;
+                        const int last = (track.isLine && entry.index + 1 < track.pixels.size())
+                                         ? entry.index + 1 : entry.index;
+                        for (int i = entry.index; i <= last; ++i) {
+                            if (animPartial && track.data[i].x() > cutoff) continue;
+                            double dist = QLineF(chartPos, track.pixels[i]).length();
+                            if (dist < minDist) { minDist = dist; bestTrack = &track; bestIdx = i; }
+                        }
+                    }
+                }
+                if (ring == 0) break;
+            }
+        }
+        if (bestTrack && minDist <= ring * idx.cellSize) break;
     }
 
-    if (nearestIdx < originalPoints.size())
-        return originalPoints[nearestIdx];
-    return chartPoints.value(nearestIdx);
+    if (!bestTrack) return {};
+    // Track data is PlotData::points (virtual x in axis-break mode, as before)
+    return bestTrack->data[bestIdx];
 }
 
 void PlotWidget::showHoverTooltip(QAbstractSeries* series, const QPointF& dataPoint, const QPoint& viewPos)
@@ -931,6 +1063,8 @@ void PlotWidget::resetAllHighlightedItems()
         QAbstractSeries* series = pd->series.data();
         if (QLineSeries* ls = qobject_cast<QLineSeries*>(series)) {
             ls->setPen(pd->pen);
+        } else if (QAreaSeries* as = qobject_cast<QAreaSeries*>(series)) {
+            as->setBrush(pd->brush);
         } else if (QScatterSeries* ss = qobject_cast<QScatterSeries*>(series)) {
             if (series->property("custom_shape").isValid()) {
                 ss->setPen(Qt::NoPen);
@@ -970,7 +1104,10 @@ void PlotWidget::highlightPlotItems(const QVector<QAbstractSeries*>& seriesToHig
     for (const auto &pd : m_plotDataList) {
         if (!pd || !pd->series) continue;
         QAbstractSeries* series = pd->series.data();
-        bool isHighlighted = highlightSet.contains(series);
+        // Ensemble bands and mean follow their median line
+        QObject* median = series->property("ensemble_median").value<QObject*>();
+        bool isHighlighted = highlightSet.contains(series)
+                          || (median && highlightSet.contains(static_cast<QAbstractSeries*>(median)));
         bool isCustomShape = series->property("custom_shape").isValid();
 
         if (QLineSeries* ls = qobject_cast<QLineSeries*>(series)) {
@@ -980,6 +1117,12 @@ void PlotWidget::highlightPlotItems(const QVector<QAbstractSeries*>& seriesToHig
             pen.setColor(c);
             pen.setWidth(isHighlighted ? 3 : 2);
             ls->setPen(pen);
+        } else if (QAreaSeries* as = qobject_cast<QAreaSeries*>(series)) {
+            QBrush brush = pd->brush;
+            QColor bc = brush.color();
+            if (!isHighlighted) bc.setAlphaF(bc.alphaF() * 0.3);
+            brush.setColor(bc);
+            as->setBrush(brush);
         } else if (QScatterSeries* ss = qobject_cast<QScatterSeries*>(series)) {
             if (!isCustomShape) {
                 QPen pen = pd->pen;
@@ -1,6 +1,7 @@
 #include "PlotWidget.h"
 #include "DataProcessor.h"
 #include "MetricsCalculator.h"
+#include "Parallel.h"
 #include <QTimer>
 #include <QtCharts/QValueAxis>
 #include <QtCharts/QScatterSeries>
@@ -18,6 +19,104 @@
 #include <algorithm>
 #include <limits>
 #include <numeric>
+#include <vector>
+
+namespace {
+
+// Rows/points above which conversion and binning are spread over worker threads
+constexpr int SCATTER_PARALLEL_MIN_POINTS = 100000;
+
+// Contiguous chunks for conversion and binning of n rows/points
+int chunkCount(int n)
+{
+    return Parallel::threadCount(n, SCATTER_PARALLEL_MIN_POINTS, 8);
+}
+
+// Evaluate.OUT column as doubles, NaN where the value is missing, non-numeric or
+// negative (negatives are missing in Evaluate.OUT, as in the R plots)
+std::vector<double> evaluateValues(const DataColumn &column, int rows)
+{
+    std::vector<double> values(rows, std::numeric_limits<double>::quiet_NaN());
+    const QVector<QVariant> &data = column.data;
+    const int n = std::min(rows, static_cast<int>(data.size()));
+    Parallel::forChunks(n, chunkCount(n), [&](int begin, int end, int) {
+        for (int i = begin; i < end; ++i) {
+            const QVariant &v = data[i];
+            if (DataProcessor::isMissingValue(v)) continue;
+            bool ok = false;
+            double d = v.toDouble(&ok);
+            if (ok && d >= 0) values[i] = d;
+        }
+    });
+    return values;
+}
+
+} // namespace
+
+// Hexagonal bins use two offset rectangular lattices (centre spacing binWidth along x,
+// binWidth·√3 along y, the second shifted by half a cell); each point goes to the nearer
+// of its two candidate centres. Counting runs per thread into private grids, then merges.
+ErrorBarChartView::DensityBins PlotWidget::binDensity(const QVector<QPointF> &points, double axMin,
+                                                      double axMax, int bins, bool hexagonal)
+{
+    ErrorBarChartView::DensityBins out;
+    out.hexagonal = hexagonal;
+    const double range = axMax - axMin;
+    if (points.isEmpty() || bins < 1 || !(range > 0)) return out;
+
+    const double sx = range / bins;
+    const double sy = hexagonal ? sx * std::sqrt(3.0) : sx;
+    out.binWidth = sx;
+    out.binHeight = sy;
+    const int nx = bins + 1;
+    const int ny = static_cast<int>(std::ceil(range / sy)) + 1;
+    const int perLattice = nx * ny;
+    const int nBins = hexagonal ? 2 * perLattice : perLattice;
+
+    auto clampX = [nx](double v) { return qBound(0, static_cast<int>(v), nx - 1); };
+    auto clampY = [ny](double v) { return qBound(0, static_cast<int>(v), ny - 1); };
+    auto binOf = [&](const QPointF &p) -> int {
+        const double ix = (p.x() - axMin) / sx;
+        const double iy = (p.y() - axMin) / sy;
+        if (!hexagonal)
+            return clampX(std::floor(ix)) * ny + clampY(std::floor(iy));
+        const double ix1 = std::round(ix), iy1 = std::round(iy);
+        const double ix2 = std::floor(ix), iy2 = std::floor(iy);
+        const double d1 = (ix - ix1) * (ix - ix1) + 3.0 * (iy - iy1) * (iy - iy1);
+        const double d2 = (ix - ix2 - 0.5) * (ix - ix2 - 0.5) + 3.0 * (iy - iy2 - 0.5) * (iy - iy2 - 0.5);
+        if (d1 < d2)
+            return clampX(ix1) * ny + clampY(iy1);
+        return perLattice + clampX(ix2) * ny + clampY(iy2);
+    };
+
+    const int n = points.size();
+    const QPointF *pts = points.constData();
+    std::vector<std::vector<int>> partial(chunkCount(n));
+    Parallel::forChunks(n, int(partial.size()), [&](int begin, int end, int t) {
+        std::vector<int> &counts = partial[t];
+        counts.assign(nBins, 0);
+        for (int i = begin; i < end; ++i)
+            if (std::isfinite(pts[i].x()) && std::isfinite(pts[i].y()))
+                ++counts[binOf(pts[i])];
+    });
+    std::vector<int> counts = std::move(partial[0]);
+    for (size_t t = 1; t < partial.size(); ++t)
+        for (int b = 0; b < nBins; ++b)
+            counts[b] += partial[t][b];
+
+    // Keep occupied bins only, with their centres in data units
+    for (int b = 0; b < nBins; ++b) {
+        if (counts[b] == 0) continue;
+        const bool second = b >= perLattice;
+        const int local = second ? b - perLattice : b;
+        const int i = local / ny, j = local % ny;
+        const double shift = (second || !hexagonal) ? 0.5 : 0.0;
+        out.centres.append(QPointF(axMin + (i + shift) * sx, axMin + (j + shift) * sy));
+        out.counts.append(counts[b]);
+        out.maxCount = qMax(out.maxCount, counts[b]);
+    }
+    return out;
+}
 
 void PlotWidget::resizeScatterPanels()
 {
@@ -70,6 +169,18 @@ void PlotWidget::resizeScatterPanels()
     m_scatterPanelContainer->setFixedSize(cW, cH);
 }
 
+QStringList PlotWidget::defaultScatterVariables(const DataTable &evaluateData, int maxCount)
+{
+    QStringList vars;
+    for (const QString &col : evaluateData.columnNames) {
+        if (vars.size() >= maxCount) break;
+        if (col.length() < 2 || !col.endsWith('S')) continue;
+        const QString base = col.left(col.length() - 1);
+        if (evaluateData.columnNames.contains(base + 'M') && !vars.contains(base))
+            vars.append(base);
+    }
+    return vars;
+}
 
 void PlotWidget::plotScatter(
     const DataTable &evaluateData,
@@ -77,6 +188,7 @@ void PlotWidget::plotScatter(
 {
     m_isScatterMode = true;
     m_simData = evaluateData;      // store so settings changes can trigger replot
+    syncDataVersion();
     m_currentYVars = varNames;     // store so replot from settings dialog works
     m_scatterExportData.clear();
     setXAxisButtonsVisible(false);
@@ -88,8 +200,8 @@ void PlotWidget::plotScatter(
         return;
     }
     if (varNames.size() > 9)
-        emit errorOccurred(QString("Showing first 9 of %1 selected variables (maximum is 9).")
-                           .arg(varNames.size()));
+        emit warningOccurred(QString("Showing first 9 of %1 selected variables (maximum is 9).")
+                             .arg(varNames.size()));
 
     if (evaluateData.rowCount == 0) {
         qWarning() << "PlotWidget::plotScatter() - No data";
@@ -273,16 +385,14 @@ void PlotWidget::plotScatter(
         // Collect points per experiment
         // key = experiment label; value = list of (sim, meas) points
         // X = simulated, Y = measured  (matching R plot)
+        // Both columns are converted to doubles up front (in parallel for large tables)
+        const std::vector<double> simValues  = evaluateValues(*simCol,  evaluateData.rowCount);
+        const std::vector<double> measValues = evaluateValues(*measCol, evaluateData.rowCount);
         QMap<QString, QVector<QPointF>> expPoints;
         for (int i = 0; i < evaluateData.rowCount; ++i) {
-            QVariant sv = simCol->data.value(i);
-            QVariant mv = measCol->data.value(i);
-            if (DataProcessor::isMissingValue(sv) || DataProcessor::isMissingValue(mv)) continue;
-            bool okS, okM;
-            double s = DataProcessor::toDouble(sv, &okS);
-            double m = DataProcessor::toDouble(mv, &okM);
-            if (!okS || !okM) continue;
-            if (s < 0 || m < 0) continue; // treat negatives as missing (like R code)
+            const double s = simValues[i];
+            const double m = measValues[i];
+            if (std::isnan(s) || std::isnan(m)) continue;
             expPoints[rowExp[i]].append(QPointF(s, m));
         }
         if (expPoints.isEmpty()) continue;
@@ -318,7 +428,8 @@ void PlotWidget::plotScatter(
         QVector<double> simVals, measVals;
         for (const auto &pts : expPoints)
             for (const QPointF &p : pts) { simVals.append(p.x()); measVals.append(p.y()); }
-        QVariantMap fullMetrics = MetricsCalculator::calculateMetrics(simVals, measVals, 1);
+        QVariantMap fullMetrics = MetricsCalculator::calculateMetrics(simVals, measVals, 1,
+                                                                      m_plotSettings.bootstrapResamples);
         double rmse = fullMetrics.value("RMSE", 0.0).toDouble();
         double r2   = MetricsCalculator::rSquared(simVals, measVals);
 
@@ -339,8 +450,22 @@ void PlotWidget::plotScatter(
         refLine->append(axMax, axMax);
         chart->addSeries(refLine);
 
+        // Above the density threshold the pairs are binned into one colour-mapped layer
+        // instead of one marker each; metrics and the 1:1 line are unchanged
+        const bool densityMode = m_plotSettings.scatterDensityThreshold > 0
+                              && totalPts > m_plotSettings.scatterDensityThreshold;
+        ErrorBarChartView::DensityBins densityBins;
+        if (densityMode) {
+            QVector<QPointF> pooled;
+            pooled.reserve(totalPts);
+            for (const auto &pts : expPoints) pooled += pts;
+            densityBins = binDensity(pooled, axMin, axMax, m_plotSettings.scatterDensityBins,
+                                     m_plotSettings.scatterDensityShape != "square");
+        }
+
         // One scatter series per experiment
         for (const QString &expLabel : expOrder) {
+            if (densityMode) break;
             if (!expPoints.contains(expLabel)) continue;
             QScatterSeries *ss = new QScatterSeries();
             ss->setName(expLabel);
@@ -438,7 +563,15 @@ void PlotWidget::plotScatter(
 
         panelLayout->addWidget(titleStack);
 
-        QChartView *cv = new QChartView(chart);
+        QChartView *cv = nullptr;
+        if (densityMode) {
+            auto *densityView = new ErrorBarChartView(chart);
+            densityView->setAxisLineColor(m_plotSettings.axisLineColor);
+            densityView->setDensityBins(densityBins, refLine);
+            cv = densityView;
+        } else {
+            cv = new QChartView(chart);
+        }
         cv->setRenderHint(QPainter::Antialiasing);
         cv->setFrameShape(QFrame::NoFrame);  // remove border gap between strip and chart
         cv->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
@@ -539,6 +672,12 @@ void PlotWidget::plotScatter(
         double mseUraw  = fullMetrics.value("MSEu", 0.0).toDouble();
         mmap["MSEs"] = (mseTotal > 0) ? mseSraw / mseTotal : QVariant(0.0);
         mmap["MSEu"] = (mseTotal > 0) ? mseUraw / mseTotal : QVariant(0.0);
+        // Bootstrap CIs computed by calculateMetrics over the same pooled pairs
+        const QStringList ciKeys = {"RMSE_CI_Low", "RMSE_CI_High", "DStat_CI_Low", "DStat_CI_High",
+                                    "R2_CI_Low", "R2_CI_High", "CI_Level", "CI_Resamples"};
+        for (const QString &ciKey : ciKeys) {
+            if (fullMetrics.contains(ciKey)) mmap[ciKey] = fullMetrics.value(ciKey);
+        }
         // Crop from CR column (first non-empty value for this variable's rows)
         QString cropCode;
         if (crCol) {
@@ -557,7 +696,9 @@ void PlotWidget::plotScatter(
 
     // --- Build legend in right panel (hide if only one experiment — redundant) ---
     clearLegend();
-    bool showScatterLegend = (expOrder.size() > 1);
+    // Density panels draw no per-experiment markers, so the legend only applies when
+    // at least one panel still does
+    bool showScatterLegend = (expOrder.size() > 1) && !expSeriesMap.isEmpty();
     if (m_legendPanel) m_legendPanel->setVisible(showScatterLegend);
     if (m_legendStack) {
         m_legendStack->setCurrentIndex(1);
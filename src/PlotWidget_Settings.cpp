@@ -116,8 +116,8 @@ void PlotWidget::onSettingsButtonClicked()
                                 (m_plotSettings.xAxisTickSpacing != newSettings.xAxisTickSpacing);
         bool boxReplot        = (m_plotSettings.yAxisTickSpacing    != newSettings.yAxisTickSpacing) ||
                                 (m_plotSettings.yAxisDecimals      != newSettings.yAxisDecimals);
-        bool layoutChanged    = (m_plotSettings.multiPanelTimeSeries != newSettings.multiPanelTimeSeries) ||
-                                (m_plotSettings.plotMeanReps        != newSettings.plotMeanReps);
+        // Everything else is presentation-only: applyPlotSettings restyles the live chart
+        bool dataChanged      = settingsAffectData(m_plotSettings, newSettings, m_isScatterMode);
 
         applyPlotSettings(newSettings);
         m_plotSettings = newSettings;
@@ -140,7 +140,9 @@ void PlotWidget::onSettingsButtonClicked()
         }
 
         if (m_isScatterMode && m_simData.rowCount > 0 && !m_currentYVars.isEmpty()) {
-            // Always replot scatter — metrics selection, appearance, etc. all require rebuild
+            // Metrics selection, density binning and filters rebuild the panels;
+            // appearance was applied to them above
+            if (!dataChanged) return;
             DataTable dataCopy = m_simData;
             plotScatter(dataCopy, m_currentYVars);
         } else if (m_isBoxPlotMode && m_simData.rowCount > 0) {
@@ -150,7 +152,7 @@ void PlotWidget::onSettingsButtonClicked()
         } else if (!m_isScatterMode && m_simData.rowCount > 0) {
             bool hasCustomRange = newSettings.useCustomXMin || newSettings.useCustomXMax
                                   || newSettings.useCustomYMin || newSettings.useCustomYMax;
-            if (filterChanged || layoutChanged) {
+            if (dataChanged) {
                 updatePlotWithScaling();
                 if (m_obsData.rowCount > 0)
                     calculateMetrics();
@@ -165,6 +167,29 @@ void PlotWidget::onSettingsButtonClicked()
     }
 }
 
+// Settings that change which points are plotted, how they are grouped or aggregated,
+// or how panels are laid out. Any other difference (colours, widths, sizes, fonts,
+// grid, titles, legend) is presentation and only needs applyPlotSettings. Axis ranges
+// and tick spacing are handled separately by the caller.
+bool PlotWidget::settingsAffectData(const PlotSettings &a, const PlotSettings &b, bool scatterMode)
+{
+    if (a.excludedSeriesKeys != b.excludedSeriesKeys) return true;
+    if (scatterMode)
+        return a.scatterMetrics          != b.scatterMetrics ||
+               a.scatterDensityThreshold != b.scatterDensityThreshold ||
+               a.scatterDensityShape     != b.scatterDensityShape ||
+               a.scatterDensityBins      != b.scatterDensityBins ||
+               a.bootstrapResamples      != b.bootstrapResamples;
+    return a.showErrorBars        != b.showErrorBars ||
+           a.errorBarType         != b.errorBarType ||
+           a.plotMeanReps         != b.plotMeanReps ||
+           a.multiPanelTimeSeries != b.multiPanelTimeSeries ||
+           a.rasterSeriesBudget   != b.rasterSeriesBudget ||
+           a.rasterPointBudgetK   != b.rasterPointBudgetK ||
+           a.ensembleRunThreshold != b.ensembleRunThreshold ||
+           a.bootstrapResamples   != b.bootstrapResamples;
+}
+
 void PlotWidget::applyPlotSettings(const PlotSettings &settings, bool skipAxisRange)
 {
     // Show/hide the Snapshot button per the Plot Settings toggle. If it's being
@@ -324,10 +349,24 @@ void PlotWidget::applyPlotSettings(const PlotSettings &settings, bool skipAxisRa
         }
     }
 
-    // Update line and marker settings for existing series
+    // Update line and marker settings for existing series, on the main chart and the
+    // time-series panels. The dotted ensemble mean keeps its own width.
+    QHash<QAbstractSeries*, PlotData*> seriesData;
+    for (const auto &pd : m_plotDataList) {
+        if (!pd) continue;
+        if (pd->series) seriesData.insert(pd->series.data(), pd.data());
+        // PlotData pens are the highlight/reset baseline
+        if (!pd->isObserved && pd->lowerPoints.isEmpty() && pd->ensembleRole != "Mean"
+            && pd->pen.style() != Qt::NoPen)
+            pd->pen.setWidth(settings.lineWidth);
+    }
     auto seriesList = m_chart->series();
+    for (ErrorBarChartView *v : m_tsPanelViews)
+        if (v && v->chart()) seriesList += v->chart()->series();
     for (auto series : seriesList) {
         if (auto lineSeries = qobject_cast<QLineSeries*>(series)) {
+            PlotData *pd = seriesData.value(series);
+            if (pd && pd->ensembleRole == "Mean") continue;
             QPen pen = lineSeries->pen();
             pen.setWidth(settings.lineWidth);
             lineSeries->setPen(pen);
@@ -396,6 +435,8 @@ void PlotWidget::applyPlotSettings(const PlotSettings &settings, bool skipAxisRa
             QChart *ch = cv->chart();
             ch->setBackgroundBrush(QBrush(settings.backgroundColor));
             ch->setPlotAreaBackgroundBrush(QBrush(settings.plotAreaColor));
+            if (auto *densityView = qobject_cast<ErrorBarChartView*>(cv))
+                densityView->setAxisLineColor(settings.axisLineColor);
 
             for (QAbstractAxis *axis : ch->axes()) {
                 axis->setLabelsFont(axFont);
@@ -453,6 +494,37 @@ void PlotWidget::applyPlotSettings(const PlotSettings &settings, bool skipAxisRa
         }
     }
 
+    // Time-series panels: restyle charts and axes in place (ranges and ticks are the
+    // panels' own)
+    if (!m_isScatterMode && !m_isBoxPlotMode) {
+        QFont tickFont(settings.fontFamily, settings.axisTickFontSize);
+        QFont titleFont(settings.fontFamily, settings.axisLabelFontSize);
+        titleFont.setBold(settings.boldAxisLabels);
+        for (ErrorBarChartView *cv : m_tsPanelViews) {
+            if (!cv || !cv->chart()) continue;
+            QChart *ch = cv->chart();
+            ch->setBackgroundBrush(QBrush(settings.backgroundColor));
+            ch->setPlotAreaBackgroundBrush(QBrush(settings.plotAreaColor));
+            cv->setAxisLineColor(settings.axisLineColor);
+            cv->setErrorBarCapWidth(settings.errorBarCapWidth);
+            cv->setErrorBarLineWidth(settings.errorBarLineWidth);
+            for (QAbstractAxis *axis : ch->axes()) {
+                axis->setLabelsFont(tickFont);
+                axis->setTitleFont(titleFont);
+                axis->setGridLineVisible(settings.showGrid);
+                axis->setLinePen(QPen(settings.axisLineColor));
+                // Break-mode x axes keep their labels hidden (painted by the view)
+                auto *va = qobject_cast<QValueAxis*>(axis);
+                bool breakAxis = va && axis->orientation() == Qt::Horizontal
+                                 && m_currentXVar == "DATE" && !m_axisBreaks.isEmpty();
+                if (!breakAxis) {
+                    axis->setLabelsVisible(settings.showAxisLabels);
+                    axis->setMinorGridLineVisible(settings.showMinorGrid);
+                }
+            }
+        }
+    }
+
     // Box plot live-update: category label font and painter Y bounds
     if (m_isBoxPlotMode && m_chartView && !m_chartView->boxPlotStats().isEmpty()) {
         QFont tickFont(settings.fontFamily, settings.axisTickFontSize);
@@ -522,7 +594,14 @@ void PlotWidget::saveSettings() const
     // Interaction & Layout
     s.setValue("showHoverTooltip", m_plotSettings.showHoverTooltip);
     s.setValue("multiPanelTimeSeries", m_plotSettings.multiPanelTimeSeries);
+    s.setValue("rasterSeriesBudget", m_plotSettings.rasterSeriesBudget);
+    s.setValue("rasterPointBudgetK", m_plotSettings.rasterPointBudgetK);
+    s.setValue("ensembleRunThreshold", m_plotSettings.ensembleRunThreshold);
+    s.setValue("scatterDensityThreshold", m_plotSettings.scatterDensityThreshold);
+    s.setValue("scatterDensityShape", m_plotSettings.scatterDensityShape);
+    s.setValue("scatterDensityBins", m_plotSettings.scatterDensityBins);
     s.setValue("rememberLastCropFolder", m_plotSettings.rememberLastCropFolder);
+    s.setValue("memoryBudgetMB", m_plotSettings.memoryBudgetMB);
 
     // Legend
     s.setValue("showLegend",      m_plotSettings.showLegend);
@@ -585,6 +664,7 @@ void PlotWidget::saveSettings() const
     // Metrics overlays
     s.setValue("scatterMetrics", QStringList(m_plotSettings.scatterMetrics.begin(), m_plotSettings.scatterMetrics.end()));
     s.setValue("tsMetrics",      QStringList(m_plotSettings.tsMetrics.begin(),      m_plotSettings.tsMetrics.end()));
+    s.setValue("bootstrapResamples", m_plotSettings.bootstrapResamples);
 
     s.endGroup();
 }
@@ -602,7 +682,14 @@ void PlotWidget::loadSettings()
 
     m_plotSettings.showHoverTooltip = s.value("showHoverTooltip", m_plotSettings.showHoverTooltip).toBool();
     m_plotSettings.multiPanelTimeSeries = s.value("multiPanelTimeSeries", m_plotSettings.multiPanelTimeSeries).toBool();
+    m_plotSettings.rasterSeriesBudget = s.value("rasterSeriesBudget", m_plotSettings.rasterSeriesBudget).toInt();
+    m_plotSettings.rasterPointBudgetK = s.value("rasterPointBudgetK", m_plotSettings.rasterPointBudgetK).toInt();
+    m_plotSettings.ensembleRunThreshold = s.value("ensembleRunThreshold", m_plotSettings.ensembleRunThreshold).toInt();
+    m_plotSettings.scatterDensityThreshold = s.value("scatterDensityThreshold", m_plotSettings.scatterDensityThreshold).toInt();
+    m_plotSettings.scatterDensityShape = s.value("scatterDensityShape", m_plotSettings.scatterDensityShape).toString();
+    m_plotSettings.scatterDensityBins = s.value("scatterDensityBins", m_plotSettings.scatterDensityBins).toInt();
     m_plotSettings.rememberLastCropFolder = s.value("rememberLastCropFolder", m_plotSettings.rememberLastCropFolder).toBool();
+    m_plotSettings.memoryBudgetMB = s.value("memoryBudgetMB", m_plotSettings.memoryBudgetMB).toInt();
 
     m_plotSettings.showLegend     = s.value("showLegend",     m_plotSettings.showLegend).toBool();
     m_plotSettings.legendPosition = s.value("legendPosition", m_plotSettings.legendPosition).toString();
@@ -664,6 +751,7 @@ void PlotWidget::loadSettings()
     QStringList savedTsMetrics = s.value("tsMetrics", QStringList()).toStringList();
     if (!savedTsMetrics.isEmpty())
         m_plotSettings.tsMetrics = QSet<QString>(savedTsMetrics.begin(), savedTsMetrics.end());
+    m_plotSettings.bootstrapResamples = s.value("bootstrapResamples", m_plotSettings.bootstrapResamples).toInt();
 
     s.endGroup();
 
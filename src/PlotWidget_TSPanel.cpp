@@ -583,11 +583,18 @@ void PlotWidget::plotTimeSeriesMultiPanel()
                 panelSeriesMap[ss] = pd;
                 if (!pd->errorBars.isEmpty())
                     panelErrorBars[ss] = pd->errorBars;
+            } else if (!pd->lowerPoints.isEmpty()) {
+                QAbstractSeries *band = createEnsembleBandSeries(pd);
+                chart->addSeries(band);
+                pd->series = band;
+                panelSeriesMap[band] = pd;
             } else {
                 QLineSeries *ls = new QLineSeries();
                 // Force solid line — style variation is only needed in overlay mode
+                // (the dotted ensemble mean keeps its style)
                 QPen solidPen(pd->pen);
-                solidPen.setStyle(Qt::SolidLine);
+                if (pd->ensembleRole != "Mean")
+                    solidPen.setStyle(Qt::SolidLine);
                 ls->setPen(solidPen);
                 for (const QPointF &pt : pd->points) ls->append(pt);
                 chart->addSeries(ls);
@@ -597,11 +604,13 @@ void PlotWidget::plotTimeSeriesMultiPanel()
                 panelSeriesMap[ls] = pd;
             }
         }
+        linkEnsembleSeries(varData);
 
         // Inject snapshot series for this variable (attached to axes in the batch loop below)
         if (m_snapshotActive) {
             for (const auto &snapPD : m_snapshotDataList) {
-                if (snapPD->variable != varCode || snapPD->points.isEmpty()) continue;
+                if (snapPD->variable != varCode || snapPD->points.isEmpty()
+                    || !snapPD->lowerPoints.isEmpty()) continue;
                 QColor c = snapPD->color;
                 c.setAlphaF(0.5);
                 if (snapPD->isObserved) {
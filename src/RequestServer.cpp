@@ -0,0 +1,422 @@
+#include "RequestServer.h"
+#include "PlotWidget.h"
+#include "PlotRenderer.h"
+#include "MetricsCalculator.h"
+#include "Config.h"
+#include "Trace.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QBuffer>
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QImageWriter>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QTextStream>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace {
+
+// Lists may be JSON arrays or comma-separated strings, as in a --batch manifest
+QStringList stringList(const QJsonValue &value)
+{
+    QStringList out;
+    if (value.isArray()) {
+        for (const QJsonValue &item : value.toArray()) {
+            const QString s = item.isString() ? item.toString() : QString::number(item.toDouble());
+            if (!s.trimmed().isEmpty()) out.append(s.trimmed());
+        }
+    } else if (value.isString()) {
+        for (const QString &s : value.toString().split(',', Qt::SkipEmptyParts))
+            out.append(s.trimmed());
+    }
+    return out;
+}
+
+QString csvField(const QString &value)
+{
+    if (!value.contains(',') && !value.contains('"') && !value.contains('\n'))
+        return value;
+    QString quoted = value;
+    quoted.replace('"', "\"\"");
+    return '"' + quoted + '"';
+}
+
+// A column is sent as float64 when every non-missing cell is numeric
+bool isNumericColumn(const DataColumn &column)
+{
+    for (const QVariant &value : column.data) {
+        if (DataProcessor::isMissingValue(value)) continue;
+        bool ok = false;
+        DataProcessor::toDouble(value, &ok);
+        if (!ok) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+RequestServer::Response RequestServer::errorResponse(const QString &message)
+{
+    Response response;
+    response.header["ok"] = false;
+    response.header["error"] = message;
+    return response;
+}
+
+RequestServer::RequestServer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+RequestServer::~RequestServer()
+{
+    delete m_plot;
+}
+
+bool RequestServer::listen(const QString &name)
+{
+    m_server = new QLocalServer(this);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    // A stale socket file from a crashed server would make listen() fail. Remove it only
+    // when nothing answers on it, so a second --serve cannot take over a live server.
+    QLocalSocket probe;
+    probe.connectToServer(name);
+    if (probe.waitForConnected(PROBE_TIMEOUT_MS)) {
+        probe.disconnectFromServer();
+        m_error = QString("another server is already listening on %1").arg(name);
+        return false;
+    }
+    QLocalServer::removeServer(name);
+    if (!m_server->listen(name)) {
+        m_error = m_server->errorString();
+        return false;
+    }
+    connect(m_server, &QLocalServer::newConnection, this, &RequestServer::onNewConnection);
+
+    // Resolve the shared DSSAT lookups once; every request reuses them
+    DataProcessor::getDSSATBase();
+    DataProcessor::getVariableInfo(QString());
+    DataProcessor::getCropDetails();
+
+    fprintf(stderr, "%s: serving on %s\n", qPrintable(Config::APP_NAME),
+            qPrintable(m_server->fullServerName()));
+    return true;
+}
+
+void RequestServer::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::readyRead, this, &RequestServer::onReadyRead);
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+    }
+}
+
+void RequestServer::onReadyRead()
+{
+    auto *socket = qobject_cast<QLocalSocket *>(sender());
+    if (!socket) return;
+
+    // Requests on one connection are answered in order
+    while (socket->canReadLine()) {
+        const QByteArray line = socket->readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        QJsonParseError parseError;
+        const QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+        if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+            send(socket, errorResponse(QString("bad request: %1").arg(parseError.errorString())));
+            continue;
+        }
+        QElapsedTimer timer;
+        timer.start();
+        Response response = handle(doc.object());
+        response.header["ms"] = static_cast<double>(timer.elapsed());
+        send(socket, std::move(response));
+    }
+}
+
+void RequestServer::send(QLocalSocket *socket, Response response)
+{
+    if (!response.header.contains("ok")) response.header["ok"] = true;
+    response.header["size"] = static_cast<double>(response.payload.size());
+    socket->write(QJsonDocument(response.header).toJson(QJsonDocument::Compact));
+    socket->write("\n", 1);
+    if (!response.payload.isEmpty())
+        socket->write(response.payload);
+    socket->flush();
+}
+
+RequestServer::Response RequestServer::handle(const QJsonObject &request)
+{
+    const QString cmd = request.value("cmd").toString();
+    GB2_TRACE_SCOPE_ARG("request", cmd);
+
+    if (cmd == "ping") {
+        Response response;
+        response.header["version"] = Config::APP_VERSION;
+        response.header["cachedSets"] = m_cache.size();
+        return response;
+    }
+    if (cmd == "evict") {
+        Response response;
+        response.header["evicted"] = m_cache.size();
+        m_cache.clear();
+        return response;
+    }
+    if (cmd != "load" && cmd != "table" && cmd != "metrics" && cmd != "plot")
+        return errorResponse(QString("unknown cmd '%1'").arg(cmd));
+
+    bool cached = false;
+    QString error;
+    const QSharedPointer<FileSet> set = fileSetFor(request, &cached, &error);
+    if (!set) return errorResponse(error);
+
+    Response response;
+    if (cmd == "load") {
+        auto shape = [](const DataTable &table) {
+            QJsonObject o;
+            o["rows"] = table.rowCount;
+            o["columns"] = QJsonArray::fromStringList(table.columnNames);
+            return o;
+        };
+        response.header["sim"] = shape(set->data.simData);
+        response.header["obs"] = shape(set->data.obsData);
+        response.header["evaluate"] = shape(set->data.evaluateData);
+        response.header["experiments"] = QJsonArray::fromStringList(set->data.experimentCodes.values());
+        response.header["loadMs"] = static_cast<double>(set->loadMs);
+    } else if (cmd == "table") {
+        response = tableResponse(*set, request);
+    } else if (cmd == "metrics") {
+        response = metricsResponse(*set, request);
+    } else {
+        response = plotResponse(*set, request);
+    }
+    response.header["cached"] = cached;
+    return response;
+}
+
+// Returns the parsed set for the request's cropDir + files, re-parsing only when a
+// file changed on disk since it was cached
+QSharedPointer<RequestServer::FileSet> RequestServer::fileSetFor(const QJsonObject &request,
+                                                                 bool *cached, QString *error)
+{
+    const QString cropDir = request.value("cropDir").toString();
+    const QStringList names = stringList(request.value("files"));
+    if (cropDir.isEmpty() || names.isEmpty()) {
+        *error = "cropDir and files are required";
+        return {};
+    }
+
+    DataProcessor processor;
+    QString folderPath = cropDir;
+    if (!QDir(folderPath).exists())
+        folderPath = processor.getActualFolderPath(cropDir);
+    if (folderPath.isEmpty() || !QDir(folderPath).exists()) {
+        *error = QString("crop folder not found: %1").arg(cropDir);
+        return {};
+    }
+    const QDir folder(folderPath);
+
+    auto set = QSharedPointer<FileSet>::create();
+    set->folderName = folder.dirName();
+    QStringList keyParts;
+    for (const QString &name : names) {
+        const QString path = QDir::cleanPath(folder.absoluteFilePath(name));
+        const QFileInfo info(path);
+        set->files.append(qMakePair(info.fileName(), path));
+        set->stamps.append(qMakePair(info.size(), info.lastModified()));
+        keyParts.append(path.toLower());
+    }
+    keyParts.sort();
+    set->key = folder.absolutePath().toLower() + '|' + keyParts.join('|');
+
+    for (int i = 0; i < m_cache.size(); ++i) {
+        if (m_cache[i]->key != set->key) continue;
+        if (m_cache[i]->stamps == set->stamps) {
+            *cached = true;
+            if (i > 0) m_cache.move(i, 0);
+            return m_cache.first();
+        }
+        m_cache.removeAt(i);   // stale
+        break;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    processor.loadOutputFiles(set->folderName, set->files, set->data);
+    set->loadMs = timer.elapsed();
+    if (set->data.loadedPaths.isEmpty()) {
+        *error = "no file could be read";
+        return {};
+    }
+
+    m_cache.prepend(set);
+    while (m_cache.size() > MAX_CACHED_SETS)
+        m_cache.removeLast();
+    *cached = false;
+    return set;
+}
+
+RequestServer::Response RequestServer::tableResponse(const FileSet &set, const QJsonObject &request)
+{
+    const QString which = request.value("table").toString("sim");
+    const DataTable *table = which == "obs" ? &set.data.obsData
+                           : which == "evaluate" ? &set.data.evaluateData
+                           : which == "sim" ? &set.data.simData : nullptr;
+    if (!table) return errorResponse(QString("unknown table '%1'").arg(which));
+
+    QStringList columns = stringList(request.value("columns"));
+    if (columns.isEmpty()) columns = table->columnNames;
+    QVector<const DataColumn *> selected;
+    for (const QString &name : columns) {
+        const DataColumn *column = table->getColumn(name);
+        if (!column) return errorResponse(QString("no column '%1' in %2").arg(name, which));
+        selected.append(column);
+    }
+
+    Response response;
+    response.header["rows"] = table->rowCount;
+    const QString format = request.value("format").toString("csv");
+    if (format == "columnar") {
+        QJsonArray layout;
+        QDataStream out(&response.payload, QIODevice::WriteOnly);
+        out.setByteOrder(QDataStream::LittleEndian);
+        out.setFloatingPointPrecision(QDataStream::DoublePrecision);
+        for (const DataColumn *column : selected) {
+            const bool numeric = isNumericColumn(*column);
+            QJsonObject entry;
+            entry["name"] = column->name;
+            entry["type"] = numeric ? "f64" : "utf8";
+            layout.append(entry);
+            for (int row = 0; row < table->rowCount; ++row) {
+                const QVariant value = row < column->data.size() ? column->data[row] : QVariant();
+                if (numeric) {
+                    out << (DataProcessor::isMissingValue(value)
+                            ? std::numeric_limits<double>::quiet_NaN()
+                            : DataProcessor::toDouble(value));
+                } else {
+                    const QByteArray text = value.toString().toUtf8();
+                    out << static_cast<quint32>(text.size());
+                    out.writeRawData(text.constData(), text.size());
+                }
+            }
+        }
+        response.header["contentType"] = "application/x-gb2-columnar";
+        response.header["columns"] = layout;
+    } else if (format == "csv") {
+        QTextStream out(&response.payload, QIODevice::WriteOnly);
+        out.setEncoding(QStringConverter::Utf8);
+        QStringList header;
+        for (const DataColumn *column : selected) header.append(csvField(column->name));
+        out << header.join(',') << '\n';
+        for (int row = 0; row < table->rowCount; ++row) {
+            for (int c = 0; c < selected.size(); ++c) {
+                const DataColumn *column = selected[c];
+                if (c > 0) out << ',';
+                if (row < column->data.size() && !DataProcessor::isMissingValue(column->data[row]))
+                    out << csvField(column->data[row].toString());
+            }
+            out << '\n';
+        }
+        out.flush();
+        response.header["contentType"] = "text/csv";
+    } else {
+        return errorResponse(QString("unknown format '%1'").arg(format));
+    }
+    return response;
+}
+
+RequestServer::Response RequestServer::metricsResponse(const FileSet &set, const QJsonObject &request)
+{
+    if (set.data.obsData.rowCount == 0)
+        return errorResponse("no observed data for this file set");
+
+    QStringList variables = stringList(request.value("vars"));
+    if (variables.isEmpty())
+        variables = MetricsCalculator::commonVariables(set.data.simData, set.data.obsData);
+    const QStringList trtList = stringList(request.value("treatments"));
+    const QSet<QString> treatments(trtList.begin(), trtList.end());
+
+    const QVector<QVariantMap> metrics = MetricsCalculator::obsSimMetrics(
+        set.data.simData, set.data.obsData, set.data.treatmentNames, variables, treatments);
+
+    Response response;
+    response.header["rows"] = metrics.size();
+    const QString format = request.value("format").toString("json");
+    if (format == "csv") {
+        QVariantList rows;
+        rows.reserve(metrics.size());
+        for (const QVariantMap &row : metrics) rows.append(row);
+        QTextStream out(&response.payload, QIODevice::WriteOnly);
+        MetricsCalculator::writeMetricsCsv(out, rows);
+        out.flush();
+        response.header["contentType"] = "text/csv";
+    } else if (format == "json") {
+        QJsonArray rows;
+        for (const QVariantMap &row : metrics) rows.append(QJsonObject::fromVariantMap(row));
+        response.payload = QJsonDocument(rows).toJson(QJsonDocument::Compact);
+        response.header["contentType"] = "application/json";
+    } else {
+        return errorResponse(QString("unknown format '%1'").arg(format));
+    }
+    return response;
+}
+
+RequestServer::Response RequestServer::plotResponse(const FileSet &set, const QJsonObject &request)
+{
+    const QStringList yVars = stringList(request.value("yvars"));
+    if (yVars.isEmpty()) return errorResponse("yvars is required");
+    if (set.data.simData.rowCount == 0) return errorResponse("no simulated data");
+
+    const QString format = request.value("format").toString("png").toUpper();
+    if (!QImageWriter::supportedImageFormats().contains(format.toLower().toLatin1()))
+        return errorResponse(QString("unsupported image format '%1'").arg(format));
+
+    if (!m_plot) m_plot = new PlotWidget();   // never shown
+    bool plotted = false;
+    QMetaObject::Connection updated = connect(m_plot, &PlotWidget::plotUpdated, m_plot,
+        [&plotted]() { plotted = true; });
+
+    QStringList fileNames;
+    for (const auto &file : set.files) fileNames.append(file.first);
+    const QString experiment = set.data.experimentCodes.isEmpty()
+                               ? QString() : set.data.experimentCodes.values().first();
+    m_plot->setBoxPlotMode(false);
+    m_plot->plotTimeSeries(set.data.simData, set.folderName, fileNames, experiment,
+                           stringList(request.value("treatments")),
+                           request.value("xvar").toString("DATE"), yVars, set.data.obsData,
+                           set.data.treatmentNames);
+    disconnect(updated);
+
+    if (!plotted) return errorResponse("no plot produced");
+    if (!m_plot->canRenderOffscreen())
+        return errorResponse("this plot cannot be rendered offscreen");
+
+    // Clamp the requested size, then lower the dpi until the supersampled image fits
+    // MAX_IMAGE_PIXELS, so one request cannot make the server allocate gigabytes
+    const QSize size(qBound(MIN_IMAGE_SIDE, request.value("width").toInt(1200), MAX_IMAGE_SIDE),
+                     qBound(MIN_IMAGE_SIDE, request.value("height").toInt(800), MAX_IMAGE_SIDE));
+    const double maxScale = std::sqrt(double(MAX_IMAGE_PIXELS) / (double(size.width()) * size.height()));
+    const int dpi = qBound(MIN_IMAGE_DPI, request.value("dpi").toInt(96),
+                           qMax(MIN_IMAGE_DPI, int(96.0 * maxScale)));
+
+    PlotRenderer renderer(m_plot->renderModel());
+    const QImage image = renderer.renderImage(size, dpi);
+
+    Response response;
+    QBuffer buffer(&response.payload);
+    buffer.open(QIODevice::WriteOnly);
+    if (!image.save(&buffer, qPrintable(format), format == "JPG" || format == "JPEG" ? 95 : -1))
+        return errorResponse("image encoding failed");
+    response.header["contentType"] = QString("image/%1").arg(format == "JPG" ? "jpeg" : format.toLower());
+    response.header["width"] = image.width();
+    response.header["height"] = image.height();
+    response.header["dpi"] = dpi;
+    return response;
+}
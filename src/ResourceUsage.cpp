@@ -0,0 +1,103 @@
+#include "ResourceUsage.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+std::atomic<quint64> s_allocations{0};
+std::atomic<quint64> s_bytes{0};
+
+} // namespace
+
+#ifdef GB2_COUNT_ALLOCATIONS
+static inline void countAllocation(size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+// Linked with --wrap: every malloc/calloc/realloc reference in the executable and the
+// static libraries lands here first
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    countAllocation(size);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    countAllocation(count * size);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    countAllocation(size);
+    return __real_realloc(ptr, size);
+}
+}
+
+// A shared libstdc++ calls its own (unwrapped) malloc from operator new; replacing
+// operator new here routes C++ allocations through the wrapped malloc above
+void *operator new(size_t size)
+{
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void *operator new[](size_t size) { return ::operator new(size); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return std::malloc(size ? size : 1); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return std::malloc(size ? size : 1); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+#endif
+
+namespace ResourceUsage {
+
+qint64 peakRssBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return qint64(counters.PeakWorkingSetSize);
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#if defined(Q_OS_MACOS)
+    return qint64(usage.ru_maxrss);          // bytes
+#else
+    return qint64(usage.ru_maxrss) * 1024;   // kilobytes
+#endif
+#endif
+}
+
+bool countsAllocations()
+{
+#ifdef GB2_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+quint64 allocationCount() { return s_allocations.load(std::memory_order_relaxed); }
+quint64 allocatedBytes() { return s_bytes.load(std::memory_order_relaxed); }
+
+} // namespace ResourceUsage
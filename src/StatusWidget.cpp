@@ -6,6 +6,7 @@ StatusWidget::StatusWidget(QWidget *parent)
     , m_layout(nullptr)
     , m_messageLabel(nullptr)
     , m_progressBar(nullptr)
+    , m_memoryLabel(nullptr)
     , m_clearTimer(new QTimer(this))
     , m_flashTimer(new QTimer(this))
     , m_flashCount(0)
@@ -49,6 +50,30 @@ void StatusWidget::setRightWidget(QWidget *widget)
     m_layout->addWidget(widget, 1);  // stretch=1, right half
 }
 
+void StatusWidget::setMemoryUsage(const MemoryUsage &usage, qint64 budget)
+{
+    // Created on first use so it lands right of the scaling label
+    if (!m_memoryLabel) {
+        m_memoryLabel = new QLabel(this);
+        m_layout->addWidget(m_memoryLabel);
+    }
+
+    const qint64 total = usage.total();
+    m_memoryLabel->setText(budget > 0
+        ? QString("Memory: %1 / %2").arg(MemoryUsage::format(total), MemoryUsage::format(budget))
+        : QString("Memory: %1").arg(MemoryUsage::format(total)));
+    m_memoryLabel->setToolTip(QString("Loaded data and plot caches\n"
+                                      "Column buffers: %1\nStrings: %2\nCaches: %3")
+                                  .arg(MemoryUsage::format(usage.buffers),
+                                       MemoryUsage::format(usage.strings),
+                                       MemoryUsage::format(usage.caches)));
+    // Orange from 80% of the budget, red above it
+    QString color = "#666666";
+    if (budget > 0 && total > budget) color = Config::ERROR_COLOR.name();
+    else if (budget > 0 && total * 5 > budget * 4) color = Config::WARNING_COLOR.name();
+    m_memoryLabel->setStyleSheet(QString("padding: 2px 5px; color: %1;").arg(color));
+}
+
 void StatusWidget::showCenterMessage(const QString &message, const QColor &bgColor)
 {
     QMessageBox *msg = new QMessageBox(this);
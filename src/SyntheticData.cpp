@@ -0,0 +1,349 @@
+#include "SyntheticData.h"
+#include <QDate>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QVector>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+struct VariableShape {
+    QString name;
+    double max;      // end-of-season value of the best treatment
+    int decimals;
+};
+
+// Real PlantGro columns with plausible magnitudes, so value widths and the
+// numeric parsing paths match what a Maize run produces
+const VariableShape KNOWN_VARIABLES[] = {
+    {"LAID", 5.5, 2},   {"CWAD", 18000, 0}, {"GWAD", 9000, 0},  {"HIAD", 0.5, 3},
+    {"LWAD", 3500, 0},  {"SWAD", 6000, 0},  {"RWAD", 1500, 0},  {"VWAD", 9000, 0},
+    {"PWAD", 10500, 0}, {"SLAD", 250, 1},   {"CHTD", 2.4, 2},   {"CWID", 0.8, 2},
+    {"RDPD", 1.5, 2},   {"L#SD", 20, 1},    {"GSTD", 9, 0},     {"T#AD", 12, 1},
+    {"EWSD", 0.3, 3},   {"WSPD", 0.4, 3},   {"WSGD", 0.5, 3},   {"NSTD", 0.3, 3},
+    {"LN%D", 4.0, 2},   {"SN%D", 2.0, 2},   {"GN%D", 1.6, 2},   {"SH%D", 30, 1},
+};
+const int KNOWN_COUNT = int(sizeof(KNOWN_VARIABLES) / sizeof(KNOWN_VARIABLES[0]));
+
+VariableShape shapeAt(int index)
+{
+    if (index < KNOWN_COUNT) return KNOWN_VARIABLES[index];
+    const int n = index - KNOWN_COUNT + 1;
+    return {QString("V%1").arg(n, 3, 10, QChar('0')), 100.0 * (1 + n % 7), 1};
+}
+
+// splitmix64: the same sequence on every compiler and standard library
+class Random
+{
+public:
+    explicit Random(quint64 seed) : m_state(seed) {}
+    double uniform()   // [0, 1)
+    {
+        quint64 z = (m_state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        return double(z >> 11) * (1.0 / 9007199254740992.0);
+    }
+    double noise(double amplitude) { return 1.0 + (uniform() - 0.5) * 2.0 * amplitude; }
+
+private:
+    quint64 m_state;
+};
+
+// Logistic growth over the season, scaled by treatment (better treatments grow more)
+// and run (later seasons slightly less)
+double curve(const VariableShape &shape, const SyntheticSpec &spec, int trt, int run, int day)
+{
+    const double trtScale = 0.7 + 0.3 * (spec.treatments > 1 ? double(trt - 1) / (spec.treatments - 1) : 1.0);
+    const double runScale = 1.0 - 0.04 * ((run - 1) % 4);
+    const double mid = spec.days * 0.45;
+    const double k = 10.0 / qMax(1, spec.days);
+    return shape.max * trtScale * runScale / (1.0 + std::exp(-k * (day - mid)));
+}
+
+QString field(double value, int decimals, int width)
+{
+    return QString::number(value, 'f', decimals).rightJustified(width);
+}
+
+QDate seasonDate(const SyntheticSpec &spec, int run, int day)
+{
+    // Planting on DOY 100
+    return QDate(spec.firstYear + run - 1, 1, 1).addDays(99 + day);
+}
+
+int yyyyddd(const QDate &date) { return date.year() * 1000 + date.dayOfYear(); }
+
+QString treatmentName(int trt) { return QString("Synthetic treatment %1").arg(trt); }
+
+bool openText(QFile &file, QString *error)
+{
+    // Binary mode: "\n" line ends on every platform, so outputs compare byte for byte
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return true;
+    if (error) *error = QString("cannot write %1").arg(file.fileName());
+    return false;
+}
+
+bool writePlantGro(const QString &path, const SyntheticSpec &spec, QString *error)
+{
+    QFile file(path);
+    if (!openText(file, error)) return false;
+    QTextStream out(&file);
+    Random random(spec.seed);
+
+    QVector<VariableShape> shapes;
+    for (int v = 0; v < spec.columns; ++v) shapes.append(shapeAt(v));
+
+    QString header = "@YEAR DOY   DAS   DAP";
+    QVector<int> widths;
+    for (const VariableShape &shape : shapes) {
+        widths.append(qMax(6, int(shape.name.size()) + 1));
+        header += shape.name.rightJustified(widths.last());
+    }
+
+    out << "$GROWTH ASPECTS OUTPUT FILE\n\n"
+        << "*DSSAT Cropping System Model Ver. 4.8.5.000 (synthetic)\n";
+
+    int runNo = 0;
+    for (int run = 1; run <= spec.runs; ++run) {
+        for (int trt = 1; trt <= spec.treatments; ++trt) {
+            ++runNo;
+            out << "\n*RUN " << QString::number(runNo).rightJustified(3) << "        : "
+                << treatmentName(trt).leftJustified(30) << " " << spec.crop << "CER048 "
+                << spec.experiment << " " << trt << "\n"
+                << " MODEL          : " << spec.crop << "CER048 - Synthetic\n"
+                << " EXPERIMENT     : " << spec.experiment << " " << spec.crop
+                << " SYNTHETIC BENCHMARK DATA\n"
+                << " DATA PATH      :\n"
+                << " TREATMENT" << QString::number(trt).rightJustified(3) << "   : "
+                << treatmentName(trt).leftJustified(30) << " " << spec.crop << "CER048\n\n"
+                << header << "\n";
+
+            for (int day = 0; day < spec.days; ++day) {
+                const QDate date = seasonDate(spec, run, day);
+                QString line = QString(" %1 %2 %3 %4")
+                                   .arg(date.year(), 4).arg(date.dayOfYear(), 3)
+                                   .arg(day, 5).arg(qMax(0, day - 2), 5);
+                for (int v = 0; v < shapes.size(); ++v) {
+                    if (random.uniform() < spec.missingRate) {
+                        line += QString("-99").rightJustified(widths[v]);
+                        continue;
+                    }
+                    const double value = curve(shapes[v], spec, trt, run, day) * random.noise(0.03);
+                    line += field(value, shapes[v].decimals, widths[v]);
+                }
+                out << line << "\n";
+            }
+        }
+    }
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+// Fixed-width file with a dotted-header text column (TNAM), like DSSAT writes it
+struct OsuField {
+    const char *name;
+    int width;
+    bool text;
+};
+
+bool writeSummaryOsu(const QString &path, const SyntheticSpec &spec, QString *error)
+{
+    QFile file(path);
+    if (!openText(file, error)) return false;
+    QTextStream out(&file);
+    Random random(spec.seed ^ 0x05u);
+
+    const OsuField fields[] = {
+        {"RUNNO", 8, false}, {"TRNO", 6, false}, {"R#", 2, false}, {"O#", 2, false},
+        {"C#", 2, false},    {"CR", 2, true},    {"MODEL", 8, true}, {"EXNAME", 8, true},
+        {"TNAM", 25, true},  {"FNAM", 8, true},  {"SDAT", 7, false}, {"PDAT", 7, false},
+        {"ADAT", 7, false},  {"MDAT", 7, false}, {"HDAT", 7, false}, {"HWAM", 7, false},
+        {"CWAM", 7, false},  {"HIAM", 6, false}, {"LAIX", 6, false}, {"GNAM", 6, false},
+        {"CNAM", 6, false},  {"PRCP", 6, false}, {"ETCP", 6, false},
+    };
+
+    QStringList header;
+    for (const OsuField &f : fields) {
+        const QString name = QString::fromLatin1(f.name);
+        header << (f.text ? name.leftJustified(f.width, '.') : name.rightJustified(f.width));
+    }
+    out << "*SUMMARY : " << spec.experiment << spec.crop << " SYNTHETIC BENCHMARK DATA\n\n"
+        << "!IDENTIFIERS\n"
+        << "@" << header.join(' ') << "\n";
+
+    const VariableShape grain = KNOWN_VARIABLES[2], biomass = KNOWN_VARIABLES[1];
+    const VariableShape harvestIndex = KNOWN_VARIABLES[3], lai = KNOWN_VARIABLES[0];
+    auto numeric = [&](double value, int decimals) {
+        return random.uniform() < spec.missingRate ? QString("-99")
+                                                   : QString::number(value, 'f', decimals);
+    };
+
+    int runNo = 0;
+    for (int run = 1; run <= spec.runs; ++run) {
+        for (int trt = 1; trt <= spec.treatments; ++trt) {
+            ++runNo;
+            const int end = spec.days - 1;
+            const QDate planting = seasonDate(spec, run, 0);
+            const QStringList values = {
+                QString::number(runNo), QString::number(trt), QString::number(run), "1", "0",
+                spec.crop, spec.crop + "CER048", spec.experiment, treatmentName(trt),
+                QString("IB%1%2").arg(spec.crop).arg(trt, 4, 10, QChar('0')),
+                QString::number(yyyyddd(planting.addDays(-7))),
+                QString::number(yyyyddd(planting)),
+                QString::number(yyyyddd(planting.addDays(end / 2))),
+                QString::number(yyyyddd(planting.addDays(end))),
+                QString::number(yyyyddd(planting.addDays(end + 5))),
+                numeric(curve(grain, spec, trt, run, end) * random.noise(0.03), 0),
+                numeric(curve(biomass, spec, trt, run, end) * random.noise(0.03), 0),
+                numeric(curve(harvestIndex, spec, trt, run, end) * random.noise(0.03), 3),
+                numeric(curve(lai, spec, trt, run, spec.days / 2) * random.noise(0.03), 2),
+                numeric(2500 * random.noise(0.1), 0),
+                numeric(120 * random.noise(0.1), 0),
+                numeric(450 * random.noise(0.2), 0),
+                numeric(520 * random.noise(0.1), 0),
+            };
+            QStringList row;
+            for (int f = 0; f < values.size(); ++f) {
+                row << (fields[f].text ? values[f].leftJustified(fields[f].width, ' ', true)
+                                       : values[f].rightJustified(fields[f].width));
+            }
+            out << " " << row.join(' ') << "\n";
+        }
+    }
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+bool writeEvaluate(const QString &path, const SyntheticSpec &spec, QString *error)
+{
+    QFile file(path);
+    if (!openText(file, error)) return false;
+    QTextStream out(&file);
+    Random random(spec.seed ^ 0x0Eu);
+
+    const int end = spec.days - 1;
+    struct Pair {
+        const char *name;
+        VariableShape shape;
+        int day;
+    };
+    const Pair pairs[] = {
+        {"HWAM", KNOWN_VARIABLES[2], end}, {"CWAM", KNOWN_VARIABLES[1], end},
+        {"HIAM", KNOWN_VARIABLES[3], end}, {"LAIX", KNOWN_VARIABLES[0], spec.days / 2},
+        {"LWAM", KNOWN_VARIABLES[4], end}, {"SWAM", KNOWN_VARIABLES[5], end},
+    };
+
+    QString header = "@RUN EXCODE        TRNO RN CR   ADATS   ADATM   MDATS   MDATM";
+    for (const Pair &p : pairs)
+        header += QString(" %1S %1M").arg(QString::fromLatin1(p.name).rightJustified(6));
+    out << "*EVALUATION : " << spec.experiment << spec.crop << " SYNTHETIC BENCHMARK DATA\n\n"
+        << header << "\n";
+
+    auto measured = [&](double value, int decimals, int width) {
+        return random.uniform() < spec.missingRate ? QString("-99").rightJustified(width)
+                                                   : field(value, decimals, width);
+    };
+
+    int runNo = 0;
+    for (int run = 1; run <= spec.runs; ++run) {
+        for (int trt = 1; trt <= spec.treatments; ++trt) {
+            ++runNo;
+            const int anthesis = seasonDate(spec, run, end / 2).dayOfYear();
+            const int maturity = seasonDate(spec, run, end).dayOfYear();
+            QString line = QString(" %1 %2 %3 %4 %5 %6 %7 %8 %9")
+                               .arg(runNo, 3).arg(spec.experiment + spec.crop, -13)
+                               .arg(trt, 4).arg(run, 2).arg(spec.crop)
+                               .arg(anthesis, 7).arg(anthesis + int(std::lround((random.uniform() - 0.5) * 6)), 7)
+                               .arg(maturity, 7).arg(maturity + int(std::lround((random.uniform() - 0.5) * 8)), 7);
+            for (const Pair &p : pairs) {
+                const int width = int(strlen(p.name)) + 3;
+                const double sim = curve(p.shape, spec, trt, run, p.day);
+                line += " " + field(sim, p.shape.decimals, width);
+                line += " " + measured(sim * random.noise(0.15), p.shape.decimals, width);
+            }
+            out << line << "\n";
+        }
+    }
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+bool writeTFile(const QString &path, const SyntheticSpec &spec, int obsColumns, QString *error)
+{
+    QFile file(path);
+    if (!openText(file, error)) return false;
+    QTextStream out(&file);
+    Random random(spec.seed ^ 0x7Fu);
+
+    QString header = "@TRNO DATE ";
+    for (int v = 0; v < obsColumns; ++v)
+        header += shapeAt(v).name.rightJustified(6);
+    out << "*EXP.DATA (T): " << spec.experiment << spec.crop << " SYNTHETIC BENCHMARK DATA\n\n"
+        << header << "\n";
+
+    // Observations of the first season, every obsInterval days from mid-interval
+    const int interval = qMax(1, spec.obsInterval);
+    for (int trt = 1; trt <= spec.treatments; ++trt) {
+        for (int day = interval / 2; day < spec.days; day += interval) {
+            const QDate date = seasonDate(spec, 1, day);
+            QString line = QString(" %1 %2%3").arg(trt, 4)
+                               .arg(date.year() % 100, 2, 10, QChar('0'))
+                               .arg(date.dayOfYear(), 3, 10, QChar('0'));
+            for (int v = 0; v < obsColumns; ++v) {
+                const VariableShape shape = shapeAt(v);
+                if (random.uniform() < spec.missingRate) {
+                    line += QString("-99").rightJustified(6);
+                    continue;
+                }
+                line += field(curve(shape, spec, trt, 1, day) * random.noise(0.12), shape.decimals, 6);
+            }
+            out << line << "\n";
+        }
+    }
+    out.flush();
+    return out.status() == QTextStream::Ok;
+}
+
+} // namespace
+
+namespace SyntheticData {
+
+QStringList variableNames(int count)
+{
+    QStringList names;
+    for (int v = 0; v < count; ++v) names << shapeAt(v).name;
+    return names;
+}
+
+bool write(const QString &dir, const SyntheticSpec &spec, SyntheticFiles *files, QString *error)
+{
+    if (!QDir().mkpath(dir)) {
+        if (error) *error = QString("cannot create %1").arg(dir);
+        return false;
+    }
+    const QDir folder(dir);
+    const int obsColumns = qBound(0, spec.obsColumns, spec.columns);
+
+    SyntheticFiles written;
+    written.plantGro = folder.absoluteFilePath("PlantGro.OUT");
+    written.summaryOsu = folder.absoluteFilePath("Summary.OSU");
+    written.evaluate = folder.absoluteFilePath("EVALUATE.OUT");
+    written.tFile = folder.absoluteFilePath(QString("%1.%2T").arg(spec.experiment, spec.crop));
+    written.variables = variableNames(spec.columns);
+    written.observedVariables = written.variables.mid(0, obsColumns);
+
+    if (!writePlantGro(written.plantGro, spec, error) ||
+        !writeSummaryOsu(written.summaryOsu, spec, error) ||
+        !writeEvaluate(written.evaluate, spec, error) ||
+        !writeTFile(written.tFile, spec, obsColumns, error))
+        return false;
+
+    if (files) *files = written;
+    return true;
+}
+
+} // namespace SyntheticData
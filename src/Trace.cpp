@@ -0,0 +1,227 @@
+#include "Trace.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace Trace {
+
+std::atomic<bool> g_enabled{false};
+
+namespace {
+
+struct Event {
+    const char *name;
+    qint64 startNs;
+    qint64 endNs;
+    QString arg;
+};
+
+// Each thread appends to its own buffer; the mutex is only contended while stop()
+// collects. Buffers outlive their threads so late events are never lost.
+struct ThreadBuffer {
+    QMutex mutex;
+    QVector<Event> events;
+    qint64 lastMarkNs = 0;
+    int tid = 0;
+    QString name;
+};
+
+QMutex s_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+QString s_filePath;
+std::atomic<qint64> s_originNs{0};
+std::atomic<bool> s_summaryPending{false};
+thread_local ThreadBuffer *t_buffer = nullptr;
+
+ThreadBuffer *threadBuffer()
+{
+    if (t_buffer) return t_buffer;
+
+    QMutexLocker lock(&s_registryMutex);
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->tid = static_cast<int>(s_buffers.size()) + 1;
+    QThread *thread = QThread::currentThread();
+    if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+        buffer->name = "main";
+    else if (thread && !thread->objectName().isEmpty())
+        buffer->name = thread->objectName();
+    else
+        buffer->name = QString("worker %1").arg(buffer->tid);
+    buffer->events.reserve(1024);
+    t_buffer = buffer.get();
+    s_buffers.push_back(std::move(buffer));
+    return t_buffer;
+}
+
+} // namespace
+
+qint64 now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void start(const QString &filePath)
+{
+    if (filePath.isEmpty()) return;
+    {
+        QMutexLocker lock(&s_registryMutex);
+        s_filePath = filePath;
+    }
+    if (!isEnabled()) s_originNs.store(now());
+    g_enabled.store(true);
+}
+
+void startSummary()
+{
+    if (!isEnabled()) s_originNs.store(now());
+    s_summaryPending.store(true);
+    g_enabled.store(true);
+}
+
+bool summaryPending()
+{
+    return s_summaryPending.load();
+}
+
+void printSummary()
+{
+    if (!s_summaryPending.exchange(false)) return;
+
+    const qint64 origin = s_originNs.load();
+    ThreadBuffer *buffer = threadBuffer();
+    QVector<Event> events;
+    {
+        QMutexLocker lock(&buffer->mutex);
+        events = buffer->events;
+    }
+    std::stable_sort(events.begin(), events.end(),
+                     [](const Event &a, const Event &b) { return a.endNs < b.endNs; });
+
+    fprintf(stderr, "\nStartup trace (ms)\n");
+    fprintf(stderr, "  %-32s %9s %9s\n", "phase", "duration", "at");
+    for (const Event &e : events) {
+        if (e.startNs < origin) continue;
+        fprintf(stderr, "  %-32s %9.1f %9.1f\n", e.name,
+                (e.endNs - e.startNs) / 1e6, (e.endNs - origin) / 1e6);
+    }
+    fflush(stderr);
+
+    // Without a trace file there is nothing more to record for
+    bool hasFile;
+    {
+        QMutexLocker lock(&s_registryMutex);
+        hasFile = !s_filePath.isEmpty();
+    }
+    if (!hasFile) stop();
+}
+
+void startFromEnvironment()
+{
+    if (!isEnabled() && qEnvironmentVariableIsSet("GB2_TRACE"))
+        start(qEnvironmentVariable("GB2_TRACE"));
+}
+
+void setThreadName(const QString &name)
+{
+    ThreadBuffer *buffer = threadBuffer();
+    QMutexLocker lock(&buffer->mutex);
+    buffer->name = name;
+}
+
+void record(const char *name, qint64 startNs, qint64 endNs, const QString &arg)
+{
+    ThreadBuffer *buffer = threadBuffer();
+    QMutexLocker lock(&buffer->mutex);
+    buffer->events.append(Event{name, startNs, endNs, arg});
+}
+
+void mark(const char *phase)
+{
+    if (!isEnabled()) return;
+    const qint64 end = now();
+    ThreadBuffer *buffer = threadBuffer();
+    QMutexLocker lock(&buffer->mutex);
+    const qint64 start = qMax(buffer->lastMarkNs, s_originNs.load());
+    buffer->events.append(Event{phase, start, end, QString()});
+    buffer->lastMarkNs = end;
+}
+
+bool stop()
+{
+    if (!g_enabled.exchange(false)) return true;
+
+    const qint64 origin = s_originNs.load();
+    const qint64 pid = QCoreApplication::applicationPid();
+    auto micros = [origin](qint64 ns) { return (ns - origin) / 1000.0; };
+
+    QJsonArray events;
+    QJsonObject process;
+    process["name"] = "process_name";
+    process["ph"] = "M";
+    process["pid"] = pid;
+    process["args"] = QJsonObject{{"name", QCoreApplication::applicationName().isEmpty()
+                                              ? QString("GB2") : QCoreApplication::applicationName()}};
+    events.append(process);
+
+    QString filePath;
+    {
+        QMutexLocker registryLock(&s_registryMutex);
+        filePath = s_filePath;
+        for (const auto &buffer : s_buffers) {
+            QMutexLocker lock(&buffer->mutex);
+            QJsonObject thread;
+            thread["name"] = "thread_name";
+            thread["ph"] = "M";
+            thread["pid"] = pid;
+            thread["tid"] = buffer->tid;
+            thread["args"] = QJsonObject{{"name", buffer->name}};
+            events.append(thread);
+
+            for (const Event &e : buffer->events) {
+                if (e.startNs < origin) continue;   // from an earlier session
+                QJsonObject o;
+                o["name"] = QString::fromLatin1(e.name);
+                o["ph"] = "X";
+                o["pid"] = pid;
+                o["tid"] = buffer->tid;
+                o["ts"] = micros(e.startNs);
+                o["dur"] = (e.endNs - e.startNs) / 1000.0;
+                if (!e.arg.isEmpty())
+                    o["args"] = QJsonObject{{"detail", e.arg}};
+                events.append(o);
+            }
+            buffer->events.clear();
+        }
+    }
+
+    // Summary-only session: nothing to write
+    if (filePath.isEmpty()) return true;
+
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        fprintf(stderr, "trace: cannot write %s\n", qPrintable(filePath));
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    fprintf(stderr, "trace: %lld events written to %s\n",
+            static_cast<long long>(events.size()), qPrintable(filePath));
+    return true;
+}
+
+} // namespace Trace
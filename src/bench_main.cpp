@@ -0,0 +1,488 @@
+// gb2-bench: reproducible timings of the parsing, join, metrics and plotting paths on
+// synthetic DSSAT output (see SyntheticData.h).
+//
+//   gb2-bench [--runs N] [--treatments N] [--days N] [--columns N] [--missing RATE]
+//             [--seed N] [--iterations N] [--filter TEXT] [--data <dir>]
+//             [--out <results.json>] [--baseline <results.json>]
+//   gb2-bench --check <baseline.json> [--out <results.json>]
+//   gb2-bench --update-baseline <baseline.json>
+//   gb2-bench --generate <dir> [shape options]
+//
+// Every benchmark runs once untimed, then --iterations times; the JSON result has
+// min/median/mean/max per benchmark, allocations of one run, the peak RSS so far and
+// the data shape, so results of two builds can be compared with --baseline (ratios
+// are printed and stored with the result).
+//
+// --check is the ctest perf gate: data shape and iterations come from the baseline
+// file, and the run fails when a median time, an allocation count or the peak RSS
+// grows past the baseline's "tolerance" fractions. --update-baseline rewrites the
+// results in that file and keeps its shape and tolerances. A baseline without results
+// makes --check exit with SKIP_RETURN_CODE before measuring anything, so ctest reports
+// the gate as skipped rather than passed until it has been recorded.
+// --generate writes the synthetic files and exits. Runs offscreen; no display needed.
+#include <QApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include "DataProcessor.h"
+#include "MetricsCalculator.h"
+#include "PlotWidget.h"
+#include "PlotRenderer.h"
+#include "SyntheticData.h"
+#include "ResourceUsage.h"
+#include "Config.h"
+
+namespace {
+
+struct Benchmark {
+    QString name;
+    qint64 items = 0;                  // rows handled per iteration, for throughput
+    std::function<void()> prepare;     // untimed, before every iteration
+    std::function<void()> run;
+};
+
+struct BenchResult {
+    QString name;
+    qint64 items = 0;
+    QVector<double> ms;                // sorted
+    quint64 allocations = 0;           // during the last timed run
+    quint64 allocatedBytes = 0;
+    qint64 peakRssBytes = -1;          // process peak after this benchmark
+    double median() const { return ms.isEmpty() ? 0.0 : ms[ms.size() / 2]; }
+    double mean() const
+    {
+        double sum = 0.0;
+        for (double v : ms) sum += v;
+        return ms.isEmpty() ? 0.0 : sum / ms.size();
+    }
+};
+
+BenchResult measure(const Benchmark &bench, int iterations)
+{
+    BenchResult result;
+    result.name = bench.name;
+    result.items = bench.items;
+    for (int i = -1; i < iterations; ++i) {   // i == -1: warm-up
+        if (bench.prepare) bench.prepare();
+        const quint64 allocations = ResourceUsage::allocationCount();
+        const quint64 allocatedBytes = ResourceUsage::allocatedBytes();
+        QElapsedTimer timer;
+        timer.start();
+        bench.run();
+        const double ms = timer.nsecsElapsed() / 1e6;
+        if (i >= 0) result.ms.append(ms);
+        result.allocations = ResourceUsage::allocationCount() - allocations;
+        result.allocatedBytes = ResourceUsage::allocatedBytes() - allocatedBytes;
+    }
+    std::sort(result.ms.begin(), result.ms.end());
+    result.peakRssBytes = ResourceUsage::peakRssBytes();
+    return result;
+}
+
+QJsonObject specJson(const SyntheticSpec &spec)
+{
+    QJsonObject o;
+    o["runs"] = spec.runs;
+    o["treatments"] = spec.treatments;
+    o["days"] = spec.days;
+    o["columns"] = spec.columns;
+    o["missingRate"] = spec.missingRate;
+    o["obsInterval"] = spec.obsInterval;
+    o["obsColumns"] = spec.obsColumns;
+    o["seed"] = qint64(spec.seed);
+    return o;
+}
+
+void readSpec(const QJsonObject &o, SyntheticSpec *spec)
+{
+    spec->runs = o.value("runs").toInt(spec->runs);
+    spec->treatments = o.value("treatments").toInt(spec->treatments);
+    spec->days = o.value("days").toInt(spec->days);
+    spec->columns = o.value("columns").toInt(spec->columns);
+    spec->missingRate = o.value("missingRate").toDouble(spec->missingRate);
+    spec->obsInterval = o.value("obsInterval").toInt(spec->obsInterval);
+    spec->obsColumns = o.value("obsColumns").toInt(spec->obsColumns);
+    spec->seed = quint32(o.value("seed").toInteger(spec->seed));
+}
+
+QJsonObject resultJson(const BenchResult &r)
+{
+    QJsonObject o;
+    o["name"] = r.name;
+    o["iterations"] = int(r.ms.size());
+    o["items"] = r.items;
+    o["minMs"] = r.ms.isEmpty() ? 0.0 : r.ms.first();
+    o["medianMs"] = r.median();
+    o["meanMs"] = r.mean();
+    o["maxMs"] = r.ms.isEmpty() ? 0.0 : r.ms.last();
+    o["itemsPerSec"] = r.median() > 0.0 ? r.items / (r.median() / 1000.0) : 0.0;
+    if (ResourceUsage::countsAllocations()) {
+        o["allocations"] = qint64(r.allocations);
+        o["allocatedBytes"] = qint64(r.allocatedBytes);
+    }
+    o["peakRssBytes"] = r.peakRssBytes;
+    return o;
+}
+
+bool readJson(const QString &path, QJsonObject *object)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !doc.isObject()) return false;
+    *object = doc.object();
+    return true;
+}
+
+bool writeJson(const QString &path, const QJsonObject &object)
+{
+    const QByteArray json = QJsonDocument(object).toJson(QJsonDocument::Indented);
+    if (path == "-") {
+        fwrite(json.constData(), 1, size_t(json.size()), stdout);
+        return true;
+    }
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    return file.write(json) == json.size();
+}
+
+// Adds the DataProcessor tables the way loadOutputFiles shapes them: CROP on the
+// simulated rows; EXPERIMENT, CROP and DAS/DAP on the observed ones
+struct LoadedData {
+    DataTable sim;
+    DataTable obs;
+    DataTable obsBeforeJoin;   // obs without DAS/DAP, input of the addDasDapColumns benchmark
+    QMap<QString, QMap<QString, QString>> treatmentNames;
+};
+
+bool loadData(DataProcessor &processor, const SyntheticFiles &files, const SyntheticSpec &spec,
+              LoadedData *data)
+{
+    if (!processor.readOutFile(files.plantGro, data->sim)) return false;
+    if (!processor.readTFile(files.tFile, data->obs)) return false;
+
+    auto addConstant = [](DataTable &table, const QString &name, const QString &value) {
+        if (table.columnNames.contains(name)) return;
+        DataColumn column(name);
+        column.data.fill(value, table.rowCount);
+        table.addColumn(column);
+    };
+    addConstant(data->sim, "CROP", spec.crop);
+    addConstant(data->obs, "EXPERIMENT", spec.experiment);
+    addConstant(data->obs, "CROP", spec.crop);
+    data->obsBeforeJoin = data->obs;
+    processor.addDasDapColumns(data->obs, data->sim);
+
+    for (int trt = 1; trt <= spec.treatments; ++trt)
+        data->treatmentNames[spec.experiment][QString::number(trt)] = QString("Synthetic treatment %1").arg(trt);
+    return true;
+}
+
+// Allowed growth over the baseline, as fractions. Time is loose because the gate runs
+// on shared CI machines; allocation counts hardly vary between runs, so they catch
+// per-cell copies and conversions long before the timings do.
+struct Tolerance {
+    double time = 1.0;
+    double allocations = 0.10;
+    double rss = 0.25;
+};
+
+Tolerance readTolerance(const QJsonObject &baseline)
+{
+    const QJsonObject o = baseline.value("tolerance").toObject();
+    Tolerance tolerance;
+    tolerance.time = o.value("time").toDouble(tolerance.time);
+    tolerance.allocations = o.value("allocations").toDouble(tolerance.allocations);
+    tolerance.rss = o.value("rss").toDouble(tolerance.rss);
+    return tolerance;
+}
+
+QJsonObject toleranceJson(const Tolerance &tolerance)
+{
+    QJsonObject o;
+    o["time"] = tolerance.time;
+    o["allocations"] = tolerance.allocations;
+    o["rss"] = tolerance.rss;
+    return o;
+}
+
+// One line per regression of results against a recorded baseline
+QStringList checkAgainstBaseline(const QJsonObject &baseline, const QJsonArray &results, qint64 peakRss)
+{
+    const Tolerance tolerance = readTolerance(baseline);
+    const bool compareAllocations = ResourceUsage::countsAllocations() &&
+                                    baseline.value("allocationsCounted").toBool();
+    QHash<QString, QJsonObject> recorded;
+    for (const QJsonValue &v : baseline.value("results").toArray())
+        recorded[v.toObject().value("name").toString()] = v.toObject();
+
+    QStringList failures;
+    for (const QJsonValue &v : results) {
+        const QJsonObject r = v.toObject();
+        const QString name = r.value("name").toString();
+        if (!recorded.contains(name)) continue;
+        const QJsonObject b = recorded.value(name);
+
+        const double baseMs = b.value("medianMs").toDouble();
+        const double ms = r.value("medianMs").toDouble();
+        if (baseMs > 0.0 && ms > baseMs * (1.0 + tolerance.time))
+            failures << QString("%1: median %2 ms, baseline %3 ms (+%4% allowed)").arg(name)
+                            .arg(ms, 0, 'f', 2).arg(baseMs, 0, 'f', 2).arg(tolerance.time * 100, 0, 'f', 0);
+
+        const double baseAllocations = b.value("allocations").toDouble();
+        const double allocations = r.value("allocations").toDouble();
+        if (compareAllocations && baseAllocations > 0.0 && allocations > baseAllocations * (1.0 + tolerance.allocations))
+            failures << QString("%1: %2 allocations, baseline %3 (+%4% allowed)").arg(name)
+                            .arg(allocations, 0, 'f', 0).arg(baseAllocations, 0, 'f', 0)
+                            .arg(tolerance.allocations * 100, 0, 'f', 0);
+    }
+
+    const double baseRss = baseline.value("peakRssBytes").toDouble();
+    if (baseRss > 0.0 && peakRss > baseRss * (1.0 + tolerance.rss))
+        failures << QString("peak RSS %1 MB, baseline %2 MB (+%3% allowed)")
+                        .arg(peakRss / 1048576.0, 0, 'f', 1).arg(baseRss / 1048576.0, 0, 'f', 1)
+                        .arg(tolerance.rss * 100, 0, 'f', 0);
+    return failures;
+}
+
+// ctest's SKIP_RETURN_CODE for perf_pipeline (see CMakeLists.txt)
+constexpr int SKIP_RETURN_CODE = 77;
+
+int usage()
+{
+    QTextStream err(stderr);
+    err << "usage: gb2-bench [--runs N] [--treatments N] [--days N] [--columns N] [--missing RATE]\n"
+           "                 [--seed N] [--iterations N] [--filter TEXT] [--data <dir>]\n"
+           "                 [--out <results.json>] [--baseline <results.json>]\n"
+           "       gb2-bench --check <baseline.json> [--out <results.json>]\n"
+           "       gb2-bench --update-baseline <baseline.json>\n"
+           "       gb2-bench --generate <dir> [shape options]\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // Charts are laid out and rendered without a window
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName(Config::APP_NAME);
+    QCoreApplication::setApplicationVersion(Config::APP_VERSION);
+    QCoreApplication::setOrganizationName(Config::ORGANIZATION_NAME);
+
+    SyntheticSpec spec;
+    int iterations = 5;
+    QString filter;
+    QString dataDir;
+    QString generateDir;
+    QString outputPath;
+    QString baselinePath;
+    QString checkPath;
+    QString updatePath;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        const QString &arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+        bool ok = true;
+        if (arg == "--runs" && hasValue) spec.runs = args[++i].toInt(&ok);
+        else if (arg == "--treatments" && hasValue) spec.treatments = args[++i].toInt(&ok);
+        else if (arg == "--days" && hasValue) spec.days = args[++i].toInt(&ok);
+        else if (arg == "--columns" && hasValue) spec.columns = args[++i].toInt(&ok);
+        else if (arg == "--missing" && hasValue) spec.missingRate = args[++i].toDouble(&ok);
+        else if (arg == "--seed" && hasValue) spec.seed = args[++i].toUInt(&ok);
+        else if (arg == "--iterations" && hasValue) iterations = args[++i].toInt(&ok);
+        else if (arg == "--filter" && hasValue) filter = args[++i];
+        else if (arg == "--data" && hasValue) dataDir = args[++i];
+        else if (arg == "--generate" && hasValue) generateDir = args[++i];
+        else if ((arg == "-o" || arg == "--out") && hasValue) outputPath = args[++i];
+        else if (arg == "--baseline" && hasValue) baselinePath = args[++i];
+        else if (arg == "--check" && hasValue) checkPath = args[++i];
+        else if (arg == "--update-baseline" && hasValue) updatePath = args[++i];
+        else return usage();
+        if (!ok) return usage();
+    }
+
+    // The gate's data shape and iteration count are part of its baseline file
+    QJsonObject baseline;
+    const QString recordPath = !checkPath.isEmpty() ? checkPath : updatePath;
+    const QString comparePath = !recordPath.isEmpty() ? recordPath : baselinePath;
+    if (!comparePath.isEmpty() && !readJson(comparePath, &baseline) && comparePath != updatePath) {
+        fprintf(stderr, "gb2-bench: cannot read baseline %s\n", qPrintable(comparePath));
+        return 1;
+    }
+    // Nothing to compare against: skip before spending the gate's time measuring
+    if (!checkPath.isEmpty() && baseline.value("results").toArray().isEmpty()) {
+        fprintf(stderr, "gb2-bench: %s has no recorded results yet; record them with "
+                        "gb2-bench --update-baseline on the reference machine\n", qPrintable(checkPath));
+        return SKIP_RETURN_CODE;
+    }
+    if (!recordPath.isEmpty()) {
+        readSpec(baseline.value("spec").toObject(), &spec);
+        iterations = baseline.value("iterations").toInt(iterations);
+    }
+    if (spec.runs < 1 || spec.treatments < 1 || spec.days < 1 || spec.columns < 1 ||
+        spec.missingRate < 0.0 || spec.missingRate >= 1.0 || iterations < 1)
+        return usage();
+
+    QTemporaryDir tempDir;
+    const QString folder = !generateDir.isEmpty() ? generateDir
+                         : !dataDir.isEmpty() ? dataDir : tempDir.path();
+    SyntheticFiles files;
+    QString error;
+    if (!SyntheticData::write(folder, spec, &files, &error)) {
+        fprintf(stderr, "gb2-bench: %s\n", qPrintable(error));
+        return 1;
+    }
+    if (!generateDir.isEmpty()) {
+        fprintf(stderr, "gb2-bench: %lld simulated rows written to %s\n",
+                static_cast<long long>(spec.simRows()), qPrintable(QDir(folder).absolutePath()));
+        return 0;
+    }
+
+    DataProcessor processor;
+    LoadedData data;
+    if (!loadData(processor, files, spec, &data)) {
+        fprintf(stderr, "gb2-bench: cannot read the synthetic files in %s\n", qPrintable(folder));
+        return 1;
+    }
+    const qint64 summaryRows = qint64(spec.runs) * spec.treatments;
+    const QStringList yVars = files.observedVariables.mid(0, 2);
+    const QString exportPath = QDir(tempDir.path()).absoluteFilePath("bench_export.png");
+
+    PlotWidget plot;
+    plot.resize(1200, 800);
+    auto plotTimeSeries = [&]() {
+        plot.plotTimeSeries(data.sim, QFileInfo(folder).fileName(), {"PlantGro.OUT"},
+                            spec.experiment, QStringList(), "DATE", yVars, data.obs,
+                            data.treatmentNames);
+    };
+
+    DataTable scratch;
+    QVector<Benchmark> benchmarks;
+    benchmarks.append({"readOutFile PlantGro.OUT", spec.simRows(), nullptr,
+                       [&]() { processor.readOutFile(files.plantGro, scratch); }});
+    benchmarks.append({"readOsuFile Summary.OSU", summaryRows, nullptr,
+                       [&]() { processor.readOsuFile(files.summaryOsu, scratch); }});
+    benchmarks.append({"readOutFile EVALUATE.OUT", summaryRows, nullptr,
+                       [&]() { processor.readOutFile(files.evaluate, scratch); }});
+    benchmarks.append({"readTFile", data.obs.rowCount, nullptr,
+                       [&]() { processor.readTFile(files.tFile, scratch); }});
+    benchmarks.append({"DataTable::merge", data.sim.rowCount,
+                       [&]() { scratch = data.sim; },
+                       [&]() { scratch.merge(data.sim); }});
+    benchmarks.append({"addDasDapColumns", data.obs.rowCount,
+                       [&]() { scratch = data.obsBeforeJoin; },
+                       [&]() { processor.addDasDapColumns(scratch, data.sim); }});
+    // Metrics on new data: the bootstrap cache would otherwise answer every timed run
+    benchmarks.append({"calculateMetrics", data.obs.rowCount, MetricsCalculator::clearBootstrapCache,
+                       [&]() { MetricsCalculator::obsSimMetrics(data.sim, data.obs, data.treatmentNames, yVars); }});
+    benchmarks.append({"calculateMetrics no CI", data.obs.rowCount, nullptr,
+                       [&]() { MetricsCalculator::obsSimMetrics(data.sim, data.obs, data.treatmentNames, yVars,
+                                                                QSet<QString>(), 0); }});
+    // Replot of unchanged data: every interval comes from the cache
+    benchmarks.append({"calculateMetrics cached", data.obs.rowCount, nullptr,
+                       [&]() { MetricsCalculator::obsSimMetrics(data.sim, data.obs, data.treatmentNames, yVars); }});
+    benchmarks.append({"plotTimeSeries", data.sim.rowCount * yVars.size(), nullptr, plotTimeSeries});
+    benchmarks.append({"export PNG", 1, plotTimeSeries,
+                       [&]() {
+                           PlotRenderer renderer(plot.renderModel());
+                           PlotRenderer::saveImage(renderer.renderImage(QSize(1200, 800), 150), exportPath, "PNG");
+                       }});
+    // parse -> section merge -> DAS/DAP join -> metrics -> plot model, as a file selection does
+    benchmarks.append({"pipeline", spec.simRows(), MetricsCalculator::clearBootstrapCache,
+                       [&]() {
+                           LoadedData loaded;
+                           loadData(processor, files, spec, &loaded);
+                           MetricsCalculator::obsSimMetrics(loaded.sim, loaded.obs, loaded.treatmentNames, yVars);
+                           plot.plotTimeSeries(loaded.sim, QFileInfo(folder).fileName(), {"PlantGro.OUT"},
+                                               spec.experiment, QStringList(), "DATE", yVars, loaded.obs,
+                                               loaded.treatmentNames);
+                       }});
+
+    QHash<QString, double> baselineMedian;
+    if (!baseline.isEmpty()) {
+        if (recordPath.isEmpty() && baseline.value("spec").toObject() != specJson(spec))
+            fprintf(stderr, "gb2-bench: baseline was recorded on a different data shape; ratios are indicative only\n");
+        for (const QJsonValue &v : baseline.value("results").toArray())
+            baselineMedian[v.toObject().value("name").toString()] = v.toObject().value("medianMs").toDouble();
+    }
+
+    fprintf(stderr, "%-26s %10s %10s %14s %12s %10s\n", "benchmark", "median ms", "min ms", "items/s",
+            "allocations", "baseline");
+    QJsonArray results;
+    for (const Benchmark &bench : benchmarks) {
+        if (!filter.isEmpty() && !bench.name.contains(filter, Qt::CaseInsensitive)) continue;
+        const BenchResult r = measure(bench, iterations);
+        QJsonObject o = resultJson(r);
+
+        QString versus;
+        if (baselineMedian.value(r.name) > 0.0) {
+            const double ratio = r.median() / baselineMedian.value(r.name);
+            o["baselineMedianMs"] = baselineMedian.value(r.name);
+            o["ratio"] = ratio;
+            versus = QString("x%1").arg(ratio, 0, 'f', 2);
+        }
+        const QString allocations = ResourceUsage::countsAllocations() ? QString::number(r.allocations) : QString("-");
+        fprintf(stderr, "%-26s %10.2f %10.2f %14.0f %12s %10s\n", qPrintable(r.name), r.median(),
+                r.ms.first(), o["itemsPerSec"].toDouble(), qPrintable(allocations), qPrintable(versus));
+        results.append(o);
+    }
+    const qint64 peakRss = ResourceUsage::peakRssBytes();
+    fprintf(stderr, "peak RSS: %.1f MB\n", peakRss / 1048576.0);
+
+    QJsonObject root;
+    root["tool"] = "gb2-bench";
+    root["version"] = Config::APP_VERSION_FULL;
+    root["qt"] = QString::fromLatin1(qVersion());
+#ifdef QT_DEBUG
+    root["build"] = "debug";
+#else
+    root["build"] = "release";
+#endif
+    root["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["spec"] = specJson(spec);
+    root["iterations"] = iterations;
+    root["allocationsCounted"] = ResourceUsage::countsAllocations();
+    root["peakRssBytes"] = peakRss;
+    root["results"] = results;
+    if (!comparePath.isEmpty()) root["baseline"] = comparePath;
+
+    if (!outputPath.isEmpty() && !writeJson(outputPath, root)) {
+        fprintf(stderr, "gb2-bench: cannot write %s\n", qPrintable(outputPath));
+        return 1;
+    }
+
+    if (!updatePath.isEmpty()) {
+        QJsonObject updated = root;
+        updated.remove("baseline");
+        updated["tolerance"] = baseline.contains("tolerance") ? baseline.value("tolerance")
+                                                              : QJsonValue(toleranceJson(Tolerance()));
+        if (!writeJson(updatePath, updated)) {
+            fprintf(stderr, "gb2-bench: cannot write %s\n", qPrintable(updatePath));
+            return 1;
+        }
+        fprintf(stderr, "gb2-bench: baseline %s updated\n", qPrintable(updatePath));
+    }
+
+    if (!checkPath.isEmpty()) {
+        const QStringList failures = checkAgainstBaseline(baseline, results, peakRss);
+        for (const QString &failure : failures)
+            fprintf(stderr, "REGRESSION %s\n", qPrintable(failure));
+        if (!failures.isEmpty()) return 1;
+        fprintf(stderr, "gb2-bench: within the tolerances of %s\n", qPrintable(checkPath));
+    }
+    return 0;
+}
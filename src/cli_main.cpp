@@ -0,0 +1,119 @@
+// gb2-cli: loads DSSAT output files through gb2core without any widgets, for scripts
+// and for timing the parser and table code in isolation.
+//
+//   gb2-cli [--dssat <base>] [--stats VAR1,VAR2] [--trace <trace.json>]
+//           <cropDir> <file> [file ...]
+//
+// Prints what was loaded (rows, columns, experiments, load time) and, with --stats,
+// the per-column summary statistics of the simulated and observed tables.
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+#include "DataProcessor.h"
+#include "Config.h"
+#include "Trace.h"
+
+namespace {
+
+void printStats(QTextStream &out, const char *label, const DataTable &table, const QStringList &vars)
+{
+    for (const QString &var : vars) {
+        const DataColumn *column = table.getColumn(var);
+        if (!column) continue;
+        const ColumnStats &st = column->stats();
+        out << QString("  %1 %2 n=%3 missing=%4 min=%5 max=%6 mean=%7\n")
+                   .arg(label).arg(var, -8).arg(st.count).arg(st.missingCount)
+                   .arg(st.min, 0, 'g', 6).arg(st.max, 0, 'g', 6).arg(st.mean, 0, 'g', 6);
+    }
+}
+
+int usage()
+{
+    QTextStream err(stderr);
+    err << "usage: gb2-cli [--dssat <base>] [--stats VAR1,VAR2] [--trace <trace.json>]\n"
+           "               <cropDir> <file> [file ...]\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(Config::APP_NAME);
+    QCoreApplication::setApplicationVersion(Config::APP_VERSION);
+    QCoreApplication::setOrganizationName(Config::ORGANIZATION_NAME);
+
+    Trace::Session traceSession;
+    QStringList positional;
+    QStringList statsVars;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        if (args[i] == "--dssat" && i + 1 < args.size()) {
+            // Same override the GUI honours (DataProcessor::getDSSATBase)
+            qputenv("DSSAT_PATH", args[++i].toLocal8Bit());
+        } else if (args[i] == "--stats" && i + 1 < args.size()) {
+            statsVars = args[++i].split(',', Qt::SkipEmptyParts);
+        } else if (args[i] == "--trace" && i + 1 < args.size()) {
+            Trace::start(args[++i]);
+        } else if (args[i] == "--help" || args[i] == "-h") {
+            return usage();
+        } else {
+            positional.append(args[i]);
+        }
+    }
+    if (positional.size() < 2) return usage();
+    Trace::startFromEnvironment();
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    DataProcessor processor;
+    QString folderPath = positional[0];
+    if (!QDir(folderPath).exists())
+        folderPath = processor.getActualFolderPath(positional[0]);
+    if (folderPath.isEmpty() || !QDir(folderPath).exists()) {
+        err << "gb2-cli: crop folder not found: " << positional[0] << "\n";
+        return 1;
+    }
+    const QDir folder(folderPath);
+
+    QVector<QPair<QString, QString>> files;
+    for (const QString &name : positional.mid(1)) {
+        const QString path = QDir::cleanPath(folder.absoluteFilePath(name));
+        files.append(qMakePair(QFileInfo(path).fileName(), path));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    OutputFileSet loaded;
+    processor.loadOutputFiles(folder.dirName(), files, loaded);
+    const qint64 loadMs = timer.elapsed();
+
+    if (loaded.loadedPaths.isEmpty()) {
+        err << "gb2-cli: no file could be read\n";
+        return 1;
+    }
+
+    QStringList experiments = loaded.experimentCodes.values();
+    experiments.sort();
+    out << QString("loaded %1 of %2 files in %3 ms\n").arg(loaded.loadedPaths.size())
+               .arg(files.size()).arg(loadMs);
+    out << QString("simulated: %1 rows, %2 columns\n").arg(loaded.simData.rowCount)
+               .arg(loaded.simData.columnNames.size());
+    out << QString("observed:  %1 rows, %2 columns\n").arg(loaded.obsData.rowCount)
+               .arg(loaded.obsData.columnNames.size());
+    if (loaded.evaluateData.rowCount > 0)
+        out << QString("evaluate:  %1 rows, %2 columns\n").arg(loaded.evaluateData.rowCount)
+                   .arg(loaded.evaluateData.columnNames.size());
+    out << "experiments: " << experiments.join(", ") << "\n";
+
+    if (!statsVars.isEmpty()) {
+        out << "stats:\n";
+        printStats(out, "sim", loaded.simData, statsVars);
+        printStats(out, "obs", loaded.obsData, statsVars);
+    }
+    return 0;
+}
@@ -19,6 +19,9 @@
 #include "MainWindow.h"
 #include "Config.h"
 #include "CommandLineHandler.h"
+#include "BatchRunner.h"
+#include "RequestServer.h"
+#include "Trace.h"
 #include "SingleInstanceApp.h"
 
 // Enable/disable debug output
@@ -259,6 +262,22 @@ int main(int argc, char *argv[])
     for (int i = 0; i < argc; ++i) {
         args << QString::fromLocal8Bit(argv[i]);
     }
+
+    // --startup-trace prints a per-phase breakdown once the window has painted
+    if (args.removeAll("--startup-trace") > 0)
+        Trace::startSummary();
+
+    // --trace <file> (or GB2_TRACE=<file>) records load/plot/export timings as
+    // Chrome trace-event JSON, written when the process exits
+    const int traceIndex = args.indexOf("--trace");
+    if (traceIndex > 0 && traceIndex + 1 < args.size()) {
+        Trace::start(args[traceIndex + 1]);
+        args.remove(traceIndex, 2);
+    }
+    Trace::startFromEnvironment();
+    // No QCoreApplication exists yet, so the buffer would otherwise be named "worker 1"
+    if (Trace::isEnabled())
+        Trace::setThreadName("main");
     
     // Check for --verbose or --debug flags
     g_verboseMode = args.contains("--verbose", Qt::CaseInsensitive) || 
@@ -353,7 +372,10 @@ int main(int argc, char *argv[])
 #endif
 
     // Create single instance application with modified args
+    Trace::mark("pre-app setup");
     SingleInstanceApp app(newArgc, newArgv);
+    Trace::Session traceSession;
+    Trace::mark("QApplication");
     
     // Set application properties
     QCoreApplication::setApplicationName(Config::APP_NAME);
@@ -375,6 +397,31 @@ int main(int argc, char *argv[])
     }
 #endif
     
+    // Batch and server modes run without a main window and may run alongside the GUI
+    // instance: they skip the single-instance check and release the lock the constructor
+    // took, so a resident server does not keep the GUI from starting
+    const CommandLineArgs cliArgs = CommandLineHandler::parseCommandLineArgs(app.arguments());
+    if (!cliArgs.batchManifest.isEmpty() || cliArgs.serveMode)
+        app.cleanupLock();
+    if (!cliArgs.batchManifest.isEmpty()) {
+        setupApplicationStyle(app);
+        BatchRunner runner;
+        return runner.run(cliArgs.batchManifest) ? 0 : 1;
+    }
+    if (cliArgs.serveMode) {
+        setupApplicationStyle(app);
+        app.setQuitOnLastWindowClosed(false);
+        RequestServer server;
+        const QString name = cliArgs.serveName.isEmpty() ? QString(RequestServer::DEFAULT_NAME)
+                                                         : cliArgs.serveName;
+        if (!server.listen(name)) {
+            fprintf(stderr, "%s: cannot listen on %s: %s\n", qPrintable(Config::APP_NAME),
+                    qPrintable(name), qPrintable(server.errorString()));
+            return 1;
+        }
+        return app.exec();
+    }
+
     // Check if another instance is already running (always enforced).
     if (!app.isFirstInstance()) {
 #ifdef ENABLE_DEBUG_OUTPUT
@@ -388,6 +435,7 @@ int main(int argc, char *argv[])
         // Setup application appearance
         setupApplicationIcon(app);
         setupApplicationStyle(app);
+        Trace::mark("icon + style");
         
         // Create main window
         MainWindow window;
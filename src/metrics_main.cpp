@@ -0,0 +1,169 @@
+// gb2-metrics: time-series RMSE/d-stat for calibration scripts, without GB2's window.
+//
+//   gb2-metrics [--dssat <base>] [--vars VAR1,VAR2] [--treatments 1,2]
+//               [--resamples N | --no-ci] [--format csv|json] [-o <out>]
+//               [--trace <trace.json>] <cropDir> <file> [file ...]
+//
+// Loads the output files and their observed data exactly as the file list does, pairs
+// observed with simulated values the way the time-series metrics table does
+// (DataProcessor::matchObsSim) and writes the rows as the --metrics CSV or as JSON.
+// Bootstrap CIs use 2000 resamples per group unless --resamples says otherwise; they
+// dominate the run time on large outputs, so --no-ci (= --resamples 0) leaves them out.
+// Runs under QCoreApplication; nothing is plotted.
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QTextStream>
+#include <cstdio>
+#include "DataProcessor.h"
+#include "MetricsCalculator.h"
+#include "Config.h"
+#include "Trace.h"
+
+namespace {
+
+bool writeMetricsJson(const QString &filePath, const QVector<QVariantMap> &metrics)
+{
+    QJsonArray rows;
+    for (const QVariantMap &row : metrics)
+        rows.append(QJsonObject::fromVariantMap(row));
+    const QByteArray json = QJsonDocument(rows).toJson(QJsonDocument::Indented);
+
+    if (filePath.isEmpty() || filePath == "-") {
+        QTextStream(stdout) << json;
+        return true;
+    }
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    return file.write(json) == json.size();
+}
+
+int usage()
+{
+    QTextStream err(stderr);
+    err << "usage: gb2-metrics [--dssat <base>] [--vars VAR1,VAR2] [--treatments 1,2]\n"
+           "                   [--resamples N | --no-ci] [--format csv|json] [-o <out>]\n"
+           "                   [--trace <trace.json>] <cropDir> <file> [file ...]\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(Config::APP_NAME);
+    QCoreApplication::setApplicationVersion(Config::APP_VERSION);
+    QCoreApplication::setOrganizationName(Config::ORGANIZATION_NAME);
+
+    Trace::Session traceSession;
+    QStringList positional;
+    QStringList variables;
+    QSet<QString> treatments;
+    QString format;
+    QString outputPath;
+    int resamples = MetricsCalculator::DEFAULT_BOOTSTRAP_RESAMPLES;
+    const QStringList args = app.arguments().mid(1);
+    for (int i = 0; i < args.size(); ++i) {
+        const QString &arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+        if (arg == "--dssat" && hasValue) {
+            qputenv("DSSAT_PATH", args[++i].toLocal8Bit());
+        } else if (arg == "--vars" && hasValue) {
+            variables = args[++i].split(',', Qt::SkipEmptyParts);
+        } else if (arg == "--treatments" && hasValue) {
+            const QStringList list = args[++i].split(',', Qt::SkipEmptyParts);
+            treatments = QSet<QString>(list.begin(), list.end());
+        } else if (arg == "--resamples" && hasValue) {
+            bool ok = false;
+            resamples = args[++i].toInt(&ok);
+            if (!ok || resamples < 0) return usage();
+        } else if (arg == "--no-ci") {
+            resamples = 0;
+        } else if (arg == "--format" && hasValue) {
+            format = args[++i].toLower();
+        } else if ((arg == "-o" || arg == "--output") && hasValue) {
+            outputPath = args[++i];
+        } else if (arg == "--trace" && hasValue) {
+            Trace::start(args[++i]);
+        } else if (arg == "--help" || arg == "-h") {
+            return usage();
+        } else {
+            positional.append(arg);
+        }
+    }
+    if (positional.size() < 2) return usage();
+    if (format.isEmpty())
+        format = (outputPath.isEmpty() || outputPath.endsWith(".json", Qt::CaseInsensitive)) ? "json" : "csv";
+    if (format != "csv" && format != "json") return usage();
+    if (format == "csv" && outputPath.isEmpty()) {
+        fprintf(stderr, "gb2-metrics: CSV output needs -o <file>\n");
+        return 2;
+    }
+
+    Trace::startFromEnvironment();
+    QElapsedTimer timer;
+    timer.start();
+
+    DataProcessor processor;
+    QString folderPath = positional[0];
+    if (!QDir(folderPath).exists())
+        folderPath = processor.getActualFolderPath(positional[0]);
+    if (folderPath.isEmpty() || !QDir(folderPath).exists()) {
+        fprintf(stderr, "gb2-metrics: crop folder not found: %s\n", qPrintable(positional[0]));
+        return 1;
+    }
+    const QDir folder(folderPath);
+
+    QVector<QPair<QString, QString>> files;
+    for (const QString &name : positional.mid(1)) {
+        const QString path = QDir::cleanPath(folder.absoluteFilePath(name));
+        files.append(qMakePair(QFileInfo(path).fileName(), path));
+    }
+
+    OutputFileSet loaded;
+    processor.loadOutputFiles(folder.dirName(), files, loaded);
+    if (loaded.simData.rowCount == 0) {
+        fprintf(stderr, "gb2-metrics: no simulated data read\n");
+        return 1;
+    }
+    if (loaded.obsData.rowCount == 0) {
+        fprintf(stderr, "gb2-metrics: no observed data found for %s\n",
+                qPrintable(QStringList(loaded.experimentCodes.values()).join(", ")));
+        return 1;
+    }
+
+    // Default: every variable both tables carry
+    if (variables.isEmpty())
+        variables = MetricsCalculator::commonVariables(loaded.simData, loaded.obsData);
+
+    GB2_TRACE_SCOPE("metrics");
+    const QVector<QVariantMap> metrics = MetricsCalculator::obsSimMetrics(
+        loaded.simData, loaded.obsData, loaded.treatmentNames, variables, treatments, resamples);
+
+    bool ok;
+    if (format == "csv") {
+        QVariantList rows;
+        rows.reserve(metrics.size());
+        for (const QVariantMap &row : metrics)
+            rows.append(row);
+        ok = MetricsCalculator::writeMetricsCsv(outputPath, rows);
+    } else {
+        ok = writeMetricsJson(outputPath, metrics);
+    }
+    if (!ok) {
+        fprintf(stderr, "gb2-metrics: cannot write %s\n", qPrintable(outputPath));
+        return 1;
+    }
+
+    fprintf(stderr, "gb2-metrics: %lld rows for %lld variables in %lld ms\n",
+            static_cast<long long>(metrics.size()), static_cast<long long>(variables.size()),
+            static_cast<long long>(timer.elapsed()));
+    return metrics.isEmpty() ? 1 : 0;
+}